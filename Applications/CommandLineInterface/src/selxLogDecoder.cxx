@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxBinaryLogSink.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+
+// Renders a binary log written with SuperElastix --binarylog as text or JSON lines
+int
+main( int ac, char * av[] )
+{
+  boost::filesystem::path inputPath;
+  boost::filesystem::path outputPath;
+  bool                    json = false;
+
+  boost::program_options::variables_map vm;
+  try
+  {
+    boost::program_options::options_description desc( "Allowed options" );
+    desc.add_options()
+      ( "help", "produce help message" )
+      ( "in", boost::program_options::value< boost::filesystem::path >( &inputPath )->required(), "Binary log file" )
+      ( "out", boost::program_options::value< boost::filesystem::path >( &outputPath ), "Output file (default: standard output)" )
+      ( "json", boost::program_options::bool_switch( &json ), "Write one JSON object per record, with the format string and arguments, instead of text" )
+      ;
+
+    boost::program_options::positional_options_description positional;
+    positional.add( "in", 1 );
+    boost::program_options::store( boost::program_options::command_line_parser( ac, av ).options( desc ).positional( positional ).run(), vm );
+
+    if( vm.count( "help" ) )
+    {
+      std::cout << desc << "\n";
+      return 0;
+    }
+    boost::program_options::notify( vm );
+  }
+  catch( std::exception & e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    std::cerr << "See 'SuperElastixLogDecoder --help' for help" << "\n";
+    return 1;
+  }
+
+  try
+  {
+    std::ifstream in( inputPath.string(), std::ios::binary );
+    if( !in )
+    {
+      std::cerr << "Error: could not open '" << inputPath.string() << "'\n";
+      return 1;
+    }
+
+    if( vm.count( "out" ) )
+    {
+      std::ofstream out( outputPath.string() );
+      selx::DecodeBinaryLog( in, out, json );
+    }
+    else
+    {
+      selx::DecodeBinaryLog( in, std::cout, json );
+    }
+  }
+  catch( std::exception & e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
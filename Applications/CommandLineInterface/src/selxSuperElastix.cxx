@@ -18,19 +18,27 @@
  *=========================================================================*/
 
 #include "selxSuperElastixFilter.h"
+#include "selxSuperElastixBatch.h"
 #include "selxAnyFileReader.h"
 #include "selxAnyFileWriter.h"
 #include "selxLogger.h"
+#include "selxProfiler.h"
+#include "selxProgressMonitor.h"
+#include "selxCompiledNetwork.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
 #include <iostream>
+#include <iomanip>
 #include <algorithm>
+#include <sstream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <stdexcept>
+#include <thread>
 
 template< class T >
 std::ostream &
@@ -77,15 +85,38 @@ main( int ac, char * av[] )
   typedef std::vector< boost::filesystem::path > VectorOfPathsType;
 
   boost::filesystem::path logPath;
+  boost::filesystem::path binaryLogPath;
   // default log level
   selx::LogLevel logLevel = selx::LogLevel::WRN;
 
   boost::filesystem::path            configurationPath;
   VectorOfPathsType                   configurationPaths;
 
+  boost::filesystem::path compiledNetworkPath;
+
   VectorOfStringsType inputPairs;
   VectorOfStringsType outputPairs;
 
+  // default serial execution of the components
+  unsigned int numberOfExecutionThreads = 1;
+
+  boost::filesystem::path batchManifestPath;
+  // default one item of the batch at a time
+  unsigned int numberOfBatchWorkers = 1;
+
+  // default all cores, shared by the components that execute concurrently
+  unsigned int threadBudget = std::thread::hardware_concurrency();
+
+  // by default intermediate data is freed as soon as it is no longer used
+  bool keepIntermediateData = false;
+
+  boost::filesystem::path profilePath;
+
+  std::string progressPath;
+
+  // default no time limit
+  double timeout = 0.0;
+
   boost::program_options::variables_map vm;
 
   try
@@ -93,12 +124,22 @@ main( int ac, char * av[] )
     boost::program_options::options_description desc("Allowed options");
     desc.add_options()
       ( "help", "produce help message" )
-      ("conf", boost::program_options::value< VectorOfPathsType >(&configurationPaths)->required()->multitoken(), "Configuration file: single or multiple Blueprints [.xml|.json]")
+      ("conf", boost::program_options::value< VectorOfPathsType >(&configurationPaths)->required()->multitoken(), "Configuration file: single or multiple Blueprints [.xml|.json], or a single compiled network [.selxnet]. Parameter sweeps, e.g. \"NumberOfIterations\": {\"sweep\": [\"100\", \"200\"]}, run all variants and label the --out files per variant")
       ("in", boost::program_options::value< VectorOfStringsType >(&inputPairs)->multitoken(), "Input data: images, labels, meshes, etc. Usage arg: <name>=<path> (or multiple pairs)")
       ("out", boost::program_options::value< VectorOfStringsType >(&outputPairs)->multitoken(), "Output data: images, labels, meshes, etc. Usage arg: <name>=<path> (or multiple pairs)")
+      ("compile-blueprint", boost::program_options::value< boost::filesystem::path >(&compiledNetworkPath), "Output compiled network file [.selxnet]: the blueprint with its selected components, which --conf loads without selecting them again. Does not execute the blueprint")
       ("graphout", boost::program_options::value< boost::filesystem::path >(), "Output Graphviz dot file")
       ("logfile", boost::program_options::value< boost::filesystem::path >(&logPath), "Log output file")
       ("loglevel", boost::program_options::value< selx::LogLevel >(&logLevel), "Log level [off|critical|error|warning|info|debug|trace]")
+      ("binarylog", boost::program_options::value< boost::filesystem::path >(&binaryLogPath), "Binary log output file, written in the background with little overhead at high log levels. Convert to text or JSON with SuperElastixLogDecoder")
+      ("executionthreads", boost::program_options::value< unsigned int >(&numberOfExecutionThreads), "Maximum number of components that execute concurrently (default 1: serial, or the number of variants of a parameter sweep)")
+      ("batch", boost::program_options::value< boost::filesystem::path >(&batchManifestPath), "Batch manifest file [.csv]: a header of in:<name> and out:<name> columns and a line of paths per execution. Replaces --in and --out")
+      ("threadbudget", boost::program_options::value< unsigned int >(&threadBudget), "Total number of threads of the components that execute concurrently, including those of concurrent batch items (default: number of cores; 0: each component uses the default of its toolkit)")
+      ("batchworkers", boost::program_options::value< unsigned int >(&numberOfBatchWorkers), "Number of batch items that execute concurrently, each with --executionthreads threads (default 1)")
+      ("keepintermediatedata", boost::program_options::bool_switch(&keepIntermediateData), "Keep the intermediate data of all components until the end, for debugging")
+      ("progress", boost::program_options::value< std::string >(&progressPath), "Output file with the progress and convergence of the components as JSON lines, or - for standard output")
+      ("timeout", boost::program_options::value< double >(&timeout), "Maximum wall time of the execution in seconds, after which it is cancelled (per item with --batch). Default 0: no limit")
+      ("profile", boost::program_options::value< boost::filesystem::path >(&profilePath), "Output Chrome trace file [.json] with the wall time, CPU time and peak memory growth of each phase and component. Prints a summary and adds the runtimes to --graphout")
       ;
 
     boost::program_options::store(boost::program_options::parse_command_line(ac, av, desc), vm);
@@ -132,27 +173,196 @@ main( int ac, char * av[] )
       logger->AddStream("logfile", outfile);
     }
 
+    if( vm.count( "binarylog" ) )
+    {
+      logger->AddBinaryFile( "binarylog", binaryLogPath.string() );
+    }
+
     logger->AddStream("cout", std::cout);
     logger->SetLogLevel(logLevel);
    
-    // instantiate a SuperElastixFilter that is loaded with default components
-    selx::SuperElastixFilter::Pointer superElastixFilter = selx::SuperElastixFilter::New();
-
-    superElastixFilter->SetLogger(logger);
-
     // create empty blueprint
     selx::Blueprint::Pointer blueprint = selx::Blueprint::New();
     blueprint->SetLogger(logger);
+    // A compiled network holds the blueprint itself, together with the components that were selected for it
+    std::shared_ptr< const selx::CompiledNetwork > compiledNetwork;
     for (const auto & configurationPath : configurationPaths)
     {
-      blueprint->MergeFromFile(configurationPath.string());
+      if( selx::CompiledNetwork::IsCompiledNetworkFile( configurationPath.string() ) )
+      {
+        if( configurationPaths.size() > 1 )
+        {
+          throw std::runtime_error( "A compiled network cannot be merged with other configuration files: " + configurationPath.string() );
+        }
+        compiledNetwork = selx::CompiledNetwork::Read( configurationPath.string(), *blueprint );
+      }
+      else
+      {
+        blueprint->MergeFromFile(configurationPath.string());
+      }
+    }
+
+    // A parameter sweep is expanded into one network with a copy of the components that depend on the swept parameters per
+    // variant. The variants share the other components, e.g. the sources, and are executed concurrently.
+    selx::Blueprint::SweepVariantsType sweepVariants;
+    if( blueprint->HasSweeps() )
+    {
+      blueprint = blueprint->ExpandSweeps( sweepVariants );
+      for( const auto & variant : sweepVariants )
+      {
+        logger->Log( selx::LogLevel::INF, "Parameter sweep variant: " + variant.label );
+      }
+      if( !vm.count( "executionthreads" ) )
+      {
+        numberOfExecutionThreads = std::max( 1u, std::min( static_cast< unsigned int >( sweepVariants.size() ), std::thread::hardware_concurrency() ) );
+      }
     }
 
+    // The names and paths of an input or output of the blueprint, with a name and path per variant for components that are copied per
+    // variant. Outputs get the variant label in their file name, e.g. result_NumberOfIterations-200.mhd; inputs are shared.
+    auto expandDataPair = [ &sweepVariants ]( const std::string & name, const std::string & path, bool labelPath ){
+        std::vector< std::pair< std::string, std::string > > namesAndPaths;
+        for( const auto & variant : sweepVariants )
+        {
+          auto copy = variant.componentNames.find( name );
+          if( copy == variant.componentNames.end() )
+          {
+            break;
+          }
+          std::string variantPath = path;
+          if( labelPath )
+          {
+            const std::size_t fileNameStart = path.find_last_of( "/\\" ) == std::string::npos ? 0 : path.find_last_of( "/\\" ) + 1;
+            const std::size_t extension     = std::min( path.find( '.', fileNameStart ), path.size() );
+            variantPath = path.substr( 0, extension ) + "_" + variant.label + path.substr( extension );
+          }
+          namesAndPaths.emplace_back( copy->second, variantPath );
+        }
+        if( namesAndPaths.empty() )
+        {
+          namesAndPaths.emplace_back( name, path );
+        }
+        return namesAndPaths;
+      };
+
     if( vm.count( "graphout" ) )
     {
       blueprint->Write(vm["graphout"].as< boost::filesystem::path >().string());
     }
 
+    if( vm.count( "compile-blueprint" ) )
+    {
+      selx::SuperElastixFilter::Pointer compilingFilter = selx::SuperElastixFilter::New();
+      compilingFilter->SetLogger(logger);
+      compilingFilter->SetBlueprint(blueprint);
+      compilingFilter->SetCompiledNetwork(compiledNetwork);
+      compilingFilter->CompileBlueprint(compiledNetworkPath.string());
+      return 0;
+    }
+
+    // The profiler records all filters, also those of the batch workers
+    std::unique_ptr< selx::Profiler > profiler;
+    if( vm.count( "profile" ) )
+    {
+      profiler.reset( new selx::Profiler );
+    }
+
+    // The progress events of all filters are written as they come in, by the dispatch thread of the monitor
+    std::ofstream                           progressFile;
+    std::ostream *                          progressStream = &std::cout;
+    std::unique_ptr< selx::ProgressMonitor > progressMonitor;
+    if( vm.count( "progress" ) )
+    {
+      if( progressPath != "-" )
+      {
+        progressFile.open( progressPath );
+        progressStream = &progressFile;
+      }
+      progressMonitor.reset( new selx::ProgressMonitor );
+      progressMonitor->SetKeepTimeSeries( false );
+      progressMonitor->SetCallback( [ progressStream ]( const selx::ProgressEvent & event ){
+          selx::ProgressMonitor::WriteJsonLine( *progressStream, event );
+          progressStream->flush();
+        } );
+      progressMonitor->Start();
+    }
+
+    // Flush the remaining progress events, write the trace and summary, and add the total runtime of each component to the graph
+    auto writeProfile = [ & ](){
+        if( progressMonitor )
+        {
+          progressMonitor->Stop();
+        }
+        if( !profiler )
+        {
+          return;
+        }
+        std::ofstream traceFile( profilePath.string() );
+        profiler->WriteChromeTrace( traceFile );
+        profiler->WriteSummary( std::cout );
+
+        if( vm.count( "graphout" ) )
+        {
+          selx::Blueprint::ComponentAnnotationsType runtimes;
+          for( const auto & nameAndWallTime : profiler->GetTotalWallTimes( "component" ) )
+          {
+            std::ostringstream runtime;
+            runtime << "runtime : " << std::fixed << std::setprecision( 3 ) << nameAndWallTime.second << " s";
+            runtimes[ nameAndWallTime.first ] = runtime.str();
+          }
+          blueprint->Write( vm[ "graphout" ].as< boost::filesystem::path >().string(), runtimes );
+        }
+      };
+
+    if( vm.count( "batch" ) )
+    {
+      // Each worker configures one network with default components and executes it for all of its items.
+      selx::Profiler *        batchProfiler        = profiler.get();
+      selx::ProgressMonitor * batchProgressMonitor = progressMonitor.get();
+      selx::SuperElastixBatch batch( [ keepIntermediateData, batchProfiler, batchProgressMonitor, compiledNetwork ](){
+          selx::SuperElastixFilterBase::Pointer filter = selx::SuperElastixFilter::New().GetPointer();
+          filter->SetCompiledNetwork( compiledNetwork );
+          filter->SetReleaseIntermediateData( !keepIntermediateData );
+          filter->SetProfiler( batchProfiler );
+          filter->SetProgressMonitor( batchProgressMonitor );
+          return filter;
+        }, blueprint, logger );
+      batch.SetNumberOfWorkers( numberOfBatchWorkers );
+      batch.SetNumberOfThreadsPerItem( numberOfExecutionThreads );
+      batch.SetThreadBudget( threadBudget );
+      batch.SetItemTimeout( timeout );
+
+      auto errors = batch.Execute( selx::SuperElastixBatch::ReadManifest( batchManifestPath.string() ) );
+      bool failed = false;
+      for( std::size_t itemIndex = 0; itemIndex < errors.size(); ++itemIndex )
+      {
+        if( !errors[ itemIndex ].empty() )
+        {
+          std::cerr << "Batch item " << itemIndex << ": " << errors[ itemIndex ] << "\n";
+          failed = true;
+        }
+      }
+      writeProfile();
+      return failed ? 1 : 0;
+    }
+
+    // instantiate a SuperElastixFilter that is loaded with default components
+    selx::SuperElastixFilter::Pointer superElastixFilter = selx::SuperElastixFilter::New();
+
+    superElastixFilter->SetLogger(logger);
+    superElastixFilter->SetNumberOfExecutionThreads(numberOfExecutionThreads);
+    superElastixFilter->SetThreadBudget(threadBudget);
+    superElastixFilter->SetReleaseIntermediateData(!keepIntermediateData);
+    superElastixFilter->SetProfiler(profiler.get());
+    superElastixFilter->SetProgressMonitor(progressMonitor.get());
+    superElastixFilter->SetCompiledNetwork(compiledNetwork);
+    if( timeout > 0.0 )
+    {
+      selx::CancellationToken::Pointer cancellationToken = std::make_shared< selx::CancellationToken >();
+      cancellationToken->SetTimeout( timeout );
+      superElastixFilter->SetCancellationToken( cancellationToken );
+    }
+
     // The Blueprint needs to be set to superElastixFilter before GetInputFileReader and GetOutputFileWriter should be called.
     superElastixFilter->SetBlueprint(blueprint);
 
@@ -168,17 +378,20 @@ main( int ac, char * av[] )
       {
         VectorOfStringsType nameAndPath;
         boost::split( nameAndPath, inputPair, boost::is_any_of( "=" ) );  // NameAndPath == { "name","path" }
-        const std::string & name = nameAndPath[ 0 ];
-        const std::string & path = nameAndPath[ 1 ];
-
-        // since we do not know which reader type we should instantiate for input "name",
-        // we ask SuperElastix for a reader that matches the type of the source component "name"
-        logger->Log( selx::LogLevel::INF, "Preparing input '" + name + "': " + path + " ..." );
-        selx::AnyFileReader::Pointer reader = superElastixFilter->GetInputFileReader( name );
-        reader->SetFileName( path );
-        superElastixFilter->SetInput( name, reader->GetOutput() );
-        fileReaders.push_back( reader );
-        logger->Log( selx::LogLevel::INF, "Preparing input '" + name + "': " + path + " ... Done" );
+        for( const auto & namePath : expandDataPair( nameAndPath[ 0 ], nameAndPath[ 1 ], false ) )
+        {
+          const std::string & name = namePath.first;
+          const std::string & path = namePath.second;
+
+          // since we do not know which reader type we should instantiate for input "name",
+          // we ask SuperElastix for a reader that matches the type of the source component "name"
+          logger->Log( selx::LogLevel::INF, "Preparing input '" + name + "': " + path + " ..." );
+          selx::AnyFileReader::Pointer reader = superElastixFilter->GetInputFileReader( name );
+          reader->SetFileName( path );
+          superElastixFilter->SetInput( name, reader->GetOutput() );
+          fileReaders.push_back( reader );
+          logger->Log( selx::LogLevel::INF, "Preparing input '" + name + "': " + path + " ... Done" );
+        }
       }
       logger->Log( selx::LogLevel::INF, "Preparing input data ... Done");
     }
@@ -194,17 +407,20 @@ main( int ac, char * av[] )
       {
         VectorOfStringsType nameAndPath;
         boost::split( nameAndPath, outputPair, boost::is_any_of( "=" ) );  // NameAndPath == { "name","path" }
-        const std::string & name = nameAndPath[ 0 ];
-        const std::string & path = nameAndPath[ 1 ];
-
-        // since we do not know which writer type we should instantiate for output "name",
-        // we ask SuperElastix for a writer that matches the type of the sink component "name"
-        logger->Log( selx::LogLevel::INF, "Preparing output '" + name + "': " + path + " ..." );
-        selx::AnyFileWriter::Pointer writer = superElastixFilter->GetOutputFileWriter( name );
-        writer->SetFileName( path );
-        writer->SetInput( superElastixFilter->GetOutput( name ) );
-        fileWriters.push_back( writer );
-        logger->Log( selx::LogLevel::INF, "Preparing output '" + name + "': " + path + " ... Done" );
+        for( const auto & namePath : expandDataPair( nameAndPath[ 0 ], nameAndPath[ 1 ], true ) )
+        {
+          const std::string & name = namePath.first;
+          const std::string & path = namePath.second;
+
+          // since we do not know which writer type we should instantiate for output "name",
+          // we ask SuperElastix for a writer that matches the type of the sink component "name"
+          logger->Log( selx::LogLevel::INF, "Preparing output '" + name + "': " + path + " ..." );
+          selx::AnyFileWriter::Pointer writer = superElastixFilter->GetOutputFileWriter( name );
+          writer->SetFileName( path );
+          writer->SetInput( superElastixFilter->GetOutput( name ) );
+          fileWriters.push_back( writer );
+          logger->Log( selx::LogLevel::INF, "Preparing output '" + name + "': " + path + " ... Done" );
+        }
       }
     }
     else
@@ -219,6 +435,8 @@ main( int ac, char * av[] )
       writer->Update();
     }
     logger->Log(selx:: LogLevel::INF, "Executing ... Done");
+
+    writeProfile();
   }
   catch( std::exception & e )
   {
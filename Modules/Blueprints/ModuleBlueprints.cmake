@@ -27,6 +27,8 @@ set( ${MODULE}_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/src/selxBlueprint.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxBlueprintImpl.h
   ${${MODULE}_SOURCE_DIR}/src/selxBlueprintImpl.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxBlueprintReader.h
+  ${${MODULE}_SOURCE_DIR}/src/selxBlueprintReader.cxx
 )
 
 # Export tests
@@ -40,5 +42,6 @@ set( ${MODULE}_LIBRARIES
 )
 
 set( ${MODULE}_MODULE_DEPENDENCIES
+  ModuleCommon
   ModuleLogger
 )
@@ -57,6 +57,16 @@ public:
   typedef std::vector< ComponentNameType >                 ComponentNamesType;
   typedef std::string                                      ConnectionNameType;
   typedef std::vector< ConnectionNameType >                ConnectionNamesType;
+  typedef std::map< ComponentNameType, std::string >       ComponentAnnotationsType;
+
+  /** A variant of a parameter sweep: a label of its parameter values, e.g. "NumberOfIterations-200", and the name of the copy
+   * of each component that depends on the swept parameters, e.g. "ResultImage" -> "ResultImage_NumberOfIterations-200" */
+  struct SweepVariant
+  {
+    std::string                                      label;
+    std::map< ComponentNameType, ComponentNameType > componentNames;
+  };
+  typedef std::vector< SweepVariant > SweepVariantsType;
 
   /* m_Blueprint is initialized in the default constructor */
   Blueprint();
@@ -97,8 +107,17 @@ public:
   // Returns a vector of the Component names at the outgoing direction
   ComponentNamesType GetOutputNames( const ComponentNameType name ) const;
 
-  // Write graphviz dot file
-  void Write( const std::string filename );
+  // Does any component declare a parameter sweep by a "Sweep" property that lists its swept parameters, e.g.
+  // { "NumberOfIterations", { "100", "200", "400" } }, { "Sweep", { "NumberOfIterations" } }
+  bool HasSweeps( void ) const;
+
+  // Expand the parameter sweeps into one blueprint with a copy of the components downstream of the swept parameters for each
+  // combination of their values, such that all variants share the unaffected components upstream and can execute concurrently.
+  // The variants are returned in order, without sweeps a single variant without copies is returned.
+  Pointer ExpandSweeps( SweepVariantsType & variants ) const;
+
+  // Write graphviz dot file, optionally with an extra line of text in the label of Components, e.g. their runtime
+  void Write( const std::string filename, const ComponentAnnotationsType & annotations = ComponentAnnotationsType() );
 
   // Read json or XML file
   //void FromFile(const std::string& filename);
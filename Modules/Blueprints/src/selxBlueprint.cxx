@@ -149,11 +149,30 @@ Blueprint
 }
 
 
+bool
+Blueprint
+::HasSweeps( void ) const
+{
+  return this->m_BlueprintImpl->HasSweeps();
+}
+
+
+Blueprint::Pointer
+Blueprint
+::ExpandSweeps( SweepVariantsType & variants ) const
+{
+  Pointer expanded = Blueprint::New();
+  expanded->SetLogger( this->m_Logger );
+  variants = this->m_BlueprintImpl->ExpandSweeps( *expanded->m_BlueprintImpl );
+  return expanded;
+}
+
+
 void
 Blueprint
-::Write( const std::string filename )
+::Write( const std::string filename, const ComponentAnnotationsType & annotations )
 {
-  this->m_BlueprintImpl->Write( filename );
+  this->m_BlueprintImpl->Write( filename, annotations );
 }
 
 void
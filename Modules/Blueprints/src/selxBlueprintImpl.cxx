@@ -19,8 +19,13 @@
 
 #include "selxBlueprintImpl.h"
 #include "selxLoggerImpl.h"
+#include "selxKeys.h"
 #include <ostream>
 
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 
 namespace selx
@@ -47,11 +52,18 @@ class vertex_label_writer
 {
 public:
 
-  vertex_label_writer( NameType _name, ParameterMapType _parameterMap ) : name( _name ), parameterMap( _parameterMap ) {}
+  vertex_label_writer( NameType _name, ParameterMapType _parameterMap, const BlueprintImpl::ComponentAnnotationsType & _annotations ) :
+    name( _name ), parameterMap( _parameterMap ), annotations( _annotations ) {}
   template< class VertexOrEdge >
   void operator()( std::ostream & out, const VertexOrEdge & v ) const
   {
-    out << "[label=\"" << name[ v ] << "\n" << parameterMap[ v ] << "\"]";
+    out << "[label=\"" << name[ v ] << "\n" << parameterMap[ v ];
+    auto annotation = annotations.find( name[ v ] );
+    if( annotation != annotations.end() )
+    {
+      out << annotation->second << "\\n";
+    }
+    out << "\"]";
   }
 
 
@@ -59,13 +71,14 @@ private:
 
   NameType         name;
   ParameterMapType parameterMap;
+  const BlueprintImpl::ComponentAnnotationsType & annotations;
 };
 
 template< class NameType, class ParameterMapType >
 inline vertex_label_writer< NameType, ParameterMapType >
-make_vertex_label_writer( NameType n, ParameterMapType p )
+make_vertex_label_writer( NameType n, ParameterMapType p, const BlueprintImpl::ComponentAnnotationsType & a )
 {
-  return vertex_label_writer< NameType, ParameterMapType >( n, p );
+  return vertex_label_writer< NameType, ParameterMapType >( n, p, a );
 }
 
 
@@ -120,15 +133,7 @@ BlueprintImpl::ParameterMapType
 BlueprintImpl
 ::GetComponent( ComponentNameType name ) const
 {
-  if( !this->ComponentExists( name ) )
-  {
-    std::stringstream msg;
-    msg << "BlueprintImpl does not contain component " << name << std::endl;
-    this->m_LoggerImpl->Log(LogLevel::CRT, msg.str());
-    throw std::runtime_error( msg.str() );
-  }
-
-  return this->m_Graph[ name ].parameterMap;
+  return this->GetComponentParameterMap( this->GetComponentIndex( name ) );
 }
 
 
@@ -151,6 +156,7 @@ BlueprintImpl
 ::GetComponentNames( void ) const
 {
   ComponentNamesType container;
+  container.reserve( this->GetNumberOfComponents() );
   for( auto it = boost::vertices( this->m_Graph.graph() ).first; it != boost::vertices( this->m_Graph.graph() ).second; ++it )
   {
     container.push_back( this->m_Graph.graph()[ *it ].name );
@@ -389,7 +395,6 @@ BlueprintImpl
               auto ownProperties = this->GetConnection( incomingName, componentName, connectionName );
               ownProperties[ othersEntry.first ] = othersEntry.second;
               this->SetConnection( incomingName, componentName, ownProperties, connectionName );
-              return true;
             }
           } // end loop otherProperties
         }
@@ -401,8 +406,7 @@ BlueprintImpl
       }
     }
   }
-
-  
+  return true;
 }
 
 BlueprintImpl::ComponentNamesType
@@ -440,378 +444,423 @@ BlueprintImpl::ComponentNamesType
 BlueprintImpl
 ::GetUpdateOrder() const
 {
-  ComponentNamesType     container;
- 
-  std::vector< ComponentIndexType > indexContainer;
-  
-  boost::topological_sort(this->m_Graph, std::back_inserter(indexContainer));
-
-  for (std::vector< ComponentIndexType >::reverse_iterator ii = indexContainer.rbegin(); ii != indexContainer.rend(); ++ii)
+  ComponentNamesType container;
+  for( const auto index : this->GetUpdateOrderIndices() )
   {
-    container.push_back(boost::get(boost::vertex_all, this->m_Graph, *ii).name);
+    container.push_back( this->GetComponentName( index ) );
   }
   return container;
 }
 
 
-BlueprintImpl::ConnectionNamesType
+BlueprintImpl::ComponentIndicesType
 BlueprintImpl
-::GetConnectionNames(const ComponentNameType upstream, const ComponentNameType downstream) const
+::GetUpdateOrderIndices() const
 {
-  ConnectionNamesType     container;
-
-  boost::graph_traits<GraphType>::out_edge_iterator ei, ei_end;
-  // too bad edge_range_by_label doesn't exist
-  boost::tie(ei, ei_end) = boost::edge_range(this->m_Graph.vertex(upstream), this->m_Graph.vertex(downstream), this->m_Graph.graph());
-
-  for (; ei != ei_end; ++ei)
-  {
-    container.push_back(boost::get(&ConnectionPropertyType::name, this->m_Graph.graph(), *ei));
-  }
-  return container;
+  ComponentIndicesType indexContainer;
+  indexContainer.reserve( this->GetNumberOfComponents() );
+  boost::topological_sort( this->m_Graph.graph(), std::back_inserter( indexContainer ) );
+  std::reverse( indexContainer.begin(), indexContainer.end() );
+  return indexContainer;
 }
 
 
-
-void
+BlueprintImpl::ComponentIndexType
 BlueprintImpl
-::Write( const std::string filename )
-{
-  std::ofstream dotfile( filename.c_str() );
-  boost::write_graphviz( dotfile, this->m_Graph,
-    make_vertex_label_writer( boost::get( &ComponentPropertyType::name, this->m_Graph ),
-    boost::get( &ComponentPropertyType::parameterMap, this->m_Graph ) ),
-    make_edge_label_writer( boost::get( &ConnectionPropertyType::parameterMap, this->m_Graph ) ) );
-}
-
-BlueprintImpl::ParameterValueType
-BlueprintImpl::VectorizeValues(ComponentOrConnectionTreeType & componentOrConnectionTree)
+::GetComponentIndex( const ComponentNameType & name ) const
 {
-  std::string        propertySingleValue = componentOrConnectionTree.data();
-  ParameterValueType propertyMultiValue;
-  for (auto const & value : componentOrConnectionTree)
+  const ComponentIndexType index = this->m_Graph.vertex( name );
+  if( index == boost::graph_traits< GraphType >::null_vertex() )
   {
-    propertyMultiValue.push_back(value.second.data());
+    std::string msg = "BlueprintImpl does not contain component " + name;
+    this->m_LoggerImpl->Log( LogLevel::CRT, msg );
+    throw std::runtime_error( msg );
   }
-  if (propertyMultiValue.size() > 0)
-  {
-    if (propertySingleValue != "")
-    {
-      throw std::invalid_argument("XML tree should have either 1 unnamed element or multiple named properties");
-    }
-  }
-  else
-  {
-    propertyMultiValue.push_back(propertySingleValue);
-  }
-  return propertyMultiValue;
+  return index;
 }
 
-void
-BlueprintImpl::MergeFromFile(const std::string & fileNameString)
-{
-  PathType fileName(fileNameString);
-
-  this->m_LoggerImpl->Log(LogLevel::INF, "Loading {0} ... ", fileName);
-  auto propertyTree = ReadPropertyTree(fileName);
-  this->m_LoggerImpl->Log(LogLevel::INF, "Loading {0} ... Done", fileName);
 
-  this->m_LoggerImpl->Log(LogLevel::INF, "Checking {0} for include files ... ", fileName);
-  auto includesList = FindIncludes(propertyTree);
-
-  if (includesList.size() > 0)
+BlueprintImpl::ComponentIndicesType
+BlueprintImpl
+::GetInputIndices( ComponentIndexType index ) const
+{
+  ComponentIndicesType container;
+  for( auto inputs = boost::in_edges( index, this->m_Graph.graph() ); inputs.first != inputs.second; ++inputs.first )
   {
-    for (auto const & includePath : includesList)
-    {
-      this->m_LoggerImpl->Log(LogLevel::INF, "Including file {0} ... ", includePath);
-      this->MergeFromFile(includePath.string());
-    }
+    container.push_back( boost::source( *inputs.first, this->m_Graph.graph() ) );
   }
-  this->m_LoggerImpl->Log(LogLevel::INF, "Checking {0} for include files ... done", fileName);
-  this->MergeProperties(propertyTree);
-  return;
+  return container;
 }
 
-void
-BlueprintImpl::SetLoggerImpl( LoggerImpl & loggerImpl )
-{
-  this->m_LoggerImpl = &loggerImpl;
-}
 
-BlueprintImpl::PropertyTreeType
-BlueprintImpl::ReadPropertyTree(const PathType & filename)
+BlueprintImpl::ComponentIndicesType
+BlueprintImpl
+::GetOutputIndices( ComponentIndexType index ) const
 {
-  // Create empty property tree object
-  PropertyTreeType propertyTree;
-  if (filename.extension() == ".xml")
-  {
-    read_xml(filename.string(), propertyTree, boost::property_tree::xml_parser::trim_whitespace);
-  }
-  else if (filename.extension() == ".json")
-  {
-    read_json(filename.string(), propertyTree);
-  }
-  else
+  ComponentIndicesType container;
+  for( auto outputs = boost::out_edges( index, this->m_Graph.graph() ); outputs.first != outputs.second; ++outputs.first )
   {
-    throw std::invalid_argument("Configuration file requires extension .xml or .json");
+    container.push_back( boost::target( *outputs.first, this->m_Graph.graph() ) );
   }
-
-  return propertyTree;
+  return container;
 }
 
-BlueprintImpl::PathsType
-BlueprintImpl::FindIncludes(const PropertyTreeType & propertyTree)
+
+bool
+BlueprintImpl
+::HasSweeps() const
 {
-  PathsType paths;
-  bool FoundIncludes = false;
-  BOOST_FOREACH(const PropertyTreeType::value_type & v, propertyTree.equal_range("Include"))
+  for( auto const & componentName : this->GetComponentNames() )
   {
-    if (FoundIncludes)
+    if( this->GetComponent( componentName ).count( keys::Sweep ) > 0 )
     {
-      std::runtime_error("Only 1 listing of Includes is allowed per Blueprint file");
+      return true;
     }
-
-    auto const pathsStrings = VectorizeValues(v.second);
-    // convert vector of strings to list of boost::path-s
-    paths.resize(pathsStrings.size());
-    std::transform(pathsStrings.begin(), pathsStrings.end(), paths.begin(),
-      [](std::string p) { return PathType(p); });
-    FoundIncludes = true;
   }
-  return paths;
+  return false;
 }
 
 
-Blueprint::Pointer
-BlueprintImpl::FromPropertyTree(const PropertyTreeType & pt)
+BlueprintImpl::SweepVariantsType
+BlueprintImpl
+::ExpandSweeps( BlueprintImpl & expanded ) const
 {
-  Blueprint::Pointer blueprint = Blueprint::New();
-
-  BOOST_FOREACH(const PropertyTreeType::value_type & v, pt.equal_range("Component"))
-  {
-    std::string      componentName;
-    ParameterMapType componentPropertyMap;
-    for (auto const & elm : v.second)
+  // An axis of the sweep is a swept parameter of a component
+  struct Axis
+  {
+    ComponentNameType  componentName;
+    ParameterKeyType   key;
+    ParameterValueType values;
+  };
+
+  std::vector< Axis >             axes;
+  std::set< ComponentNameType >   affectedNames;
+  std::vector< ComponentNameType > worklist;
+  for( auto const & componentName : this->GetComponentNames() )
+  {
+    const ParameterMapType parameterMap = this->GetComponent( componentName );
+    const auto             sweep        = parameterMap.find( keys::Sweep );
+    if( sweep == parameterMap.end() )
     {
-      const std::string & componentKey = elm.first;
-      if (componentKey == "Name")
+      continue;
+    }
+    std::set< ParameterKeyType > sweptKeys;
+    for( auto const & key : sweep->second )
+    {
+      if( !sweptKeys.insert( key ).second )
       {
-        componentName = elm.second.data();
         continue;
       }
-
-      ParameterValueType propertyMultiValue = VectorizeValues(elm.second);
-      std::string        propertyKey = elm.first;
-      componentPropertyMap[propertyKey] = propertyMultiValue;
+      const auto values = parameterMap.find( key );
+      if( values == parameterMap.end() || values->second.empty() )
+      {
+        std::string msg = "Component '" + componentName + "' sweeps the parameter '" + key + "', but it has no values";
+        this->m_LoggerImpl->Log( LogLevel::ERR, msg );
+        throw std::runtime_error( msg );
+      }
+      axes.push_back( { componentName, key, values->second } );
     }
-
-    blueprint->SetComponent(componentName, componentPropertyMap);
+    affectedNames.insert( componentName );
+    worklist.push_back( componentName );
   }
 
-  BOOST_FOREACH(const PropertyTreeType::value_type & v, pt.equal_range("Connection"))
+  // The components downstream of the swept parameters differ per variant, the other components are shared by all variants
+  while( !worklist.empty() )
   {
-    std::string connectionName = v.second.data();
-    if (connectionName != "")
-    {
-      this->m_LoggerImpl->Log(LogLevel::TRC, "Found {0}, but connection names are ignored.", connectionName);
-    }
-    std::string      outName;
-    std::string      inName;
-    ParameterMapType componentPropertyMap;
-
-    for (auto const & elm : v.second)
+    const ComponentNameType componentName = worklist.back();
+    worklist.pop_back();
+    for( auto const & outputName : this->GetOutputNames( componentName ) )
     {
-      const std::string & connectionKey = elm.first;
-
-      if (connectionKey == "Out")
-      {
-        outName = elm.second.data();
-        continue;
-      }
-      else if (connectionKey == "In")
-      {
-        inName = elm.second.data();
-        continue;
-      }
-      else if (connectionKey == "Name")
+      if( affectedNames.insert( outputName ).second )
       {
-        this->m_LoggerImpl->Log(LogLevel::WRN, "Connections with key 'Name' are ignored.");
-        continue;
-      }
-      else
-      {
-        ParameterValueType propertyMultiValue = VectorizeValues(elm.second);
-        std::string        propertyKey = elm.first;
-        componentPropertyMap[propertyKey] = propertyMultiValue;
+        worklist.push_back( outputName );
       }
     }
+  }
 
-    blueprint->SetConnection(outName, inName, componentPropertyMap);
+  // The variants are all combinations of the values of the axes, with the last axis varying fastest. Their labels are used in
+  // component and file names, so they consist of the key and value of each axis, prefixed by the component if the key is not unique.
+  std::map< ParameterKeyType, unsigned int > numberOfAxesPerKey;
+  std::size_t                                numberOfVariants = 1;
+  for( auto const & axis : axes )
+  {
+    ++numberOfAxesPerKey[ axis.key ];
+    numberOfVariants *= axis.values.size();
   }
-  return blueprint;
-}
 
-void
-BlueprintImpl::MergeProperties(const PropertyTreeType & pt)
-{
-  BOOST_FOREACH(const PropertyTreeType::value_type & v, pt.equal_range("Component"))
+  std::vector< std::vector< std::size_t > > valueIndices( numberOfVariants, std::vector< std::size_t >( axes.size() ) );
+  SweepVariantsType                         variants( numberOfVariants );
+  std::set< std::string >                   labels;
+  for( std::size_t variantIndex = 0; variantIndex < numberOfVariants; ++variantIndex )
   {
-    std::string      componentName;
-    ParameterMapType newProperties;
-    for (auto const & elm : v.second)
+    std::size_t remainder = variantIndex;
+    for( std::size_t axisIndex = axes.size(); axisIndex-- > 0; )
     {
-      const std::string & componentKey = elm.first;
-      if (componentKey == "Name")
-      {
-        componentName = elm.second.data();
-        continue;
-      }
-
-      ParameterValueType propertyMultiValue = VectorizeValues(elm.second);
-      std::string        propertyKey = elm.first;
-      newProperties[propertyKey] = propertyMultiValue;
+      valueIndices[ variantIndex ][ axisIndex ] = remainder % axes[ axisIndex ].values.size();
+      remainder /= axes[ axisIndex ].values.size();
     }
 
-    // Merge newProperies into current blueprint properties
-    // Does blueprint use component with a name that already exists?
-    if (this->ComponentExists(componentName))
+    std::string label;
+    for( std::size_t axisIndex = 0; axisIndex < axes.size(); ++axisIndex )
     {
-      // Component exists, check if properties can be merged
-      auto currentProperties = this->GetComponent(componentName);
+      const Axis & axis = axes[ axisIndex ];
+      label += ( label.empty() ? "" : "_" ) + ( numberOfAxesPerKey[ axis.key ] > 1 ? axis.componentName + "." : "" )
+        + axis.key + "-" + axis.values[ valueIndices[ variantIndex ][ axisIndex ] ];
+    }
+    std::replace_if( label.begin(), label.end(), []( char c ){
+        return !std::isalnum( static_cast< unsigned char >( c ) ) && c != '.' && c != '-' && c != '_';
+      }, '-' );
+    variants[ variantIndex ].label = label;
+    labels.insert( label );
+  }
+  for( std::size_t variantIndex = 0; variantIndex < numberOfVariants; ++variantIndex )
+  {
+    // Values that differ only in characters that are replaced give equal labels
+    if( labels.size() < numberOfVariants )
+    {
+      variants[ variantIndex ].label = "variant" + std::to_string( variantIndex );
+    }
+    for( auto const & affectedName : affectedNames )
+    {
+      variants[ variantIndex ].componentNames[ affectedName ] = affectedName + "_" + variants[ variantIndex ].label;
+    }
+  }
 
-      for (auto const & othersEntry : newProperties)
+  // Each variant is a copy of this blueprint with the affected components renamed. Composing them merges the shared components.
+  for( std::size_t variantIndex = 0; variantIndex < numberOfVariants; ++variantIndex )
+  {
+    const SweepVariant & variant = variants[ variantIndex ];
+    auto                 nameOf  = [ &variant ]( const ComponentNameType & componentName ) {
+                                     const auto copy = variant.componentNames.find( componentName );
+                                     return copy == variant.componentNames.end() ? componentName : copy->second;
+                                   };
+
+    BlueprintImpl variantBlueprint( *this->m_LoggerImpl );
+    for( auto const & componentName : this->GetComponentNames() )
+    {
+      ParameterMapType parameterMap = this->GetComponent( componentName );
+      parameterMap.erase( keys::Sweep );
+      for( std::size_t axisIndex = 0; axisIndex < axes.size(); ++axisIndex )
       {
-        // Does other use a property key that already exists in this component?
-        if (currentProperties.count(othersEntry.first))
+        if( axes[ axisIndex ].componentName == componentName )
         {
-          auto && ownValues = currentProperties[othersEntry.first];
-          auto && otherValues = othersEntry.second;
-          // Are the property values equal?
-          if (ownValues.size() != otherValues.size())
-          {
-            // No, based on the number of values we see that it is different. Blueprints cannot be Composed
-            this->m_LoggerImpl->Log(LogLevel::ERR, "Merging blueprints failed : Component properties cannot be redefined");
-            throw std::invalid_argument("Merging blueprints failed : Component properties cannot be redefined");
-          }
-          else
-          {
-            ParameterValueType::const_iterator ownValue;
-            ParameterValueType::const_iterator otherValue;
-            for (ownValue = ownValues.begin(), otherValue = otherValues.begin(); ownValue != ownValues.end(); ++ownValue, ++otherValue)
-            {
-              if (*otherValue != *ownValue)
-              {
-                // No, at least one value is different. Blueprints cannot be Composed
-                this->m_LoggerImpl->Log(LogLevel::ERR, "Merging blueprints failed : Component properties cannot be redefined");
-                throw std::invalid_argument("Merging blueprints failed: Component properties cannot be redefined");
-              }
-            }
-          }
+          parameterMap[ axes[ axisIndex ].key ] = { axes[ axisIndex ].values[ valueIndices[ variantIndex ][ axisIndex ] ] };
         }
-        else
+      }
+      variantBlueprint.SetComponent( nameOf( componentName ), parameterMap );
+    }
+    for( auto const & upstream : this->GetComponentNames() )
+    {
+      const ComponentNamesType            outputNames = this->GetOutputNames( upstream );
+      const std::set< ComponentNameType > downstreamNames( outputNames.begin(), outputNames.end() );
+      for( auto const & downstream : downstreamNames )
+      {
+        for( auto const & connectionName : this->GetConnectionNames( upstream, downstream ) )
         {
-          // Property key doesn't exist yet, add entry to this component
-          auto ownProperties = this->GetComponent(componentName);
-          ownProperties[othersEntry.first] = othersEntry.second;
-          this->SetComponent(componentName, ownProperties);
+          variantBlueprint.SetConnection( nameOf( upstream ), nameOf( downstream ), this->GetConnection( upstream, downstream, connectionName ), connectionName );
         }
       }
     }
-    else
+
+    if( !expanded.ComposeWith( variantBlueprint ) )
     {
-      // Create Component and with the new properties
-      this->SetComponent(componentName, newProperties);
+      std::string msg = "Variant '" + variant.label + "' of the parameter sweep could not be composed into the expanded blueprint";
+      this->m_LoggerImpl->Log( LogLevel::ERR, msg );
+      throw std::runtime_error( msg );
     }
   }
 
-  BOOST_FOREACH(const PropertyTreeType::value_type & v, pt.equal_range("Connection"))
-  {
-    std::string connectionName = v.second.data();
-
-    std::string      outName;
-    std::string      inName;
-    ParameterMapType newProperties;
+  this->m_LoggerImpl->Log( LogLevel::INF, "Expanded the parameter sweep over {0:d} parameter(s) into {1:d} variant(s) of {2:d} component(s).",
+    axes.size(), numberOfVariants, affectedNames.size() );
+  return variants;
+}
 
-    for (auto const & elm : v.second)
-    {
-      const std::string & connectionKey = elm.first;
 
-      if (connectionKey == "Out")
-      {
-        outName = elm.second.data();
-        continue;
-      }
-      else if (connectionKey == "In")
-      {
-        inName = elm.second.data();
-        continue;
-      }
-      else if (connectionKey == "Name")
+std::string
+BlueprintImpl
+::GetCanonicalDescription() const
+{
+  // Strings are length-prefixed, such that no separator character needs to be escaped.
+  std::ostringstream description;
+  auto writeString = [ &description ]( const std::string & value ){
+      description << value.size() << ':' << value;
+    };
+  auto writeParameterMap = [ &description, &writeString ]( const ParameterMapType & parameterMap ){
+      description << '{';
+      for( auto const & keyAndValues : parameterMap )
       {
-        if (connectionName != "")
+        writeString( keyAndValues.first );
+        description << '[';
+        for( auto const & value : keyAndValues.second )
         {
-          this->m_LoggerImpl->Log(LogLevel::WRN, "Connection Name '{}' is overridden by '{}'", connectionName, elm.second.data());
+          writeString( value );
         }
-        connectionName = elm.second.data();
-        continue;
+        description << ']';
       }
-      else
+      description << '}';
+    };
+
+  ComponentNamesType componentNames = this->GetComponentNames();
+  std::sort( componentNames.begin(), componentNames.end() );
+  for( auto const & componentName : componentNames )
+  {
+    description << 'C';
+    writeString( componentName );
+    writeParameterMap( this->GetComponent( componentName ) );
+  }
+
+  for( auto const & upstream : componentNames )
+  {
+    // Parallel connections give duplicate output names
+    const ComponentNamesType            outputNames = this->GetOutputNames( upstream );
+    const std::set< ComponentNameType > downstreamNames( outputNames.begin(), outputNames.end() );
+    for( auto const & downstream : downstreamNames )
+    {
+      ConnectionNamesType connectionNames = this->GetConnectionNames( upstream, downstream );
+      std::sort( connectionNames.begin(), connectionNames.end() );
+      for( auto const & connectionName : connectionNames )
       {
-        ParameterValueType propertyMultiValue = VectorizeValues(elm.second);
-        std::string        propertyKey = elm.first;
-        newProperties[propertyKey] = propertyMultiValue;
+        description << 'E';
+        writeString( upstream );
+        writeString( downstream );
+        writeString( connectionName );
+        writeParameterMap( this->GetConnection( upstream, downstream, connectionName ) );
       }
     }
+  }
+  return description.str();
+}
+
+
+BlueprintImpl::ConnectionNamesType
+BlueprintImpl
+::GetConnectionNames(const ComponentNameType upstream, const ComponentNameType downstream) const
+{
+  ConnectionNamesType     container;
+
+  boost::graph_traits<GraphType>::out_edge_iterator ei, ei_end;
+  // too bad edge_range_by_label doesn't exist
+  boost::tie(ei, ei_end) = boost::edge_range(this->m_Graph.vertex(upstream), this->m_Graph.vertex(downstream), this->m_Graph.graph());
+
+  for (; ei != ei_end; ++ei)
+  {
+    container.push_back(boost::get(&ConnectionPropertyType::name, this->m_Graph.graph(), *ei));
+  }
+  return container;
+}
+
+
+
+void
+BlueprintImpl
+::Write( const std::string filename, const ComponentAnnotationsType & annotations )
+{
+  std::ofstream dotfile( filename.c_str() );
+  boost::write_graphviz( dotfile, this->m_Graph,
+    make_vertex_label_writer( boost::get( &ComponentPropertyType::name, this->m_Graph ),
+    boost::get( &ComponentPropertyType::parameterMap, this->m_Graph ), annotations ),
+    make_edge_label_writer( boost::get( &ConnectionPropertyType::parameterMap, this->m_Graph ) ) );
+}
+
+void
+BlueprintImpl::MergeFromFile(const std::string & fileNameString)
+{
+  BlueprintFile::PathType fileName(fileNameString);
+
+  this->m_LoggerImpl->Log(LogLevel::INF, "Loading {0} ... ", fileName);
+  BlueprintFile::ConstPointer blueprintFile;
+  try
+  {
+    blueprintFile = BlueprintFile::Read(fileName, *this->m_LoggerImpl);
+  }
+  catch (const std::exception & e)
+  {
+    this->m_LoggerImpl->Log(LogLevel::ERR, "Loading {0} failed: {1}", fileName, e.what());
+    throw;
+  }
+  this->m_LoggerImpl->Log(LogLevel::INF, "Loading {0} ... Done", fileName);
+
+  this->m_LoggerImpl->Log(LogLevel::INF, "Checking {0} for include files ... ", fileName);
+  for (auto const & includePath : blueprintFile->includes)
+  {
+    this->m_LoggerImpl->Log(LogLevel::INF, "Including file {0} ... ", includePath);
+    this->MergeFromFile(includePath.string());
+  }
+  this->m_LoggerImpl->Log(LogLevel::INF, "Checking {0} for include files ... done", fileName);
+
+  for (auto const & component : blueprintFile->components)
+  {
+    this->MergeComponent(component);
+  }
+  for (auto const & connection : blueprintFile->connections)
+  {
+    this->MergeConnection(connection);
+  }
+}
 
-    // Does the blueprint have a connection that already exists?
-    if (this->ConnectionExists(outName, inName, connectionName))
+void
+BlueprintImpl::SetLoggerImpl( LoggerImpl & loggerImpl )
+{
+  this->m_LoggerImpl = &loggerImpl;
+}
+
+void
+BlueprintImpl::MergeComponent(const BlueprintFile::Component & component)
+{
+  // Does blueprint use component with a name that already exists?
+  if (!this->ComponentExists(component.name))
+  {
+    this->SetComponent(component.name, component.parameterMap);
+    return;
+  }
+
+  // Component exists, check if properties can be merged
+  auto ownProperties = this->GetComponent(component.name);
+  for (auto const & othersEntry : component.parameterMap)
+  {
+    auto ownEntry = ownProperties.find(othersEntry.first);
+    if (ownEntry == ownProperties.end())
     {
-      // Connection exists, check if properties can be merged
-      auto ownProperties = this->GetConnection(outName, inName, connectionName);
+      // Property key doesn't exist yet, add entry to this component
+      ownProperties.insert(othersEntry);
+    }
+    else if (ownEntry->second != othersEntry.second)
+    {
+      // The property values are different. Blueprints cannot be Composed
+      this->m_LoggerImpl->Log(LogLevel::ERR, "Merging blueprints failed : Component properties cannot be redefined ({0})", component.location.ToString());
+      throw std::invalid_argument("Merging blueprints failed: Component properties cannot be redefined (" + component.location.ToString() + ")");
+    }
+  }
+  this->SetComponent(component.name, ownProperties);
+}
 
-      for (auto const & othersEntry : newProperties)
-      {
-        // Does newProperties use a key that already exists in this component?
-        if (ownProperties.count(othersEntry.first))
-        {
-          auto && ownValues = ownProperties[othersEntry.first];
-          auto && otherValues = othersEntry.second;
-          // Are the property values equal?
-          if (ownValues.size() != otherValues.size())
-          {
-            // No, based on the number of values we see that it is different. Blueprints cannot be Composed
-            this->m_LoggerImpl->Log(LogLevel::ERR, "Merging blueprints failed : Connection properties cannot be redefined");
-            throw std::invalid_argument("Merging blueprints failed: Connection properties cannot be redefined");
-          }
-          else
-          {
-            ParameterValueType::const_iterator ownValue;
-            ParameterValueType::const_iterator otherValue;
-            for (ownValue = ownValues.begin(), otherValue = otherValues.begin(); ownValue != ownValues.end(); ++ownValue, ++otherValue)
-            {
-              if (*otherValue != *ownValue)
-              {
-                // No, at least one value is different. Blueprints cannot be Composed
-                this->m_LoggerImpl->Log(LogLevel::ERR, "Merging blueprints failed : Connection properties cannot be redefined");
-                throw std::invalid_argument("Merging blueprints failed: Connection properties cannot be redefined");
-              }
-            }
-          }
-        }
-        else
-        {
-          // Property key doesn't exist yet, add entry to this component
-          //auto ownProperties = this->GetConnection(incomingName, componentName);
-          ownProperties[othersEntry.first] = othersEntry.second;
-          this->SetConnection(outName, inName, ownProperties, connectionName);
-        }
-      }
+void
+BlueprintImpl::MergeConnection(const BlueprintFile::Connection & connection)
+{
+  // Does the blueprint have a connection that already exists?
+  if (!this->ConnectionExists(connection.out, connection.in, connection.name))
+  {
+    this->SetConnection(connection.out, connection.in, connection.parameterMap, connection.name);
+    return;
+  }
+
+  // Connection exists, check if properties can be merged
+  auto ownProperties = this->GetConnection(connection.out, connection.in, connection.name);
+  for (auto const & othersEntry : connection.parameterMap)
+  {
+    auto ownEntry = ownProperties.find(othersEntry.first);
+    if (ownEntry == ownProperties.end())
+    {
+      // Property key doesn't exist yet, add entry to this connection
+      ownProperties.insert(othersEntry);
     }
-    else
+    else if (ownEntry->second != othersEntry.second)
     {
-      // Create Component copying properties of other
-      this->SetConnection(outName, inName, newProperties, connectionName);
+      // The property values are different. Blueprints cannot be Composed
+      this->m_LoggerImpl->Log(LogLevel::ERR, "Merging blueprints failed : Connection properties cannot be redefined ({0})", connection.location.ToString());
+      throw std::invalid_argument("Merging blueprints failed: Connection properties cannot be redefined (" + connection.location.ToString() + ")");
     }
   }
+  this->SetConnection(connection.out, connection.in, ownProperties, connection.name);
 }
 } // namespace selx
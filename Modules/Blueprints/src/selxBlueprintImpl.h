@@ -31,13 +31,8 @@
 // for ComposeWith
 #include "boost/graph/copy.hpp"
 
-// for FromFile and MergeFromFile
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/xml_parser.hpp>
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/info_parser.hpp>
-#include <boost/foreach.hpp>
-#include <boost/filesystem.hpp>
+// for MergeFromFile
+#include "selxBlueprintReader.h"
 
 #include <string>
 #include <iostream>
@@ -62,6 +57,9 @@ public:
   typedef Blueprint::ComponentNamesType ComponentNamesType;
   typedef Blueprint::ConnectionNameType ConnectionNameType;
   typedef Blueprint::ConnectionNamesType ConnectionNamesType;
+  typedef Blueprint::ComponentAnnotationsType ComponentAnnotationsType;
+  typedef Blueprint::SweepVariant SweepVariant;
+  typedef Blueprint::SweepVariantsType SweepVariantsType;
 
   
 
@@ -107,6 +105,8 @@ public:
   typedef boost::graph_traits< GraphType >::out_edge_iterator OutputIteratorType;
   typedef std::pair< OutputIteratorType, OutputIteratorType > OutputIteratorPairType;
 
+  typedef std::vector< ComponentIndexType > ComponentIndicesType;
+
   BlueprintImpl( LoggerImpl & loggerImpl);
 
 
@@ -144,27 +144,53 @@ public:
 
   ComponentNamesType GetUpdateOrder() const;
 
-  void Write( const std::string filename );
+  // The components and connections by their integer ids in the graph, for internals that traverse the graph repeatedly, such as the
+  // NetworkBuilder. The string based functions above are a facade over these. Component ids are 0 .. GetNumberOfComponents() - 1,
+  // in the order of GetComponentNames(). Ids stay valid until a component is deleted.
+  std::size_t GetNumberOfComponents() const { return boost::num_vertices( this->m_Graph.graph() ); }
 
-  void MergeFromFile(const std::string & filename);
+  // Throws if the component does not exist
+  ComponentIndexType GetComponentIndex( const ComponentNameType & name ) const;
 
-  void SetLoggerImpl( LoggerImpl & loggerImpl );
+  const ComponentNameType & GetComponentName( ComponentIndexType index ) const { return this->m_Graph.graph()[ index ].name; }
 
-private:
+  const ParameterMapType & GetComponentParameterMap( ComponentIndexType index ) const { return this->m_Graph.graph()[ index ].parameterMap; }
+
+  // The ids of the components at the incoming and outgoing connections, once per parallel connection
+  ComponentIndicesType GetInputIndices( ComponentIndexType index ) const;
+  ComponentIndicesType GetOutputIndices( ComponentIndexType index ) const;
+
+  ComponentIndicesType GetUpdateOrderIndices() const;
+
+  // All connections, with their components and properties
+  ConnectionIteratorPairType GetConnections() const { return boost::edges( this->m_Graph.graph() ); }
+
+  ComponentIndexType GetUpstreamIndex( ConnectionIndexType connection ) const { return boost::source( connection, this->m_Graph.graph() ); }
 
-  typedef boost::property_tree::ptree         PropertyTreeType;
-  typedef const boost::property_tree::ptree & ComponentOrConnectionTreeType;
+  ComponentIndexType GetDownstreamIndex( ConnectionIndexType connection ) const { return boost::target( connection, this->m_Graph.graph() ); }
 
-  using PathType = boost::filesystem::path;
-  using PathsType = std::list<PathType>;
+  const ConnectionPropertyType & GetConnectionProperty( ConnectionIndexType connection ) const { return this->m_Graph.graph()[ connection ]; }
 
-  PropertyTreeType ReadPropertyTree(const PathType & filename);
+  bool HasSweeps() const;
 
-  PathsType FindIncludes(const PropertyTreeType &);
-  ParameterValueType VectorizeValues(ComponentOrConnectionTreeType componentOrConnectionTree);
+  // Compose the variants of the parameter sweeps into the (empty) expanded blueprint, see Blueprint::ExpandSweeps
+  SweepVariantsType ExpandSweeps( BlueprintImpl & expanded ) const;
+
+  // Returns a description of the components, connections and their parameter maps that is independent of the order in which
+  // they were set. Equal blueprints have equal descriptions, such that it can be used as a key to cache networks.
+  std::string GetCanonicalDescription() const;
+
+  void Write( const std::string filename, const ComponentAnnotationsType & annotations = ComponentAnnotationsType() );
+
+  void MergeFromFile(const std::string & filename);
+
+  void SetLoggerImpl( LoggerImpl & loggerImpl );
+
+private:
 
-  Blueprint::Pointer FromPropertyTree(const PropertyTreeType &);
-  void MergeProperties(const PropertyTreeType &);
+  // Add a component or connection of a file, or merge its properties into the existing one. Existing properties cannot be redefined.
+  void MergeComponent( const BlueprintFile::Component & component );
+  void MergeConnection( const BlueprintFile::Connection & connection );
 
   GraphType m_Graph;
 
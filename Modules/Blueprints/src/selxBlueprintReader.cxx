@@ -0,0 +1,923 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxBlueprintReader.h"
+#include "selxKeys.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace selx
+{
+namespace
+{
+typedef BlueprintFile::Location           LocationType;
+typedef BlueprintFile::ParameterValueType ParameterValueType;
+
+// Receives the elements of a blueprint file while it is parsed. The elements nest like the property tree that was read before:
+// the top-level Include, Component and Connection elements, their properties and the values of the properties. The values of a
+// swept property are the children of its "sweep" element(s), e.g. "NumberOfIterations": { "sweep": [ "100", "200" ] }.
+class BlueprintFileBuilder
+{
+public:
+
+  BlueprintFileBuilder( BlueprintFile & file, LoggerImpl & logger ) : m_File( file ), m_Logger( logger ), m_Depth( 0 ),
+    m_Kind( Kind::Ignored ), m_HasConnectionName( false ), m_HasIncludes( false ) {}
+
+  void StartElement( const std::string & key, const LocationType & location )
+  {
+    ++this->m_Depth;
+    if( this->m_Depth == 1 )
+    {
+      this->m_Kind = key == "Component" ? Kind::Component
+                   : key == "Connection" ? Kind::Connection
+                   : key == "Include" ? Kind::Include
+                   : Kind::Ignored;
+      this->m_EntryLocation = location;
+      this->m_EntryData.clear();
+      this->m_EntryValues.clear();
+      this->m_Component         = BlueprintFile::Component();
+      this->m_Connection        = BlueprintFile::Connection();
+      this->m_HasConnectionName = false;
+    }
+    else if( this->m_Depth == 2 )
+    {
+      this->m_PropertyKey      = key;
+      this->m_PropertyLocation = location;
+      this->m_PropertyData.clear();
+      this->m_PropertyValues.clear();
+      this->m_SweepValues.clear();
+    }
+    else if( this->m_Depth == 3 )
+    {
+      this->m_ValueKey = key;
+      this->m_ValueData.clear();
+      this->m_ValueValues.clear();
+    }
+    else if( this->m_Depth == 4 )
+    {
+      this->m_ValueValueData.clear();
+    }
+  }
+
+
+  // Data of the current element. Data that is interrupted by child elements is concatenated.
+  void Data( const std::string & data )
+  {
+    if( this->m_Depth == 1 )
+    {
+      this->m_EntryData += data;
+    }
+    else if( this->m_Depth == 2 )
+    {
+      this->m_PropertyData += data;
+    }
+    else if( this->m_Depth == 3 )
+    {
+      this->m_ValueData += data;
+    }
+    else if( this->m_Depth == 4 )
+    {
+      this->m_ValueValueData += data;
+    }
+  }
+
+
+  void EndElement()
+  {
+    if( this->m_Depth == 4 )
+    {
+      this->m_ValueValues.push_back( this->m_ValueValueData );
+    }
+    else if( this->m_Depth == 3 && this->m_ValueKey == "sweep" )
+    {
+      const ParameterValueType values = Values( this->m_ValueData, this->m_ValueValues, this->m_PropertyLocation );
+      this->m_SweepValues.insert( this->m_SweepValues.end(), values.begin(), values.end() );
+    }
+    else if( this->m_Depth == 3 )
+    {
+      this->m_PropertyValues.push_back( this->m_ValueData );
+    }
+    else if( this->m_Depth == 2 )
+    {
+      this->EndProperty();
+    }
+    else if( this->m_Depth == 1 )
+    {
+      this->EndEntry();
+    }
+    --this->m_Depth;
+  }
+
+private:
+
+  enum class Kind { Ignored, Component, Connection, Include };
+
+  // An element has either a single value or child elements with a value each
+  static ParameterValueType Values( const std::string & data, const ParameterValueType & values, const LocationType & location )
+  {
+    if( values.empty() )
+    {
+      return ParameterValueType( 1, data );
+    }
+    if( !data.empty() )
+    {
+      throw std::invalid_argument( location.ToString() + ": XML tree should have either 1 unnamed element or multiple named properties" );
+    }
+    return values;
+  }
+
+
+  void EndProperty()
+  {
+    const std::string & key = this->m_PropertyKey;
+    if( !this->m_SweepValues.empty() )
+    {
+      if( this->m_Kind != Kind::Component || key == "Name" || !this->m_PropertyData.empty() || !this->m_PropertyValues.empty() )
+      {
+        throw std::invalid_argument( this->m_PropertyLocation.ToString() + ": only the values of a component parameter can be swept" );
+      }
+      this->m_Component.parameterMap[ key ] = this->m_SweepValues;
+      this->m_Component.parameterMap[ keys::Sweep ].push_back( key );
+      return;
+    }
+    if( this->m_Kind == Kind::Component )
+    {
+      if( key == "Name" )
+      {
+        this->m_Component.name = this->m_PropertyData;
+      }
+      else if( key == keys::Sweep )
+      {
+        // Added to the parameters that were declared swept by their values
+        const ParameterValueType values = Values( this->m_PropertyData, this->m_PropertyValues, this->m_PropertyLocation );
+        auto &                   sweep  = this->m_Component.parameterMap[ key ];
+        sweep.insert( sweep.end(), values.begin(), values.end() );
+      }
+      else
+      {
+        this->m_Component.parameterMap[ key ] = Values( this->m_PropertyData, this->m_PropertyValues, this->m_PropertyLocation );
+      }
+    }
+    else if( this->m_Kind == Kind::Connection )
+    {
+      if( key == "Out" )
+      {
+        this->m_Connection.out = this->m_PropertyData;
+      }
+      else if( key == "In" )
+      {
+        this->m_Connection.in = this->m_PropertyData;
+      }
+      else if( key == "Name" )
+      {
+        this->m_Connection.name   = this->m_PropertyData;
+        this->m_HasConnectionName = true;
+      }
+      else
+      {
+        this->m_Connection.parameterMap[ key ] = Values( this->m_PropertyData, this->m_PropertyValues, this->m_PropertyLocation );
+      }
+    }
+    else if( this->m_Kind == Kind::Include )
+    {
+      this->m_EntryValues.push_back( this->m_PropertyData );
+    }
+  }
+
+
+  void EndEntry()
+  {
+    if( this->m_Kind == Kind::Component )
+    {
+      this->m_Component.location = this->m_EntryLocation;
+      this->m_File.components.push_back( std::move( this->m_Component ) );
+    }
+    else if( this->m_Kind == Kind::Connection )
+    {
+      // The data of a Connection element is its name, unless it has a Name property
+      if( !this->m_HasConnectionName )
+      {
+        this->m_Connection.name = this->m_EntryData;
+      }
+      else if( !this->m_EntryData.empty() )
+      {
+        this->m_Logger.Log( LogLevel::WRN, "Connection Name '{}' is overridden by '{}'", this->m_EntryData, this->m_Connection.name );
+      }
+      this->m_Connection.location = this->m_EntryLocation;
+      this->m_File.connections.push_back( std::move( this->m_Connection ) );
+    }
+    else if( this->m_Kind == Kind::Include )
+    {
+      if( this->m_HasIncludes )
+      {
+        throw std::runtime_error( this->m_EntryLocation.ToString() + ": Only 1 listing of Includes is allowed per Blueprint file" );
+      }
+      for( const auto & include : Values( this->m_EntryData, this->m_EntryValues, this->m_EntryLocation ) )
+      {
+        this->m_File.includes.push_back( BlueprintFile::PathType( include ) );
+      }
+      this->m_HasIncludes = true;
+    }
+  }
+
+
+  BlueprintFile & m_File;
+  LoggerImpl &    m_Logger;
+  int             m_Depth;
+  Kind            m_Kind;
+
+  LocationType              m_EntryLocation;
+  std::string               m_EntryData;
+  ParameterValueType        m_EntryValues;
+  BlueprintFile::Component  m_Component;
+  BlueprintFile::Connection m_Connection;
+  bool                      m_HasConnectionName;
+  bool                      m_HasIncludes;
+
+  std::string        m_PropertyKey;
+  LocationType       m_PropertyLocation;
+  std::string        m_PropertyData;
+  ParameterValueType m_PropertyValues;
+  ParameterValueType m_SweepValues;
+
+  std::string        m_ValueKey;
+  std::string        m_ValueData;
+  ParameterValueType m_ValueValues;
+  std::string        m_ValueValueData;
+};
+
+// Position in the text of a file, with the line and column for error messages
+class TextCursor
+{
+public:
+
+  TextCursor( const std::string & text, const std::string & fileName ) : m_Text( text ), m_FileName( fileName ), m_Position( 0 ),
+    m_Line( 1 ), m_Column( 1 )
+  {
+    // Like the property tree readers, skip the UTF-8 byte order mark that some editors write
+    if( this->StartsWith( "\xEF\xBB\xBF" ) )
+    {
+      this->m_Position = 3;
+    }
+  }
+
+protected:
+
+  bool AtEnd() const { return this->m_Position == this->m_Text.size(); }
+
+  LocationType Here() const { return { this->m_FileName, this->m_Line, this->m_Column }; }
+
+  [[noreturn]] void Fail( const std::string & message ) const
+  {
+    throw std::runtime_error( this->Here().ToString() + ": " + message );
+  }
+
+
+  char Peek() const
+  {
+    if( this->AtEnd() )
+    {
+      this->Fail( "unexpected end of data" );
+    }
+    return this->m_Text[ this->m_Position ];
+  }
+
+
+  char Get()
+  {
+    const char c = this->Peek();
+    ++this->m_Position;
+    if( c == '\n' )
+    {
+      ++this->m_Line;
+      this->m_Column = 1;
+    }
+    else
+    {
+      ++this->m_Column;
+    }
+    return c;
+  }
+
+
+  bool StartsWith( const char * prefix ) const
+  {
+    return this->m_Text.compare( this->m_Position, std::char_traits< char >::length( prefix ), prefix ) == 0;
+  }
+
+
+  bool Accept( char c )
+  {
+    if( !this->AtEnd() && this->m_Text[ this->m_Position ] == c )
+    {
+      this->Get();
+      return true;
+    }
+    return false;
+  }
+
+
+  void Expect( char c )
+  {
+    if( !this->Accept( c ) )
+    {
+      this->Fail( std::string( "expected '" ) + c + "'" );
+    }
+  }
+
+
+  void SkipWhitespace()
+  {
+    while( !this->AtEnd() && std::isspace( static_cast< unsigned char >( this->m_Text[ this->m_Position ] ) ) )
+    {
+      this->Get();
+    }
+  }
+
+
+  // Skips past the terminator
+  void SkipPast( const char * terminator )
+  {
+    const auto end = this->m_Text.find( terminator, this->m_Position );
+    if( end == std::string::npos )
+    {
+      this->Fail( std::string( "expected '" ) + terminator + "'" );
+    }
+    const auto stop = end + std::char_traits< char >::length( terminator );
+    while( this->m_Position < stop )
+    {
+      this->Get();
+    }
+  }
+
+
+  static void AppendUtf8( std::string & text, unsigned long codePoint )
+  {
+    if( codePoint < 0x80 )
+    {
+      text += static_cast< char >( codePoint );
+    }
+    else if( codePoint < 0x800 )
+    {
+      text += static_cast< char >( 0xC0 | ( codePoint >> 6 ) );
+      text += static_cast< char >( 0x80 | ( codePoint & 0x3F ) );
+    }
+    else if( codePoint < 0x10000 )
+    {
+      text += static_cast< char >( 0xE0 | ( codePoint >> 12 ) );
+      text += static_cast< char >( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+      text += static_cast< char >( 0x80 | ( codePoint & 0x3F ) );
+    }
+    else
+    {
+      text += static_cast< char >( 0xF0 | ( codePoint >> 18 ) );
+      text += static_cast< char >( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) );
+      text += static_cast< char >( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+      text += static_cast< char >( 0x80 | ( codePoint & 0x3F ) );
+    }
+  }
+
+
+  const std::string & m_Text;
+  const std::string   m_FileName;
+  std::size_t         m_Position;
+  std::size_t         m_Line;
+  std::size_t         m_Column;
+};
+
+// Each member of an object and each element of an array is an element, with an empty key for array elements. Strings, numbers
+// and literals are the data of their element.
+class JsonParser : private TextCursor
+{
+public:
+
+  JsonParser( const std::string & text, const std::string & fileName, BlueprintFileBuilder & builder ) : TextCursor( text, fileName ),
+    m_Builder( builder ) {}
+
+  void Parse()
+  {
+    this->SkipWhitespace();
+    this->ParseValue();
+    this->SkipWhitespace();
+    if( !this->AtEnd() )
+    {
+      this->Fail( "garbage after data" );
+    }
+  }
+
+private:
+
+  void ParseValue()
+  {
+    const char c = this->Peek();
+    if( c == '{' )
+    {
+      this->ParseObject();
+    }
+    else if( c == '[' )
+    {
+      this->ParseArray();
+    }
+    else if( c == '"' )
+    {
+      this->m_Builder.Data( this->ParseString() );
+    }
+    else
+    {
+      this->m_Builder.Data( this->ParseLiteral() );
+    }
+  }
+
+
+  void ParseObject()
+  {
+    this->Expect( '{' );
+    this->SkipWhitespace();
+    if( this->Accept( '}' ) )
+    {
+      return;
+    }
+    do
+    {
+      this->SkipWhitespace();
+      const LocationType location = this->Here();
+      if( this->Peek() != '"' )
+      {
+        this->Fail( "expected key string" );
+      }
+      const std::string key = this->ParseString();
+      this->SkipWhitespace();
+      this->Expect( ':' );
+      this->SkipWhitespace();
+      this->m_Builder.StartElement( key, location );
+      this->ParseValue();
+      this->m_Builder.EndElement();
+      this->SkipWhitespace();
+    }
+    while( this->Accept( ',' ) );
+    this->Expect( '}' );
+  }
+
+
+  void ParseArray()
+  {
+    this->Expect( '[' );
+    this->SkipWhitespace();
+    if( this->Accept( ']' ) )
+    {
+      return;
+    }
+    do
+    {
+      this->SkipWhitespace();
+      this->m_Builder.StartElement( "", this->Here() );
+      this->ParseValue();
+      this->m_Builder.EndElement();
+      this->SkipWhitespace();
+    }
+    while( this->Accept( ',' ) );
+    this->Expect( ']' );
+  }
+
+
+  unsigned long ParseHexQuad()
+  {
+    unsigned long codeUnit = 0;
+    for( int i = 0; i < 4; ++i )
+    {
+      const char c = this->Get();
+      if( !std::isxdigit( static_cast< unsigned char >( c ) ) )
+      {
+        this->Fail( "invalid escape sequence" );
+      }
+      codeUnit = codeUnit * 16 + ( std::isdigit( static_cast< unsigned char >( c ) ) ? c - '0' : std::tolower( c ) - 'a' + 10 );
+    }
+    return codeUnit;
+  }
+
+
+  std::string ParseString()
+  {
+    std::string value;
+    this->Expect( '"' );
+    for( char c = this->Get(); c != '"'; c = this->Get() )
+    {
+      if( static_cast< unsigned char >( c ) < 0x20 )
+      {
+        this->Fail( "invalid code sequence" );
+      }
+      if( c != '\\' )
+      {
+        value += c;
+        continue;
+      }
+      switch( this->Get() )
+      {
+        case '"': value += '"'; break;
+        case '\\': value += '\\'; break;
+        case '/': value += '/'; break;
+        case 'b': value += '\b'; break;
+        case 'f': value += '\f'; break;
+        case 'n': value += '\n'; break;
+        case 'r': value += '\r'; break;
+        case 't': value += '\t'; break;
+        case 'u':
+        {
+          unsigned long codePoint = this->ParseHexQuad();
+          if( codePoint >= 0xD800 && codePoint < 0xDC00 )
+          {
+            if( !this->StartsWith( "\\u" ) )
+            {
+              this->Fail( "invalid codepoint, stray high surrogate" );
+            }
+            this->Get();
+            this->Get();
+            const unsigned long lowSurrogate = this->ParseHexQuad();
+            if( lowSurrogate < 0xDC00 || lowSurrogate >= 0xE000 )
+            {
+              this->Fail( "expected low surrogate after high surrogate" );
+            }
+            codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( lowSurrogate - 0xDC00 );
+          }
+          AppendUtf8( value, codePoint );
+          break;
+        }
+        default:
+          this->Fail( "invalid escape sequence" );
+      }
+    }
+    return value;
+  }
+
+
+  // Numbers and the literals true, false and null are kept as they are written
+  std::string ParseLiteral()
+  {
+    std::string literal;
+    while( !this->AtEnd() )
+    {
+      const char c = this->Peek();
+      if( !std::isalnum( static_cast< unsigned char >( c ) ) && c != '-' && c != '+' && c != '.' )
+      {
+        break;
+      }
+      literal += this->Get();
+    }
+    if( literal == "true" || literal == "false" || literal == "null" )
+    {
+      return literal;
+    }
+    if( literal.empty() || !( std::isdigit( static_cast< unsigned char >( literal[ 0 ] ) ) || literal[ 0 ] == '-' ) )
+    {
+      this->Fail( "expected value" );
+    }
+    char * end = nullptr;
+    std::strtod( literal.c_str(), &end );
+    if( *end != '\0' )
+    {
+      this->Fail( "invalid number " + literal );
+    }
+    return literal;
+  }
+
+
+  BlueprintFileBuilder & m_Builder;
+};
+
+// Elements with their text as data. Like the property tree reader with trim_whitespace, the text is trimmed and runs of whitespace
+// are collapsed. Attributes, comments and processing instructions are skipped.
+class XmlParser : private TextCursor
+{
+public:
+
+  XmlParser( const std::string & text, const std::string & fileName, BlueprintFileBuilder & builder ) : TextCursor( text, fileName ),
+    m_Builder( builder ) {}
+
+  void Parse()
+  {
+    while( !this->AtEnd() )
+    {
+      if( this->Peek() != '<' )
+      {
+        this->ParseText();
+      }
+      else if( this->StartsWith( "<?" ) )
+      {
+        this->SkipPast( "?>" );
+      }
+      else if( this->StartsWith( "<!--" ) )
+      {
+        this->SkipPast( "-->" );
+      }
+      else if( this->StartsWith( "<![CDATA[" ) )
+      {
+        this->ParseCharacterData();
+      }
+      else if( this->StartsWith( "<!" ) )
+      {
+        this->SkipPast( ">" );
+      }
+      else if( this->StartsWith( "</" ) )
+      {
+        this->ParseEndTag();
+      }
+      else
+      {
+        this->ParseStartTag();
+      }
+    }
+    if( !this->m_OpenElements.empty() )
+    {
+      this->Fail( "expected </" + this->m_OpenElements.back() + ">" );
+    }
+  }
+
+private:
+
+  std::string ParseName()
+  {
+    std::string name;
+    while( !this->AtEnd() )
+    {
+      const char c = this->Peek();
+      if( std::isspace( static_cast< unsigned char >( c ) ) || c == '/' || c == '>' || c == '=' || c == '<' )
+      {
+        break;
+      }
+      name += this->Get();
+    }
+    if( name.empty() )
+    {
+      this->Fail( "expected element or attribute name" );
+    }
+    return name;
+  }
+
+
+  void ParseStartTag()
+  {
+    const LocationType location = this->Here();
+    this->Expect( '<' );
+    const std::string name = this->ParseName();
+    while( true )
+    {
+      this->SkipWhitespace();
+      if( this->Accept( '/' ) )
+      {
+        this->Expect( '>' );
+        this->m_Builder.StartElement( name, location );
+        this->m_Builder.EndElement();
+        return;
+      }
+      if( this->Accept( '>' ) )
+      {
+        this->m_Builder.StartElement( name, location );
+        this->m_OpenElements.push_back( name );
+        return;
+      }
+      this->ParseName();
+      this->SkipWhitespace();
+      this->Expect( '=' );
+      this->SkipWhitespace();
+      const char quote = this->Get();
+      if( quote != '"' && quote != '\'' )
+      {
+        this->Fail( "expected attribute value" );
+      }
+      while( this->Get() != quote )
+      {
+      }
+    }
+  }
+
+
+  void ParseEndTag()
+  {
+    this->Expect( '<' );
+    this->Expect( '/' );
+    const std::string name = this->ParseName();
+    this->SkipWhitespace();
+    if( this->m_OpenElements.empty() || this->m_OpenElements.back() != name )
+    {
+      this->Fail( "unexpected end tag </" + name + ">" );
+    }
+    this->Expect( '>' );
+    this->m_OpenElements.pop_back();
+    this->m_Builder.EndElement();
+  }
+
+
+  void ParseCharacterData()
+  {
+    for( int i = 0; i < 9; ++i )
+    {
+      this->Get();
+    }
+    std::string data;
+    while( !this->StartsWith( "]]>" ) )
+    {
+      data += this->Get();
+    }
+    this->SkipPast( "]]>" );
+    this->m_Builder.Data( data );
+  }
+
+
+  void ParseText()
+  {
+    std::string text;
+    bool        pendingSpace = false;
+    while( !this->AtEnd() && this->Peek() != '<' )
+    {
+      char c = this->Get();
+      if( std::isspace( static_cast< unsigned char >( c ) ) )
+      {
+        pendingSpace = !text.empty();
+        continue;
+      }
+      if( pendingSpace )
+      {
+        text += ' ';
+        pendingSpace = false;
+      }
+      if( c == '&' )
+      {
+        this->ParseEntity( text );
+      }
+      else
+      {
+        text += c;
+      }
+    }
+    if( !text.empty() && !this->m_OpenElements.empty() )
+    {
+      this->m_Builder.Data( text );
+    }
+  }
+
+
+  void ParseEntity( std::string & text )
+  {
+    std::string entity;
+    for( char c = this->Get(); c != ';'; c = this->Get() )
+    {
+      entity += c;
+      if( entity.size() > 8 )
+      {
+        this->Fail( "invalid character entity" );
+      }
+    }
+    if( entity == "lt" )
+    {
+      text += '<';
+    }
+    else if( entity == "gt" )
+    {
+      text += '>';
+    }
+    else if( entity == "amp" )
+    {
+      text += '&';
+    }
+    else if( entity == "quot" )
+    {
+      text += '"';
+    }
+    else if( entity == "apos" )
+    {
+      text += '\'';
+    }
+    else if( entity.size() > 1 && entity[ 0 ] == '#' )
+    {
+      const bool          hexadecimal = entity[ 1 ] == 'x';
+      const std::string   digits      = entity.substr( hexadecimal ? 2 : 1 );
+      char *              end         = nullptr;
+      const unsigned long codePoint   = std::strtoul( digits.c_str(), &end, hexadecimal ? 16 : 10 );
+      if( digits.empty() || *end != '\0' )
+      {
+        this->Fail( "invalid numeric character entity" );
+      }
+      AppendUtf8( text, codePoint );
+    }
+    else
+    {
+      this->Fail( "invalid character entity" );
+    }
+  }
+
+
+  BlueprintFileBuilder &     m_Builder;
+  std::vector< std::string > m_OpenElements;
+};
+
+struct CachedFile
+{
+  std::time_t                 modificationTime;
+  boost::uintmax_t            size;
+  BlueprintFile::ConstPointer file;
+};
+
+std::mutex &
+CacheMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+
+std::map< std::string, CachedFile > &
+Cache()
+{
+  static std::map< std::string, CachedFile > cache;
+  return cache;
+}
+} // namespace
+
+std::string
+BlueprintFile::Location::ToString() const
+{
+  return this->fileName + ":" + std::to_string( this->line ) + ":" + std::to_string( this->column );
+}
+
+
+BlueprintFile::ConstPointer
+BlueprintFile::Read( const PathType & fileName, LoggerImpl & logger )
+{
+  const std::string extension = fileName.extension().string();
+  if( extension != ".xml" && extension != ".json" )
+  {
+    throw std::invalid_argument( "Configuration file requires extension .xml or .json" );
+  }
+  if( !boost::filesystem::is_regular_file( fileName ) )
+  {
+    throw std::runtime_error( "Cannot open file " + fileName.string() );
+  }
+
+  // The modification time has a resolution of seconds, so the size catches most changes within the same second
+  const std::string      path             = boost::filesystem::canonical( fileName ).string();
+  const std::time_t      modificationTime = boost::filesystem::last_write_time( path );
+  const boost::uintmax_t size             = boost::filesystem::file_size( path );
+  {
+    std::lock_guard< std::mutex > lock( CacheMutex() );
+    auto                          cached = Cache().find( path );
+    if( cached != Cache().end() && cached->second.modificationTime == modificationTime && cached->second.size == size )
+    {
+      logger.Log( LogLevel::DBG, "Using the contents of {0} that were read before.", path );
+      return cached->second.file;
+    }
+  }
+
+  std::ifstream stream( path, std::ios::binary );
+  if( !stream )
+  {
+    throw std::runtime_error( "Cannot open file " + fileName.string() );
+  }
+  const std::string text( ( std::istreambuf_iterator< char >( stream ) ), std::istreambuf_iterator< char >() );
+
+  auto                 file = std::make_shared< BlueprintFile >();
+  BlueprintFileBuilder builder( *file, logger );
+  if( extension == ".xml" )
+  {
+    XmlParser( text, fileName.string(), builder ).Parse();
+  }
+  else
+  {
+    JsonParser( text, fileName.string(), builder ).Parse();
+  }
+
+  std::lock_guard< std::mutex > lock( CacheMutex() );
+  Cache()[ path ] = { modificationTime, size, file };
+  return file;
+}
+
+
+void
+BlueprintFile::ClearCache()
+{
+  std::lock_guard< std::mutex > lock( CacheMutex() );
+  Cache().clear();
+}
+} // namespace selx
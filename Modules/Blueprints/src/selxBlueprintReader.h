@@ -0,0 +1,84 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxBlueprintReader_h
+#define selxBlueprintReader_h
+
+#include "selxBlueprint.h"
+#include "selxLoggerImpl.h"
+
+#include <boost/filesystem.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace selx
+{
+// The includes, components and connections of a blueprint file, in the order in which they appear in the file.
+class BlueprintFile
+{
+public:
+
+  typedef std::shared_ptr< const BlueprintFile > ConstPointer;
+  typedef Blueprint::ParameterValueType          ParameterValueType;
+  typedef Blueprint::ParameterMapType            ParameterMapType;
+  typedef Blueprint::ComponentNameType           ComponentNameType;
+  typedef Blueprint::ConnectionNameType          ConnectionNameType;
+  typedef boost::filesystem::path                PathType;
+
+  struct Location
+  {
+    std::string ToString() const;
+
+    std::string fileName;
+    std::size_t line;
+    std::size_t column;
+  };
+
+  struct Component
+  {
+    ComponentNameType name;
+    ParameterMapType  parameterMap;
+    Location          location;
+  };
+
+  struct Connection
+  {
+    ComponentNameType  out;
+    ComponentNameType  in;
+    ConnectionNameType name;
+    ParameterMapType   parameterMap;
+    Location           location;
+  };
+
+  // Reads a .json or .xml blueprint file in a single pass, without building an intermediate property tree. Files are cached by path
+  // and modification time, such that include files that are shared by many blueprints are parsed once per process. Syntax errors
+  // are thrown as std::runtime_error with the line and column.
+  static ConstPointer Read( const PathType & fileName, LoggerImpl & logger );
+
+  static void ClearCache();
+
+  std::vector< PathType >   includes;
+  std::vector< Component >  components;
+  std::vector< Connection > connections;
+};
+} // namespace selx
+
+#endif // #ifndef selxBlueprintReader_h
@@ -19,6 +19,9 @@
 
 #include "selxBlueprintImpl.h"
 #include "selxBlueprint.h"
+#include "selxBlueprintReader.h"
+
+#include <fstream>
 
 #include "selxDataManager.h"
 #include "gtest/gtest.h"
@@ -141,6 +144,32 @@ TEST_F( BlueprintTest, CopyConstuctor )
   EXPECT_THROW( component1 = baseBlueprint->GetComponent( "Component1" ), std::runtime_error );
 }
 
+TEST_F( BlueprintTest, CanonicalDescription )
+{
+  // The description does not depend on the order in which components and connections are set
+  auto blueprint0 = Blueprint::New();
+  blueprint0->SetComponent( "ComponentA", parameterMap );
+  blueprint0->SetComponent( "ComponentB", anotherParameterMap );
+  blueprint0->SetConnection( "ComponentA", "ComponentB", { { "NameOfInterface", { "FirstInterface" } } }, "FirstConnection" );
+  blueprint0->SetConnection( "ComponentA", "ComponentB", { { "NameOfInterface", { "SecondInterface" } } }, "SecondConnection" );
+
+  auto blueprint1 = Blueprint::New();
+  blueprint1->SetComponent( "ComponentB", anotherParameterMap );
+  blueprint1->SetComponent( "ComponentA", parameterMap );
+  blueprint1->SetConnection( "ComponentA", "ComponentB", { { "NameOfInterface", { "SecondInterface" } } }, "SecondConnection" );
+  blueprint1->SetConnection( "ComponentA", "ComponentB", { { "NameOfInterface", { "FirstInterface" } } }, "FirstConnection" );
+
+  EXPECT_EQ( blueprint0->GetBlueprintImpl().GetCanonicalDescription(), blueprint1->GetBlueprintImpl().GetCanonicalDescription() );
+
+  // Any difference in parameters gives a different description
+  blueprint1->SetConnection( "ComponentA", "ComponentB", { { "NameOfInterface", { "ThirdInterface" } } }, "SecondConnection" );
+  EXPECT_NE( blueprint0->GetBlueprintImpl().GetCanonicalDescription(), blueprint1->GetBlueprintImpl().GetCanonicalDescription() );
+
+  blueprint1->SetConnection( "ComponentA", "ComponentB", { { "NameOfInterface", { "SecondInterface" } } }, "SecondConnection" );
+  blueprint1->SetComponent( "ComponentA", { { "NameOfClass", { "TestClass", "Name" } } } );
+  EXPECT_NE( blueprint0->GetBlueprintImpl().GetCanonicalDescription(), blueprint1->GetBlueprintImpl().GetCanonicalDescription() );
+}
+
 TEST_F( BlueprintTest, Compose )
 {
   auto baseBlueprint = Blueprint::New();
@@ -226,9 +255,190 @@ TEST_F(BlueprintTest, ParallelConnections) //#150: Let Blueprint handle two conn
   EXPECT_FALSE(blueprint->ConnectionExists("ComponentA", "ComponentB", "SecondConnection"));
 }
 
+TEST_F(BlueprintTest, ComponentIndices)
+{
+  auto blueprint = Blueprint::New();
+  blueprint->SetComponent("ComponentA", { { "NameOfClass", { "A" } } });
+  blueprint->SetComponent("ComponentB", { });
+  blueprint->SetConnection("ComponentA", "ComponentB", { { "NameOfInterface", { "FirstInterface" } } }, "FirstConnection");
+  blueprint->SetConnection("ComponentA", "ComponentB", { }, "SecondConnection");
+
+  const BlueprintImpl & blueprintImpl = blueprint->GetBlueprintImpl();
+  EXPECT_EQ(2u, blueprintImpl.GetNumberOfComponents());
+  const auto indexA = blueprintImpl.GetComponentIndex("ComponentA");
+  const auto indexB = blueprintImpl.GetComponentIndex("ComponentB");
+  EXPECT_EQ("ComponentA", blueprintImpl.GetComponentName(indexA));
+  EXPECT_EQ("A", blueprintImpl.GetComponentParameterMap(indexA).at("NameOfClass")[0]);
+  EXPECT_THROW(blueprintImpl.GetComponentIndex("ComponentC"), std::runtime_error);
+
+  EXPECT_EQ(BlueprintImpl::ComponentIndicesType({ indexA, indexA }), blueprintImpl.GetInputIndices(indexB));
+  EXPECT_EQ(BlueprintImpl::ComponentIndicesType({ indexB, indexB }), blueprintImpl.GetOutputIndices(indexA));
+  EXPECT_EQ(BlueprintImpl::ComponentIndicesType({ indexA, indexB }), blueprintImpl.GetUpdateOrderIndices());
+
+  std::set< std::string > connectionNames;
+  for( auto connections = blueprintImpl.GetConnections(); connections.first != connections.second; ++connections.first )
+  {
+    EXPECT_EQ(indexA, blueprintImpl.GetUpstreamIndex(*connections.first));
+    EXPECT_EQ(indexB, blueprintImpl.GetDownstreamIndex(*connections.first));
+    connectionNames.insert(blueprintImpl.GetConnectionProperty(*connections.first).name);
+  }
+  EXPECT_EQ(std::set< std::string >({ "FirstConnection", "SecondConnection" }), connectionNames);
+}
+
 TEST_F(BlueprintTest, ReadParallelConnections) //#150: Let Blueprint reader handle two connections between the same components
 {
   auto blueprint = Blueprint::New();
   EXPECT_NO_THROW(blueprint->MergeFromFile(this->dataManager->GetConfigurationFile("ReadParallelConnections.json")));
 
-}
\ No newline at end of file
+}
+TEST_F(BlueprintTest, ReadJsonAndXml)
+{
+  const std::string includeFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadJsonAndXml.Include.json");
+  std::ofstream(includeFileName) << "{\n"
+    "  \"Component\": { \"Name\": \"A\", \"NameOfClass\": \"TestClassName\", \"Values\": [ \"1\", 2.5, true ] },\n"
+    "  \"Component\": { \"Name\": \"B\", \"Escaped\": \"\\\"quoted\\\" \\u00e9\" }\n"
+    "}\n";
+
+  const std::string jsonFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadJsonAndXml.json");
+  std::ofstream(jsonFileName) << "{\n"
+    "  \"Include\": \"" << includeFileName << "\",\n"
+    "  \"Component\": { \"Name\": \"A\", \"Dimensionality\": \"3\" },\n"
+    "  \"Connection\": { \"Out\": \"A\", \"In\": \"B\", \"NameOfInterface\": \"TestInterface\" }\n"
+    "}\n";
+
+  const std::string xmlFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadJsonAndXml.xml");
+  std::ofstream(xmlFileName) << "<?xml version=\"1.0\"?>\n"
+    "<!-- Equivalent to the json files -->\n"
+    "<Component>\n  <Name>A</Name>\n  <NameOfClass>TestClassName</NameOfClass>\n"
+    "  <Values><V>1</V><V>2.5</V><V>true</V></Values>\n  <Dimensionality> 3 </Dimensionality>\n</Component>\n"
+    "<Component><Name>B</Name><Escaped>&quot;quoted&quot; &#xe9;</Escaped></Component>\n"
+    "<Connection>\n  <Out>A</Out>\n  <In>B</In>\n  <NameOfInterface>TestInterface</NameOfInterface>\n</Connection>\n";
+
+  auto jsonBlueprint = Blueprint::New();
+  EXPECT_NO_THROW(jsonBlueprint->MergeFromFile(jsonFileName));
+  EXPECT_EQ(ParameterValueType({ "1", "2.5", "true" }), jsonBlueprint->GetComponent("A")["Values"]);
+  EXPECT_EQ(ParameterValueType({ "3" }), jsonBlueprint->GetComponent("A")["Dimensionality"]);
+  EXPECT_EQ(ParameterValueType({ "\"quoted\" \xc3\xa9" }), jsonBlueprint->GetComponent("B")["Escaped"]);
+  EXPECT_TRUE(jsonBlueprint->ConnectionExists("A", "B"));
+
+  auto xmlBlueprint = Blueprint::New();
+  EXPECT_NO_THROW(xmlBlueprint->MergeFromFile(xmlFileName));
+  EXPECT_EQ(jsonBlueprint->GetBlueprintImpl().GetCanonicalDescription(), xmlBlueprint->GetBlueprintImpl().GetCanonicalDescription());
+}
+
+TEST_F(BlueprintTest, ReadErrorLocation)
+{
+  const std::string fileName = this->dataManager->GetOutputFile("BlueprintTest.ReadErrorLocation.json");
+  std::ofstream(fileName) << "{\n  \"Component\": {\n    \"Name\" \"A\"\n  }\n}\n";
+
+  auto blueprint = Blueprint::New();
+  try
+  {
+    blueprint->MergeFromFile(fileName);
+    FAIL() << "Expected a syntax error";
+  }
+  catch (const std::runtime_error & e)
+  {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find(fileName + ":3:12: expected ':'")) << e.what();
+  }
+}
+
+TEST_F(BlueprintTest, ReadByteOrderMark)
+{
+  const std::string jsonFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadByteOrderMark.json");
+  std::ofstream(jsonFileName) << "\xEF\xBB\xBF{ \"Component\": { \"Name\": \"A\" } }";
+  const std::string xmlFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadByteOrderMark.xml");
+  std::ofstream(xmlFileName) << "\xEF\xBB\xBF<?xml version=\"1.0\"?><Component><Name>A</Name></Component>";
+
+  auto jsonBlueprint = Blueprint::New();
+  EXPECT_NO_THROW(jsonBlueprint->MergeFromFile(jsonFileName));
+  EXPECT_TRUE(jsonBlueprint->ComponentExists("A"));
+  auto xmlBlueprint = Blueprint::New();
+  EXPECT_NO_THROW(xmlBlueprint->MergeFromFile(xmlFileName));
+  EXPECT_TRUE(xmlBlueprint->ComponentExists("A"));
+}
+
+TEST_F(BlueprintTest, ReadFilesOnce)
+{
+  const std::string fileName = this->dataManager->GetOutputFile("BlueprintTest.ReadFilesOnce.json");
+  std::ofstream(fileName) << "{ \"Component\": { \"Name\": \"A\" } }";
+
+  auto logger = Logger::New();
+  auto first = BlueprintFile::Read(fileName, logger->GetLoggerImpl());
+  EXPECT_EQ(first, BlueprintFile::Read(fileName, logger->GetLoggerImpl()));
+
+  // A changed file is read again
+  std::ofstream(fileName) << "{ \"Component\": { \"Name\": \"A\" }, \"Component\": { \"Name\": \"B\" } }";
+  auto second = BlueprintFile::Read(fileName, logger->GetLoggerImpl());
+  EXPECT_NE(first, second);
+  EXPECT_EQ(2, second->components.size());
+}
+
+TEST_F(BlueprintTest, ReadSweep)
+{
+  const std::string jsonFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadSweep.json");
+  std::ofstream(jsonFileName) << "{\n"
+    "  \"Component\": { \"Name\": \"A\", \"NumberOfIterations\": { \"sweep\": [ \"100\", 200 ] }, \"Spacing\": { \"sweep\": [ \"8\" ] } }\n"
+    "}\n";
+
+  const std::string xmlFileName = this->dataManager->GetOutputFile("BlueprintTest.ReadSweep.xml");
+  std::ofstream(xmlFileName) << "<Component><Name>A</Name>\n"
+    "  <NumberOfIterations><sweep>100</sweep><sweep>200</sweep></NumberOfIterations>\n  <Spacing><sweep>8</sweep></Spacing>\n</Component>\n";
+
+  auto jsonBlueprint = Blueprint::New();
+  EXPECT_NO_THROW(jsonBlueprint->MergeFromFile(jsonFileName));
+  EXPECT_TRUE(jsonBlueprint->HasSweeps());
+  EXPECT_EQ(ParameterValueType({ "100", "200" }), jsonBlueprint->GetComponent("A")["NumberOfIterations"]);
+  EXPECT_EQ(ParameterValueType({ "NumberOfIterations", "Spacing" }), jsonBlueprint->GetComponent("A")["Sweep"]);
+
+  auto xmlBlueprint = Blueprint::New();
+  EXPECT_NO_THROW(xmlBlueprint->MergeFromFile(xmlFileName));
+  EXPECT_EQ(jsonBlueprint->GetBlueprintImpl().GetCanonicalDescription(), xmlBlueprint->GetBlueprintImpl().GetCanonicalDescription());
+}
+
+TEST_F(BlueprintTest, ExpandSweeps)
+{
+  // Fixed -> Smoothing -> Registration -> Result, Moving -> Registration. Only Registration and Result depend on the sweep.
+  auto blueprint = Blueprint::New();
+  blueprint->SetComponent("Fixed", parameterMap);
+  blueprint->SetComponent("Moving", parameterMap);
+  blueprint->SetComponent("Smoothing", anotherParameterMap);
+  blueprint->SetComponent("Registration", { { "NumberOfIterations", { "100", "200", "400" } }, { "Metric", { "MI", "NC" } },
+    { "Sweep", { "NumberOfIterations", "Metric" } } });
+  blueprint->SetComponent("Result", parameterMap);
+  blueprint->SetConnection("Fixed", "Smoothing", {});
+  blueprint->SetConnection("Smoothing", "Registration", { { "NameOfInterface", { "FixedImageInterface" } } });
+  blueprint->SetConnection("Moving", "Registration", {});
+  blueprint->SetConnection("Registration", "Result", {});
+  EXPECT_TRUE(blueprint->HasSweeps());
+
+  Blueprint::SweepVariantsType variants;
+  auto expanded = blueprint->ExpandSweeps(variants);
+  EXPECT_FALSE(expanded->HasSweeps());
+  ASSERT_EQ(6, variants.size());
+  EXPECT_EQ("NumberOfIterations-100_Metric-MI", variants[ 0 ].label);
+  EXPECT_EQ("NumberOfIterations-400_Metric-NC", variants[ 5 ].label);
+  EXPECT_EQ(3 + 2 * 6, expanded->GetComponentNames().size());
+
+  for (const auto & variant : variants)
+  {
+    ASSERT_EQ(2, variant.componentNames.size());
+    const std::string registration = variant.componentNames.at("Registration");
+    EXPECT_EQ("Registration_" + variant.label, registration);
+    EXPECT_EQ(1, expanded->GetComponent(registration)["NumberOfIterations"].size());
+    EXPECT_EQ(0, expanded->GetComponent(registration).count("Sweep"));
+    EXPECT_EQ(ParameterMapType({ { "NameOfInterface", { "FixedImageInterface" } } }), expanded->GetConnection("Smoothing", registration));
+    EXPECT_TRUE(expanded->ConnectionExists("Moving", registration));
+    EXPECT_TRUE(expanded->ConnectionExists(registration, variant.componentNames.at("Result")));
+  }
+  EXPECT_EQ(ParameterValueType({ "200" }), expanded->GetComponent("Registration_NumberOfIterations-200_Metric-NC")["NumberOfIterations"]);
+  EXPECT_EQ(ParameterValueType({ "NC" }), expanded->GetComponent("Registration_NumberOfIterations-200_Metric-NC")["Metric"]);
+  EXPECT_EQ(6, expanded->GetOutputNames("Smoothing").size());
+
+  // Without sweeps the blueprint is copied as a single variant
+  blueprint->SetComponent("Registration", { { "NumberOfIterations", { "100" } } });
+  auto copy = blueprint->ExpandSweeps(variants);
+  ASSERT_EQ(1, variants.size());
+  EXPECT_TRUE(variants[ 0 ].componentNames.empty());
+  EXPECT_EQ(blueprint->GetBlueprintImpl().GetCanonicalDescription(), copy->GetBlueprintImpl().GetCanonicalDescription());
+}
@@ -37,11 +37,15 @@ const char * const Dimensionality               = "Dimensionality";
 const char * const PixelType                    = "PixelType";                                // Template POD parameter
 const char * const InternalComputationValueType = "InternalComputationValueType";             // Template POD parameter for transforms or optimizers etc.
 const char * const CoordRepType                = "CoordRepType";
+const char * const Sweep                        = "Sweep";                                    // Blueprint property that lists the parameters of a component that are swept
 
 const char * const SourceInterface                      = "SourceInterface";                      // Special interface that connects to the outside of the SuperElastixFilter
 const char * const SinkInterface                        = "SinkInterface";                        // Special interface that connects to the outside of the SuperElastixFilter
 const char * const RegistrationControllerStartInterface = "RegistrationControllerStartInterface"; //Special interface by which all algorithms are started
 const char * const UpdateInterface = "UpdateInterface"; //Special interface by which any component can be executed in the correct pipeline order.
+const char * const ReleaseDataInterface = "ReleaseDataInterface"; //Special interface by which a component frees its data once all components that use it are updated.
+const char * const CancellationInterface = "CancellationInterface"; //Special interface by which a component stops its update early when the execution is cancelled.
+const char * const NumberOfThreadsInterface = "NumberOfThreadsInterface"; //Special interface by which a component gets its share of the thread budget of the network.
 }
 }
 #endif //selxKeys_h
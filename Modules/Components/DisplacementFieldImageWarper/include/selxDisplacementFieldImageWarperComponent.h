@@ -29,6 +29,9 @@
 
 namespace selx {
 
+// Warps an image by a displacement field. To warp an image by a transform, connect the transform to an ItkResampleFilterComponent
+// rather than to an ItkTransformDisplacementFilterComponent and this warper: it evaluates the transform at each voxel and saves
+// computing and storing a dense displacement field.
 template< int Dimensionality, class TPixel, class CoordRepType >
 class ItkDisplacementFieldImageWarperComponent : public
   SuperElastixComponent<
@@ -82,6 +85,8 @@ public:
 
   // Base methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
+
+  virtual bool CanBeShared() const override { return true; }
   static const char * GetDescription() { return "Warp a point set based on a deformation field"; };
 
 protected:
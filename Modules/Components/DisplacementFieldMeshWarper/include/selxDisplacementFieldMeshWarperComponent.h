@@ -71,6 +71,8 @@ public:
 
   // Base methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
+
+  virtual bool CanBeShared() const override { return true; }
   static const char * GetDescription() { return "Warp a point set based on a deformation field"; };
 
 protected:
@@ -45,7 +45,8 @@ class MonolithicElastixComponent :
   Providing<
   elastixTransformParameterObjectInterface< itk::Image< TPixel, Dimensionality >, itk::Image< TPixel, Dimensionality >>,
   itkImageInterface< Dimensionality, TPixel >,
-  UpdateInterface
+  UpdateInterface,
+  NumberOfThreadsInterface
   >
   >
 {
@@ -65,7 +66,8 @@ public:
     Providing<
     elastixTransformParameterObjectInterface< itk::Image< TPixel, Dimensionality >, itk::Image< TPixel, Dimensionality >>,
     itkImageInterface< Dimensionality, TPixel >,
-    UpdateInterface
+    UpdateInterface,
+    NumberOfThreadsInterface
     >
     >                                     Superclass;
   typedef std::shared_ptr< Self >       Pointer;
@@ -109,6 +111,8 @@ public:
 
   virtual void Update() override;
 
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override;
+
   //Base class methods:
   virtual bool MeetsCriterion( const CriterionType & criterion ) override;
 
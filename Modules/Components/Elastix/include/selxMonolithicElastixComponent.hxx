@@ -20,6 +20,8 @@
 #include "selxMonolithicElastixComponent.h"
 #include "selxCheckTemplateProperties.h"
 
+#include <algorithm>
+
 namespace selx
 {
 template< int Dimensionality, class TPixel >
@@ -115,6 +117,35 @@ MonolithicElastixComponent< Dimensionality, TPixel >::Update( void )
 }
 
 
+template< int Dimensionality, class TPixel >
+void
+MonolithicElastixComponent< Dimensionality, TPixel >::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  // elastix sets up its own threading from the MaximumNumberOfThreads parameter of each registration
+  auto parameterMaps = this->m_elastixFilter->GetParameterObject()->GetParameterMap();
+
+  // A new ParameterObject modifies the elastix filter, which would then register again at the next execution
+  const std::vector< std::string > maximumNumberOfThreads = { std::to_string( numberOfThreads ) };
+  if( this->m_elastixFilter->GetNumberOfThreads() == static_cast< itk::ThreadIdType >( numberOfThreads )
+    && std::all_of( parameterMaps.begin(), parameterMaps.end(), [ &maximumNumberOfThreads ]( const auto & parameterMap ) {
+      auto entry = parameterMap.find( "MaximumNumberOfThreads" );
+      return entry != parameterMap.end() && entry->second == maximumNumberOfThreads;
+    } ) )
+  {
+    return;
+  }
+
+  elxParameterObjectPointer parameterObject = elxParameterObjectType::New();
+  for( auto & parameterMap : parameterMaps )
+  {
+    parameterMap[ "MaximumNumberOfThreads" ] = maximumNumberOfThreads;
+  }
+  parameterObject->SetParameterMap( parameterMaps );
+  this->m_elastixFilter->SetParameterObject( parameterObject );
+  this->m_elastixFilter->SetNumberOfThreads( numberOfThreads );
+}
+
+
 template< int Dimensionality, class TPixel >
 bool
 MonolithicElastixComponent< Dimensionality, TPixel >
@@ -105,6 +105,8 @@ public:
 
   virtual bool MeetsCriterion( const CriterionType & criterion ) override;
 
+  virtual bool CanBeShared() const override { return true; }
+
   static const char * GetDescription() { return "MonolithicTransformix Component"; }
 
 private:
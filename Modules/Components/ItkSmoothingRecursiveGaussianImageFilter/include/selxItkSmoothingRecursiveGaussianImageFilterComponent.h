@@ -68,6 +68,8 @@ public:
   //virtual bool MeetsCriteria(const CriteriaType &criteria);
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
+  virtual bool CanBeShared() const override { return true; }
+
   static const char * GetDescription() { return "ItkSmoothingRecursiveGaussianImageFilter Component"; }
 
 private:
@@ -86,6 +86,9 @@ public:
 
 private:
 
+  // Reads the whole image, which the conversion to a nifti_image requires
+  void UpdateLargestPossibleRegion( void );
+
   typename ItkImageType::Pointer m_Image;
 
 protected:
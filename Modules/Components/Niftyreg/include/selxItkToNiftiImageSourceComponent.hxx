@@ -44,7 +44,7 @@ ItkToNiftiImageSourceComponent< Dimensionality, TPixel >::GetReferenceNiftiImage
     throw std::runtime_error( "SourceComponent needs to be initialized by SetMiniPipelineInput()" );
   }
 
-  this->m_Image->GetSource()->UpdateLargestPossibleRegion();
+  this->UpdateLargestPossibleRegion();
 
   // TODO memory management issue: the Convert function passes the ownership
   // of the data buffer from the itk image to the nifti image. This means that
@@ -65,7 +65,7 @@ ItkToNiftiImageSourceComponent< Dimensionality, TPixel >::GetFloatingNiftiImage(
     throw std::runtime_error( "SourceComponent needs to be initialized by SetMiniPipelineInput()" );
   }
 
-  this->m_Image->GetSource()->UpdateLargestPossibleRegion();
+  this->UpdateLargestPossibleRegion();
 
   // TODO memory management issue: the Convert function passes the ownership
   // of the data buffer from the itk image to the nifti image. This means that
@@ -86,7 +86,7 @@ ItkToNiftiImageSourceComponent< Dimensionality, TPixel >::GetWarpedNiftiImage()
     throw std::runtime_error( "SourceComponent needs to be initialized by SetMiniPipelineInput()" );
   }
 
-  this->m_Image->GetSource()->UpdateLargestPossibleRegion();
+  this->UpdateLargestPossibleRegion();
 
   // TODO memory management issue: the Convert function passes the ownership
   // of the data buffer from the itk image to the nifti image. This means that
@@ -98,6 +98,27 @@ ItkToNiftiImageSourceComponent< Dimensionality, TPixel >::GetWarpedNiftiImage()
 }
 
 
+template< int Dimensionality, class TPixel >
+void
+ItkToNiftiImageSourceComponent< Dimensionality, TPixel >
+::UpdateLargestPossibleRegion()
+{
+  if( this->m_Image->GetSource() == nullptr )
+  {
+    return;
+  }
+
+  // Niftyreg needs the whole image in memory, whereas ITK consumers may stream it
+  const auto largestRegion = this->m_Image->GetLargestPossibleRegion();
+  if( this->m_Image->GetBufferedRegion() != largestRegion )
+  {
+    this->m_Logger.Log( LogLevel::INF, "Source {0} loads the whole image for Niftyreg: {1:.1f} MB.", this->m_Name,
+      largestRegion.GetNumberOfPixels() * sizeof( TPixel ) / ( 1024.0 * 1024.0 ) );
+  }
+  this->m_Image->GetSource()->UpdateLargestPossibleRegion();
+}
+
+
 template< int Dimensionality, class TPixel >
 void
 ItkToNiftiImageSourceComponent< Dimensionality, TPixel >
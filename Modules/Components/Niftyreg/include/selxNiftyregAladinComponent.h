@@ -23,6 +23,7 @@
 #include "selxSuperElastixComponent.h"
 #include "selxInterfaces.h"
 #include "selxNiftyregInterfaces.h"
+#include "selxScopedOpenMPNumberOfThreads.h"
 #include "_reg_aladin.h"
 
 #include <string.h>
@@ -34,7 +35,8 @@ template< class TPixel >
 class NiftyregAladinComponent :
   public SuperElastixComponent<
   Accepting< NiftyregReferenceImageInterface< TPixel >, NiftyregFloatingImageInterface< TPixel >>,
-  Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregAffineMatrixInterface< TPixel >, UpdateInterface >
+  Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregAffineMatrixInterface< TPixel >, UpdateInterface, ReleaseDataInterface, CancellationInterface,
+    NumberOfThreadsInterface >
   >
 {
 public:
@@ -43,7 +45,8 @@ public:
   typedef NiftyregAladinComponent< TPixel > Self;
   typedef SuperElastixComponent<
     Accepting< NiftyregReferenceImageInterface< TPixel >, NiftyregFloatingImageInterface< TPixel >>,
-    Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregAffineMatrixInterface< TPixel >, UpdateInterface >
+    Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregAffineMatrixInterface< TPixel >, UpdateInterface, ReleaseDataInterface, CancellationInterface,
+    NumberOfThreadsInterface >
     >                                      Superclass;
   typedef std::shared_ptr< Self >       Pointer;
   typedef std::shared_ptr< const Self > ConstPointer;
@@ -61,16 +64,31 @@ public:
 
   virtual void Update() override;
 
+  virtual void ReleaseData() override;
+
+  virtual void SetCancellationToken( CancellationToken::ConstPointer cancellationToken ) override;
+
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override;
+
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
   static const char * GetDescription() { return "NiftyregAladin Component"; }
 
 private:
 
+  // NiftyReg progress callback, by which the progress is reported and the registration is aborted with an ExecutionCancelledException
+  // once the token is cancelled
+  static void ProgressCallback( float progress, void * component );
+
   reg_aladin< TPixel > *            m_reg_aladin;
+  typename NiftyregReferenceImageInterface< TPixel >::Pointer m_ReferenceImageInterface;
+  typename NiftyregFloatingImageInterface< TPixel >::Pointer  m_FloatingImageInterface;
   std::shared_ptr< nifti_image > m_reference_image;
   std::shared_ptr< nifti_image > m_floating_image;
   std::shared_ptr< nifti_image > m_warped_image;
+  CancellationToken::ConstPointer m_CancellationToken;
+  // The number of OpenMP threads of Run, 0 for the OpenMP default
+  unsigned int m_NumberOfThreads;
 
 protected:
 
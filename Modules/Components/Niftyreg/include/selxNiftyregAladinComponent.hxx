@@ -23,7 +23,8 @@
 namespace selx
 {
 template< class TPixel >
-NiftyregAladinComponent< TPixel >::NiftyregAladinComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger )
+NiftyregAladinComponent< TPixel >::NiftyregAladinComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger ),
+  m_NumberOfThreads( 0 )
 {
   m_reg_aladin = new reg_aladin< TPixel >();
 }
@@ -41,10 +42,8 @@ int
 NiftyregAladinComponent< TPixel >
 ::Accept(typename NiftyregReferenceImageInterface< TPixel >::Pointer component)
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_reference_image = component->GetReferenceNiftiImage();
-  // connect the itk pipeline
-  this->m_reg_aladin->SetInputReference( this->m_reference_image.get() );
+  // The nifti image is obtained at Update, such that it reflects the current input and can be released afterwards
+  this->m_ReferenceImageInterface = component;
   return 0;
 }
 
@@ -54,10 +53,7 @@ int
 NiftyregAladinComponent< TPixel >
 ::Accept(typename NiftyregFloatingImageInterface< TPixel >::Pointer component)
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_floating_image = component->GetFloatingNiftiImage();
-  // connect the itk pipeline
-  this->m_reg_aladin->SetInputFloating(this->m_floating_image.get());
+  this->m_FloatingImageInterface = component;
   return 0;
 }
 
@@ -83,8 +79,21 @@ void
 NiftyregAladinComponent<  TPixel >
 ::Update()
 {
+  // store the shared_ptr to the data, otherwise it gets freed
+  this->m_reference_image = this->m_ReferenceImageInterface->GetReferenceNiftiImage();
+  this->m_reg_aladin->SetInputReference( this->m_reference_image.get() );
+  this->m_floating_image = this->m_FloatingImageInterface->GetFloatingNiftiImage();
+  this->m_reg_aladin->SetInputFloating( this->m_floating_image.get() );
+
   this->m_Logger.Log(LogLevel::TRC, "Update: run registration");
-  this->m_reg_aladin->Run();
+  // NiftyReg only calls back if the parameters of the callback are not null
+  const bool isObserved = this->m_CancellationToken || this->m_ProgressMonitor;
+  this->m_reg_aladin->SetProgressCallbackFunction( &Self::ProgressCallback, isObserved ? this : nullptr );
+  {
+    // OpenMP parallel regions started from this thread use the share of the thread budget of this component
+    ScopedOpenMPNumberOfThreads openMPNumberOfThreads( this->m_NumberOfThreads );
+    this->m_reg_aladin->Run();
+  }
   nifti_image * outputWarpedImage = m_reg_aladin->GetFinalWarpedImage();
   memset( outputWarpedImage->descrip, 0, 80 );
   strcpy( outputWarpedImage->descrip, "Warped image using NiftyReg (reg_aladin)" );
@@ -95,6 +104,54 @@ NiftyregAladinComponent<  TPixel >
 }
 
 
+template< class TPixel >
+void
+NiftyregAladinComponent<  TPixel >
+::ReleaseData()
+{
+  // The affine matrix is kept in m_reg_aladin, since it is small and still referred to by other components.
+  // The input images are set anew by the next Update.
+  this->m_reference_image = nullptr;
+  this->m_floating_image = nullptr;
+  this->m_warped_image = nullptr;
+}
+
+
+template< class TPixel >
+void
+NiftyregAladinComponent<  TPixel >
+::SetCancellationToken( CancellationToken::ConstPointer cancellationToken )
+{
+  this->m_CancellationToken = cancellationToken;
+}
+
+
+template< class TPixel >
+void
+NiftyregAladinComponent< TPixel >
+::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  this->m_NumberOfThreads = numberOfThreads;
+}
+
+
+template< class TPixel >
+void
+NiftyregAladinComponent<  TPixel >
+::ProgressCallback( float progress, void * component )
+{
+  Self *        self = static_cast< Self * >( component );
+  ProgressEvent progressEvent;
+  progressEvent.stage    = "progress";
+  progressEvent.progress = progress / 100.0;
+  self->ReportProgress( std::move( progressEvent ) );
+  if( self->m_CancellationToken )
+  {
+    self->m_CancellationToken->ThrowIfCancelled();
+  }
+}
+
+
 template< class TPixel >
 bool
 NiftyregAladinComponent<  TPixel >
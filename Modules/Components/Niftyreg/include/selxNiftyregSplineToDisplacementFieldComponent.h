@@ -64,11 +64,13 @@ public:
 
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
+  virtual bool CanBeShared() const override { return true; }
+
   static const char * GetDescription() { return "NiftyregSplineToDisplacementField Component"; }
 
 private:
   typename NiftyregControlPointPositionImageInterface< TPixel >::Pointer m_NiftyregControlPointPositionImageInterface;
-  std::shared_ptr< nifti_image > m_reference_image;
+  typename NiftyregReferenceImageInterface< TPixel >::Pointer m_ReferenceImageInterface;
   std::shared_ptr< nifti_image > m_cpp_image;
   std::shared_ptr< nifti_image > m_displacement_image;
   
@@ -39,8 +39,8 @@ int
 NiftyregSplineToDisplacementFieldComponent< TPixel >
 ::Accept( typename NiftyregReferenceImageInterface< TPixel >::Pointer component )
 {
-  // store the shared_ptr, otherwise the data might get freed
-  this->m_reference_image = component->GetReferenceNiftiImage();
+  // The nifti image is obtained at Update, such that the field has the geometry of the current input
+  this->m_ReferenceImageInterface = component;
   return 0;
 }
 
@@ -70,7 +70,8 @@ NiftyregSplineToDisplacementFieldComponent<  TPixel >
   {
   }
   // Create a field image from the reference image
-  nifti_image * outputTransformationImage = nifti_copy_nim_info(this->m_reference_image.get());
+  std::shared_ptr< nifti_image > referenceImage = this->m_ReferenceImageInterface->GetReferenceNiftiImage();
+  nifti_image * outputTransformationImage = nifti_copy_nim_info(referenceImage.get());
   outputTransformationImage->ndim = outputTransformationImage->dim[0] = 5;
   outputTransformationImage->nt = outputTransformationImage->dim[4] = 1;
   outputTransformationImage->nu = outputTransformationImage->dim[5] = outputTransformationImage->nz > 1 ? 3 : 2;
@@ -23,6 +23,7 @@
 #include "selxSuperElastixComponent.h"
 #include "selxInterfaces.h"
 #include "selxNiftyregInterfaces.h"
+#include "selxScopedOpenMPNumberOfThreads.h"
 #include "_reg_f3d.h"
 
 #include <string.h>
@@ -34,7 +35,8 @@ template< class TPixel >
 class Niftyregf3dComponent :
   public SuperElastixComponent<
   Accepting< NiftyregReferenceImageInterface< TPixel >, NiftyregFloatingImageInterface< TPixel >, NiftyregAffineMatrixInterface< TPixel >>,
-  Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregControlPointPositionImageInterface< TPixel >, UpdateInterface >
+  Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregControlPointPositionImageInterface< TPixel >, UpdateInterface, ReleaseDataInterface, CancellationInterface,
+    NumberOfThreadsInterface >
   >
 {
 public:
@@ -43,7 +45,8 @@ public:
   typedef Niftyregf3dComponent< TPixel > Self;
   typedef SuperElastixComponent<
     Accepting< NiftyregReferenceImageInterface< TPixel >, NiftyregFloatingImageInterface< TPixel >, NiftyregAffineMatrixInterface< TPixel >>,
-    Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregControlPointPositionImageInterface< TPixel >, UpdateInterface >
+    Providing< NiftyregWarpedImageInterface< TPixel >, NiftyregControlPointPositionImageInterface< TPixel >, UpdateInterface, ReleaseDataInterface, CancellationInterface,
+    NumberOfThreadsInterface >
     >                                      Superclass;
   typedef std::shared_ptr< Self >       Pointer;
   typedef std::shared_ptr< const Self > ConstPointer;
@@ -69,6 +72,14 @@ public:
   // Providing UpdateInterface
   virtual void Update() override;
 
+  // Providing ReleaseDataInterface
+  virtual void ReleaseData() override;
+
+  // Providing CancellationInterface
+  virtual void SetCancellationToken( CancellationToken::ConstPointer cancellationToken ) override;
+
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override;
+
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
   virtual bool ConnectionsSatisfied() override;
@@ -77,12 +88,21 @@ public:
 
 private:
 
+  // NiftyReg progress callback, by which the progress is reported and the registration is aborted with an ExecutionCancelledException
+  // once the token is cancelled
+  static void ProgressCallback( float progress, void * component );
+
   reg_f3d< TPixel > *            m_reg_f3d;
+  typename NiftyregReferenceImageInterface< TPixel >::Pointer m_ReferenceImageInterface;
+  typename NiftyregFloatingImageInterface< TPixel >::Pointer  m_FloatingImageInterface;
   std::shared_ptr< nifti_image > m_reference_image;
   std::shared_ptr< nifti_image > m_floating_image;
   // m_warped_images is an array of 2 nifti images. Depending on the use case, typically only [0] is a valid image
   std::unique_ptr< std::array< std::shared_ptr< nifti_image >, 2 >> m_warped_images;
   std::shared_ptr< nifti_image > m_cpp_image;
+  CancellationToken::ConstPointer m_CancellationToken;
+  // The number of OpenMP threads of Run, 0 for the OpenMP default
+  unsigned int m_NumberOfThreads;
   typename NiftyregAffineMatrixInterface< TPixel>::Pointer m_NiftyregAffineMatrixInterface;
 
 protected:
@@ -23,7 +23,8 @@
 namespace selx
 {
 template< class TPixel >
-Niftyregf3dComponent< TPixel >::Niftyregf3dComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger )
+Niftyregf3dComponent< TPixel >::Niftyregf3dComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger ),
+  m_NumberOfThreads( 0 )
 {
   m_reg_f3d = new reg_f3d< TPixel >( 1, 1 );
 }
@@ -41,9 +42,8 @@ int
 Niftyregf3dComponent< TPixel >
 ::Accept( typename NiftyregReferenceImageInterface< TPixel >::Pointer component )
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_reference_image = component->GetReferenceNiftiImage();
-  this->m_reg_f3d->SetReferenceImage( this->m_reference_image.get() );
+  // The nifti image is obtained at Update, such that it reflects the current input and can be released afterwards
+  this->m_ReferenceImageInterface = component;
   return 0;
 }
 
@@ -53,9 +53,7 @@ int
 Niftyregf3dComponent< TPixel >
 ::Accept( typename NiftyregFloatingImageInterface< TPixel >::Pointer component )
 {
-  // store the shared_ptr to the data, otherwise it gets freed
-  this->m_floating_image = component->GetFloatingNiftiImage();
-  this->m_reg_f3d->SetFloatingImage( this->m_floating_image.get() );
+  this->m_FloatingImageInterface = component;
   return 0;
 }
 
@@ -89,6 +87,12 @@ void
 Niftyregf3dComponent< TPixel >
 ::Update()
 {
+  // store the shared_ptr to the data, otherwise it gets freed
+  this->m_reference_image = this->m_ReferenceImageInterface->GetReferenceNiftiImage();
+  this->m_reg_f3d->SetReferenceImage( this->m_reference_image.get() );
+  this->m_floating_image = this->m_FloatingImageInterface->GetFloatingNiftiImage();
+  this->m_reg_f3d->SetFloatingImage( this->m_floating_image.get() );
+
   this->m_Logger.Log(LogLevel::TRC, "Update: run registration");
   //this->m_reg_f3d->UseSSD( 0, true );
   //this->m_reg_f3d->UseCubicSplineInterpolation();
@@ -96,7 +100,14 @@ Niftyregf3dComponent< TPixel >
   {
     this->m_reg_f3d->SetAffineTransformation(this->m_NiftyregAffineMatrixInterface->GetAffineNiftiMatrix());
   }
-  this->m_reg_f3d->Run();
+  // NiftyReg only calls back if the parameters of the callback are not null
+  const bool isObserved = this->m_CancellationToken || this->m_ProgressMonitor;
+  this->m_reg_f3d->SetProgressCallbackFunction( &Self::ProgressCallback, isObserved ? this : nullptr );
+  {
+    // OpenMP parallel regions started from this thread use the share of the thread budget of this component
+    ScopedOpenMPNumberOfThreads openMPNumberOfThreads( this->m_NumberOfThreads );
+    this->m_reg_f3d->Run();
+  }
   nifti_image ** outputWarpedImage = m_reg_f3d->GetWarpedImage();
   memset( outputWarpedImage[ 0 ]->descrip, 0, 80 );
   strcpy( outputWarpedImage[ 0 ]->descrip, "Warped image using NiftyReg (reg_f3d) via SuperElastix" );
@@ -116,6 +127,53 @@ Niftyregf3dComponent< TPixel >
 
 }
 
+template< class TPixel >
+void
+Niftyregf3dComponent< TPixel >
+::ReleaseData()
+{
+  // The input images are set anew by the next Update
+  this->m_reference_image = nullptr;
+  this->m_floating_image = nullptr;
+  this->m_warped_images = nullptr;
+  this->m_cpp_image = nullptr;
+}
+
+template< class TPixel >
+void
+Niftyregf3dComponent< TPixel >
+::SetCancellationToken( CancellationToken::ConstPointer cancellationToken )
+{
+  this->m_CancellationToken = cancellationToken;
+}
+
+
+template< class TPixel >
+void
+Niftyregf3dComponent< TPixel >
+::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  this->m_NumberOfThreads = numberOfThreads;
+}
+
+
+template< class TPixel >
+void
+Niftyregf3dComponent< TPixel >
+::ProgressCallback( float progress, void * component )
+{
+  Self *        self = static_cast< Self * >( component );
+  ProgressEvent progressEvent;
+  progressEvent.stage    = "progress";
+  progressEvent.progress = progress / 100.0;
+  self->ReportProgress( std::move( progressEvent ) );
+  if( self->m_CancellationToken )
+  {
+    self->m_CancellationToken->ThrowIfCancelled();
+  }
+}
+
+
 template< class TPixel >
 bool
 Niftyregf3dComponent< TPixel >
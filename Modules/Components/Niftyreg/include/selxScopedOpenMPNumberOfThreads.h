@@ -0,0 +1,73 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxScopedOpenMPNumberOfThreads_h
+#define selxScopedOpenMPNumberOfThreads_h
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace selx
+{
+/** \class ScopedOpenMPNumberOfThreads
+ * \brief Sets the number of threads of the OpenMP parallel regions that the calling thread starts, for the lifetime of the object
+ *
+ * NiftyReg parallelizes by OpenMP, which has no per-object setting. The OpenMP setting is per thread, so concurrently updated
+ * components do not interfere. A numberOfThreads of 0 keeps the current setting. Without OpenMP this does nothing.
+ */
+class ScopedOpenMPNumberOfThreads
+{
+public:
+
+  explicit ScopedOpenMPNumberOfThreads( unsigned int numberOfThreads ) : m_PreviousNumberOfThreads( 0 )
+  {
+#ifdef _OPENMP
+    if( numberOfThreads > 0 )
+    {
+      this->m_PreviousNumberOfThreads = omp_get_max_threads();
+      omp_set_num_threads( static_cast< int >( numberOfThreads ) );
+    }
+#else
+    (void)numberOfThreads;
+#endif
+  }
+
+
+  ~ScopedOpenMPNumberOfThreads()
+  {
+#ifdef _OPENMP
+    if( this->m_PreviousNumberOfThreads > 0 )
+    {
+      omp_set_num_threads( this->m_PreviousNumberOfThreads );
+    }
+#endif
+  }
+
+
+  ScopedOpenMPNumberOfThreads( const ScopedOpenMPNumberOfThreads & ) = delete;
+  ScopedOpenMPNumberOfThreads & operator=( const ScopedOpenMPNumberOfThreads & ) = delete;
+
+private:
+
+  int m_PreviousNumberOfThreads;
+};
+} // end namespace selx
+
+#endif // selxScopedOpenMPNumberOfThreads_h
@@ -18,6 +18,7 @@
  *=========================================================================*/
 
 #include "selxSuperElastixFilterCustomComponents.h"
+#include "selxSuperElastixBatch.h"
 
 #include "selxNiftyregReadImageComponent.h"
 #include "selxNiftyregWriteImageComponent.h"
@@ -27,6 +28,7 @@
 #include "selxItkImageSourceComponent.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkShrinkImageFilter.h"
 #include "selxNiftyregf3dComponent.h"
 #include "selxNiftyregSplineToDisplacementFieldComponent.h"
 #include "selxDisplacementFieldNiftiToItkImageSinkComponent.h"
@@ -375,5 +377,70 @@ TEST_F(NiftyregComponentTest, AffineAndBSpline)
   EXPECT_NO_THROW(resultImageWriter->Update());
 }
 
+TEST_F( NiftyregComponentTest, BatchOfDifferentGeometries )
+{
+  // The network is connected once, so the displacement field must take the geometry of the fixed image of each item
+  BlueprintPointer blueprint = Blueprint::New();
+
+  blueprint->SetComponent( "RegistrationMethod", { { "NameOfClass", { "Niftyregf3dComponent" } } } );
+  blueprint->SetComponent( "FixedImage", { { "NameOfClass", { "ItkToNiftiImageSourceComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "float" } } } );
+  blueprint->SetComponent( "MovingImage", { { "NameOfClass", { "ItkToNiftiImageSourceComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "float" } } } );
+  blueprint->SetComponent( "TransformToDisplacementField", { { "NameOfClass", { "NiftyregSplineToDisplacementFieldComponent" } }, { "PixelType", { "float" } } } );
+  blueprint->SetComponent( "ResultDisplacementField", { { "NameOfClass", { "DisplacementFieldNiftiToItkImageSinkComponent" } }, { "Dimensionality", { "2" } }, { "PixelType", { "float" } } } );
+
+  blueprint->SetConnection( "FixedImage", "RegistrationMethod", { { "NameOfInterface", { "NiftyregReferenceImageInterface" } } } );
+  blueprint->SetConnection( "MovingImage", "RegistrationMethod", { { "NameOfInterface", { "NiftyregFloatingImageInterface" } } } );
+  blueprint->SetConnection( "RegistrationMethod", "TransformToDisplacementField", { {} } );
+  blueprint->SetConnection( "FixedImage", "TransformToDisplacementField", { {} } );
+  blueprint->SetConnection( "TransformToDisplacementField", "ResultDisplacementField", { {} } );
+  blueprint->SetConnection( "FixedImage", "ResultDisplacementField", { {} } );
+
+  typedef itk::Image< float, 2 >                           Image2DType;
+  typedef itk::ImageFileReader< Image2DType >              ImageReader2DType;
+  typedef itk::ImageFileWriter< Image2DType >              ImageWriter2DType;
+  typedef itk::ShrinkImageFilter< Image2DType, Image2DType > ShrinkFilter2DType;
+  typedef itk::Image< itk::Vector< float, 2 >, 2 >         DisplacementImage2DType;
+  typedef itk::ImageFileReader< DisplacementImage2DType >  DisplacementImageReader2DType;
+
+  // The second item registers the same images at half the size
+  SuperElastixBatch::ItemContainerType items( 2 );
+  for( const std::string name : { "FixedImage", "MovingImage" } )
+  {
+    const std::string fileName = dataManager->GetInputFile( name == "FixedImage" ? "coneA2d64.mhd" : "coneB2d64.mhd" );
+    const std::string shrunkFileName = dataManager->GetOutputFile( "NiftyregBatch_" + name + "32.mhd" );
+    ImageReader2DType::Pointer reader = ImageReader2DType::New();
+    reader->SetFileName( fileName );
+    ShrinkFilter2DType::Pointer shrinkFilter = ShrinkFilter2DType::New();
+    shrinkFilter->SetInput( reader->GetOutput() );
+    shrinkFilter->SetShrinkFactors( 2 );
+    ImageWriter2DType::Pointer writer = ImageWriter2DType::New();
+    writer->SetFileName( shrunkFileName );
+    writer->SetInput( shrinkFilter->GetOutput() );
+    writer->Update();
+
+    items[ 0 ].inputs[ name ] = fileName;
+    items[ 1 ].inputs[ name ] = shrunkFileName;
+  }
+  for( int itemIndex = 0; itemIndex < 2; ++itemIndex )
+  {
+    items[ itemIndex ].outputs[ "ResultDisplacementField" ] = dataManager->GetOutputFile( "NiftyregBatch_Displacement" + std::to_string( itemIndex ) + ".mhd" );
+  }
+
+  SuperElastixBatch batch( [](){ return SuperElastixFilterBase::Pointer( SuperElastixFilterType::New().GetPointer() ); }, blueprint, logger );
+  SuperElastixBatch::ErrorContainerType errors;
+  EXPECT_NO_THROW( errors = batch.Execute( items ) );
+  ASSERT_EQ( errors, SuperElastixBatch::ErrorContainerType( 2 ) );
+
+  for( int itemIndex = 0; itemIndex < 2; ++itemIndex )
+  {
+    ImageReader2DType::Pointer fixedImageReader = ImageReader2DType::New();
+    fixedImageReader->SetFileName( items[ itemIndex ].inputs[ "FixedImage" ] );
+    fixedImageReader->UpdateOutputInformation();
+    DisplacementImageReader2DType::Pointer displacementReader = DisplacementImageReader2DType::New();
+    displacementReader->SetFileName( items[ itemIndex ].outputs[ "ResultDisplacementField" ] );
+    displacementReader->UpdateOutputInformation();
+    EXPECT_EQ( displacementReader->GetOutput()->GetLargestPossibleRegion().GetSize(), fixedImageReader->GetOutput()->GetLargestPossibleRegion().GetSize() );
+  }
+}
 
 }
@@ -0,0 +1,56 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxDeferImageRead_h
+#define selxDeferImageRead_h
+
+#include "selxLoggerImpl.h"
+#include "itkNumericTraits.h"
+
+namespace selx
+{
+/** Requests an empty region of the image of a Source Component, such that the SuperElastixFilter does not read it when
+ * it updates its inputs. The consumers of the image read the regions they request when the network executes: a
+ * streaming consumer reads it piecewise and a consumer that needs the whole image reads it entirely. The image is
+ * passed to the Source by the SuperElastixFilter, which requests the same region of its input: an input in memory,
+ * without a pipeline upstream, keeps its buffer regardless.
+ */
+template< class TImage >
+void
+DeferImageRead( TImage * image, const std::string & name, LoggerImpl & logger )
+{
+  if( image == nullptr )
+  {
+    return;
+  }
+
+  typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  const double megabytes = static_cast< double >( region.GetNumberOfPixels() ) * image->GetNumberOfComponentsPerPixel()
+    * sizeof( typename itk::NumericTraits< typename TImage::PixelType >::ValueType ) / ( 1024.0 * 1024.0 );
+
+  typename TImage::SizeType emptySize;
+  emptySize.Fill( 0 );
+  region.SetSize( emptySize );
+  image->SetRequestedRegion( region );
+
+  logger.Log( LogLevel::DBG, "Source {0} reads the regions requested by its consumers, at most {1:.1f} MB.", name, megabytes );
+}
+} // end namespace selx
+
+#endif // selxDeferImageRead_h
@@ -28,6 +28,7 @@
 #include "itkImageFileReader.h"
 #include "selxAnyFileReader.h"
 #include "selxFileReaderDecorator.h"
+#include "selxDeferImageRead.h"
 
 namespace selx
 {
@@ -67,6 +68,7 @@ public:
   // Source interface
   virtual void SetMiniPipelineInput( itk::DataObject::Pointer ) override;
   virtual AnyFileReader::Pointer GetInputFileReader( void ) override;
+  virtual void DeferMiniPipelineInputRead( void ) override;
 
   // Providing interfaces
   virtual ItkImageDomainPointer GetItkImageDomainFixed() override;
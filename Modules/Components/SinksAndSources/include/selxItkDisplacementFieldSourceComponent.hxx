@@ -76,6 +76,15 @@ ItkDisplacementFieldSourceComponent< Dimensionality, TPixel >
 }
 
 
+template< int Dimensionality, class TPixel >
+void
+ItkDisplacementFieldSourceComponent< Dimensionality, TPixel >
+::DeferMiniPipelineInputRead()
+{
+  DeferImageRead( this->m_DisplacementField.GetPointer(), this->m_Name, this->m_Logger );
+}
+
+
 template< int Dimensionality, class TPixel>
 typename AnyFileReader::Pointer
 ItkDisplacementFieldSourceComponent< Dimensionality, TPixel >::GetInputFileReader()
@@ -28,6 +28,8 @@
 #include "itkImageFileReader.h"
 #include "selxAnyFileReader.h"
 #include "selxFileReaderDecorator.h"
+#include "selxMemoryMappedImageFileReader.h"
+#include "selxDeferImageRead.h"
 namespace selx
 {
 template< int Dimensionality, class TPixel >
@@ -67,7 +69,10 @@ public:
   typedef typename itkImageDomainFixedInterface< Dimensionality >::ItkImageDomainType ItkImageDomainType;
 
   typedef typename itk::ImageFileReader< ItkImageType > ItkImageReaderType;
-  typedef FileReaderDecorator< ItkImageReaderType >     DecoratedReaderType;
+
+  // Uncompressed files with pixels of type TPixel are memory mapped, others are read by the ItkImageReaderType
+  typedef MemoryMappedImageFileReader< ItkImageType >  MemoryMappedReaderType;
+  typedef FileReaderDecorator< MemoryMappedReaderType > DecoratedReaderType;
 
   // providing interfaces
   virtual typename ItkImageType::Pointer GetItkImage() override;
@@ -84,6 +89,7 @@ public:
 
   virtual void SetMiniPipelineInput( itk::DataObject::Pointer ) override;
   virtual AnyFileReader::Pointer GetInputFileReader( void ) override;
+  virtual void DeferMiniPipelineInputRead( void ) override;
 
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
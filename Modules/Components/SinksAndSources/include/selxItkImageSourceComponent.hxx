@@ -126,6 +126,15 @@ ItkImageSourceComponent< Dimensionality, TPixel >
 }
 
 
+template< int Dimensionality, class TPixel >
+void
+ItkImageSourceComponent< Dimensionality, TPixel >
+::DeferMiniPipelineInputRead()
+{
+  DeferImageRead( this->m_Image.GetPointer(), this->m_Name, this->m_Logger );
+}
+
+
 template< int Dimensionality, class TPixel >
 typename AnyFileReader::Pointer
 ItkImageSourceComponent< Dimensionality, TPixel >::GetInputFileReader()
@@ -76,6 +76,15 @@ ItkVectorImageSourceComponent< Dimensionality, TPixel >
 }
 
 
+template< int Dimensionality, class TPixel >
+void
+ItkVectorImageSourceComponent< Dimensionality, TPixel >
+::DeferMiniPipelineInputRead()
+{
+  DeferImageRead( this->m_VectorImage.GetPointer(), this->m_Name, this->m_Logger );
+}
+
+
 template< int Dimensionality, class TPixel>
 typename AnyFileReader::Pointer
 ItkVectorImageSourceComponent< Dimensionality, TPixel >::GetInputFileReader()
@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxItkCancellationCommand_h
+#define selxItkCancellationCommand_h
+
+#include "selxCancellationToken.h"
+
+#include "itkCommand.h"
+
+#include <functional>
+
+namespace selx
+{
+/** \class ItkCancellationCommand
+ * \brief Observer that calls a stop function, e.g. StopOptimization of an optimizer, once the execution is cancelled
+ *
+ * Intended for the IterationEvent of an optimizer or registration method, such that it polls the CancellationToken
+ * once per iteration.
+ */
+class ItkCancellationCommand : public itk::Command
+{
+public:
+
+  typedef ItkCancellationCommand    Self;
+  typedef itk::Command              Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+  itkNewMacro( Self );
+
+  typedef std::function< void ( void ) > StopFunctionType;
+
+  void SetCancellationToken( CancellationToken::ConstPointer cancellationToken ) { this->m_CancellationToken = cancellationToken; }
+
+  void SetStopFunction( StopFunctionType stopFunction ) { this->m_StopFunction = stopFunction; }
+
+  virtual void Execute( itk::Object * caller, const itk::EventObject & event ) ITK_OVERRIDE
+  {
+    Execute( (const itk::Object *)caller, event );
+  }
+
+
+  virtual void Execute( const itk::Object *, const itk::EventObject & ) ITK_OVERRIDE
+  {
+    if( this->m_CancellationToken && this->m_CancellationToken->IsCancelled() && this->m_StopFunction )
+    {
+      this->m_StopFunction();
+    }
+  }
+
+protected:
+
+  ItkCancellationCommand() {}
+
+private:
+
+  CancellationToken::ConstPointer m_CancellationToken;
+  StopFunctionType                m_StopFunction;
+};
+} // end namespace selx
+
+#endif // selxItkCancellationCommand_h
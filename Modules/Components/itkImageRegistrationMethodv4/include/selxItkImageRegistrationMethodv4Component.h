@@ -47,7 +47,9 @@ class ItkImageRegistrationMethodv4Component :
   >,
   Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
   MultiStageTransformInterface< InternalComputationValueType, Dimensionality >,
-  UpdateInterface
+  UpdateInterface,
+  CancellationInterface,
+  NumberOfThreadsInterface
   >
   >
 {
@@ -68,7 +70,9 @@ public:
     >,
     Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
     MultiStageTransformInterface< InternalComputationValueType, Dimensionality >,
-    UpdateInterface
+    UpdateInterface,
+    CancellationInterface,
+    NumberOfThreadsInterface
     >
     >                                     Superclass;
   typedef std::shared_ptr< Self >       Pointer;
@@ -110,6 +114,10 @@ public:
 
   virtual void Update() override;
 
+  virtual void SetCancellationToken( CancellationToken::ConstPointer cancellationToken ) override;
+
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override;
+
   virtual void SetFixedInitialTransform( typename CompositeTransformType::Pointer fixedInitialTransform ) override;
 
   virtual void SetMovingInitialTransform( typename CompositeTransformType::Pointer movingInitialTransform ) override;
@@ -133,6 +141,8 @@ private:
   std::string m_NumberOfLevelsLastSetBy;
   typename TransformParametersAdaptorsContainerInterfaceType::Pointer m_TransformAdaptorsContainerInterface;
 
+  CancellationToken::ConstPointer m_CancellationToken;
+
 protected:
 
   // return the class name and the template arguments to uniquely identify this component.
@@ -18,6 +18,7 @@
  *=========================================================================*/
 
 #include "selxItkImageRegistrationMethodv4Component.h"
+#include "selxItkCancellationCommand.h"
 
 //TODO: get rid of these
 #include "itkMeanSquaresImageToImageMetricv4.h"
@@ -27,6 +28,12 @@
 #include "selxCheckTemplateProperties.h"
 namespace selx
 {
+/** \class CommandIterationUpdate
+ * \brief Publishes the progress of an itk registration method to the ProgressMonitor of its component
+ *
+ * Observe the IterationEvent of the registration method for the start of each level (and for each iteration of
+ * methods that iterate themselves, such as SyN), and the IterationEvent of its optimizer for each iteration.
+ */
 template< typename TFilter >
 class CommandIterationUpdate : public itk::Command
 {
@@ -37,12 +44,15 @@ public:
   typedef itk::SmartPointer< Self > Pointer;
   itkNewMacro( Self );
 
-  typedef itk::GradientDescentOptimizerv4 OptimizerType;
-  typedef   const OptimizerType *         OptimizerPointer;
+  typedef typename TFilter::OptimizerType                                              OptimizerType;
+  typedef itk::GradientDescentOptimizerBasev4Template< typename TFilter::RealType > GradientDescentOptimizerType;
+
+  /** The component that reports the progress */
+  void SetComponent( ComponentBase * component ) { this->m_Component = component; }
 
 protected:
 
-  CommandIterationUpdate() {}
+  CommandIterationUpdate() : m_Component( nullptr ), m_CurrentLevel( 0 ) {}
 
 public:
 
@@ -54,59 +64,51 @@ public:
 
   virtual void Execute( const itk::Object * object, const itk::EventObject & event ) ITK_OVERRIDE
   {
-    const TFilter * filter = static_cast< const TFilter * >( object );
-    if( typeid( event ) == typeid( itk::MultiResolutionIterationEvent ) )
+    if( !( itk::IterationEvent().CheckEvent( &event ) ) || this->m_Component == nullptr || this->m_Component->m_ProgressMonitor == nullptr )
     {
-      unsigned int currentLevel = filter->GetCurrentLevel();
-      typename TFilter::ShrinkFactorsPerDimensionContainerType shrinkFactors = filter->GetShrinkFactorsPerDimension( currentLevel );
-      typename TFilter::SmoothingSigmasArrayType smoothingSigmas             = filter->GetSmoothingSigmasPerLevel();
-      typename TFilter::TransformParametersAdaptorsContainerType adaptors    = filter->GetTransformParametersAdaptorsPerLevel();
-
-      // TODO optimizer is can be ObjectToObjectOptimizerBaseTemplate<double> or ObjectToObjectOptimizerBaseTemplate<float>
-      // dynamic cast will fail on <float>, since GradientDescentOptimizerv4Type is by default <double>
-      auto * optimizerBase = filter->GetOptimizer();
-      typedef itk::GradientDescentOptimizerv4 GradientDescentOptimizerv4Type;
-      typename GradientDescentOptimizerv4Type::ConstPointer optimizer = dynamic_cast< const GradientDescentOptimizerv4Type * >( optimizerBase );
-      if( !optimizer )
-      {
-        itkGenericExceptionMacro( "Error dynamic_cast failed" );
-      }
-      typename GradientDescentOptimizerv4Type::DerivativeType gradient = optimizer->GetGradient();
-
-      //debug:
-      std::cout << "  CL Current level:           " << currentLevel << std::endl;
-      std::cout << "   SF Shrink factor:          " << shrinkFactors << std::endl;
-      std::cout << "   SS Smoothing sigma:        " << smoothingSigmas[ currentLevel ] << std::endl;
-      //std::cout << "   RFP Required fixed params: " << adaptors[ currentLevel ]->GetRequiredFixedParameters() << std::endl;
-      std::cout << "   LR Final learning rate:    " << optimizer->GetLearningRate() << std::endl;
-      std::cout << "   FM Final metric value:     " << optimizer->GetCurrentMetricValue() << std::endl;
-      std::cout << "   SC Optimizer scales:       " << optimizer->GetScales() << std::endl;
-      std::cout << "   FG Final metric gradient (sample of values): ";
-      if( gradient.GetSize() < 16 )
+      return;
+    }
+
+    ProgressEvent progressEvent;
+    if( const TFilter * filter = dynamic_cast< const TFilter * >( object ) )
+    {
+      if( typeid( event ) == typeid( itk::MultiResolutionIterationEvent ) )
       {
-        std::cout << gradient;
+        this->m_CurrentLevel = filter->GetCurrentLevel();
+        this->m_Component->Trace( "Starting level {0} with smoothing sigma {1}", this->m_CurrentLevel,
+          filter->GetSmoothingSigmasPerLevel()[ this->m_CurrentLevel ] );
+        progressEvent.stage = "level";
       }
       else
       {
-        for( itk::SizeValueType i = 0; i < gradient.GetSize(); i += ( gradient.GetSize() / 16 ) )
-        {
-          std::cout << gradient[ i ] << " ";
-        }
+        // The method iterates itself and keeps track of its metric value
+        progressEvent.stage       = "iteration";
+        progressEvent.iteration   = filter->GetCurrentIteration();
+        progressEvent.metricValue = filter->GetCurrentMetricValue();
       }
-      std::cout << std::endl;
     }
-    else if( !( itk::IterationEvent().CheckEvent( &event ) ) )
+    else if( const OptimizerType * optimizer = dynamic_cast< const OptimizerType * >( object ) )
     {
-      return;
+      progressEvent.stage       = "iteration";
+      progressEvent.iteration   = optimizer->GetCurrentIteration();
+      progressEvent.metricValue = optimizer->GetCurrentMetricValue();
+      if( const GradientDescentOptimizerType * gradientDescentOptimizer = dynamic_cast< const GradientDescentOptimizerType * >( optimizer ) )
+      {
+        progressEvent.gradientNorm = gradientDescentOptimizer->GetGradient().magnitude();
+      }
     }
     else
     {
-      // OptimizerPointer optimizer = static_cast< OptimizerPointer >( object );
-      //std::cout << optimizer->GetCurrentIteration() << ": ";
-      //std::cout << optimizer->GetCurrentMetricValue() << std::endl;
-      //std::cout << optimizer->GetInfinityNormOfProjectedGradient() << std::endl;
+      return;
     }
+    progressEvent.level = this->m_CurrentLevel;
+    this->m_Component->ReportProgress( std::move( progressEvent ) );
   }
+
+private:
+
+  ComponentBase * m_Component;
+  unsigned int    m_CurrentLevel;
 };
 
 template< int Dimensionality, class TPixel, class InternalComputationValueType >
@@ -251,10 +253,64 @@ ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputati
 
   typedef CommandIterationUpdate< TheItkFilterType > RegistrationCommandType;
   typename RegistrationCommandType::Pointer registrationObserver = RegistrationCommandType::New();
-  this->m_theItkFilter->AddObserver( itk::IterationEvent(), registrationObserver );
+  registrationObserver->SetComponent( this );
+  const unsigned long registrationObserverTag = this->m_theItkFilter->AddObserver( itk::IterationEvent(), registrationObserver );
+  const unsigned long optimizerObserverTag    = optimizer->AddObserver( itk::IterationEvent(), registrationObserver );
+
+  // Once the execution is cancelled, the optimizer stops at its next iteration and the optimizations of the remaining levels
+  // stop at their first iteration. The transform is then the result of the interrupted registration.
+  typedef itk::GradientDescentOptimizerBasev4Template< InternalComputationValueType > GradientDescentOptimizerBasev4Type;
+  auto          gradientDescentOptimizer = dynamic_cast< GradientDescentOptimizerBasev4Type * >( optimizer );
+  unsigned long cancellationObserverTag  = 0;
+  if( this->m_CancellationToken && gradientDescentOptimizer )
+  {
+    ItkCancellationCommand::Pointer cancellationObserver = ItkCancellationCommand::New();
+    cancellationObserver->SetCancellationToken( this->m_CancellationToken );
+    cancellationObserver->SetStopFunction( [ gradientDescentOptimizer ](){ gradientDescentOptimizer->StopOptimization(); } );
+    cancellationObserverTag = gradientDescentOptimizer->AddObserver( itk::IterationEvent(), cancellationObserver );
+  }
+
+  // The observers are removed afterwards, such that a re-execution of the network does not observe twice
+  auto removeObservers = [ & ](){
+      this->m_theItkFilter->RemoveObserver( registrationObserverTag );
+      optimizer->RemoveObserver( optimizerObserverTag );
+      if( this->m_CancellationToken && gradientDescentOptimizer )
+      {
+        gradientDescentOptimizer->RemoveObserver( cancellationObserverTag );
+      }
+    };
 
   // perform the actual registration
-  this->m_theItkFilter->Update();
+  try
+  {
+    this->m_theItkFilter->Update();
+  }
+  catch( ... )
+  {
+    removeObservers();
+    throw;
+  }
+  removeObservers();
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >
+::SetCancellationToken( CancellationToken::ConstPointer cancellationToken )
+{
+  this->m_CancellationToken = cancellationToken;
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkImageRegistrationMethodv4Component< Dimensionality, TPixel, InternalComputationValueType >
+::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  // The optimizer passes its number of threads on to the metric when it starts
+  this->m_theItkFilter->SetNumberOfThreads( numberOfThreads );
+  this->m_theItkFilter->GetModifiableOptimizer()->SetNumberOfThreads( numberOfThreads );
 }
 
 
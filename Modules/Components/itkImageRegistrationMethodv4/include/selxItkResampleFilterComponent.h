@@ -32,6 +32,7 @@
 #include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkGaussianExponentialDiffeomorphicTransform.h"
 #include "itkGaussianExponentialDiffeomorphicTransformParametersAdaptor.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
 
 namespace selx
 {
@@ -43,7 +44,8 @@ class ItkResampleFilterComponent :
   itkImageMovingInterface< Dimensionality, TPixel >
   >,
   Providing< itkImageInterface< Dimensionality, TPixel >,
-  UpdateInterface
+  UpdateInterface,
+  NumberOfThreadsInterface
   >
   >
 {
@@ -59,7 +61,8 @@ public:
     itkImageMovingInterface< Dimensionality, TPixel >
     >,
     Providing< itkImageInterface< Dimensionality, TPixel >,
-    UpdateInterface
+    UpdateInterface,
+    NumberOfThreadsInterface
     >
     >                                     Superclass;
   typedef std::shared_ptr< Self >       Pointer;
@@ -77,6 +80,9 @@ public:
 
   typedef itk::ResampleImageFilter< MovingImageType, ResultImageType > ResampleFilterType;
 
+  typedef itk::NearestNeighborInterpolateImageFunction< MovingImageType, typename ResampleFilterType::InterpolatorType::CoordRepType >
+    NearestNeighborInterpolatorType;
+
   //Accepting Interfaces:
   virtual int Accept( typename itkImageDomainFixedInterface< Dimensionality >::Pointer ) override;
 
@@ -89,9 +95,13 @@ public:
 
   virtual void Update() override;
 
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override;
+
   //BaseClass methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
+  virtual bool CanBeShared() const override { return true; }
+
   //static const char * GetName() { return "ItkResampleFilter"; } ;
   static const char * GetDescription() { return "ItkResampleFilter Component"; }
 
@@ -104,6 +104,15 @@ ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
 }
 
 
+template< int Dimensionality, class TPixel, class TInternalComputationValue >
+void
+ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
+::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  this->m_ResampleFilter->SetNumberOfThreads( numberOfThreads );
+}
+
+
 template< int Dimensionality, class TPixel, class TInternalComputationValue >
 bool
 ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
@@ -120,6 +129,21 @@ ItkResampleFilterComponent< Dimensionality, TPixel, TInternalComputationValue >
   {
     return false;
   } // else: CriterionStatus::Unknown
+
+  else if( criterion.first == "Interpolator" && criterion.second.size() == 1 )
+  {
+    // Like the ItkDisplacementFieldImageWarperComponent, such that it can replace a warper that is connected to a displacement field
+    // of a transform: this resampler evaluates the transform at each output voxel and the dense field is never computed.
+    if( criterion.second[ 0 ] == "NearestNeighbor" )
+    {
+      this->m_ResampleFilter->SetInterpolator( NearestNeighborInterpolatorType::New() );
+      return true;
+    }
+    else if( criterion.second[ 0 ] == "Linear" )
+    {
+      return true;
+    }
+  }
   return meetsCriteria;
 }
 } //end namespace selx
@@ -87,6 +87,8 @@ public:
   //BaseClass methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
+  virtual bool CanBeShared() const override { return true; }
+
   //static const char * GetName() { return "ItkTransformDisplacementFilterComponent"; } ;
   static const char * GetDescription() { return "ItkTransformDisplacementFilter Component"; }
 
@@ -44,7 +44,10 @@ class ItkSyNImageRegistrationMethodComponent :
   itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >
   >,
   Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
-  UpdateInterface
+  UpdateInterface,
+  ReleaseDataInterface,
+  CancellationInterface,
+  NumberOfThreadsInterface
   >
   >
 {
@@ -61,7 +64,10 @@ public:
     itkMetricv4Interface< Dimensionality, PixelType, InternalComputationValueType >
     >,
     Providing< itkTransformInterface< InternalComputationValueType, Dimensionality >,
-    UpdateInterface
+    UpdateInterface,
+    ReleaseDataInterface,
+    CancellationInterface,
+    NumberOfThreadsInterface
     >
     >                                     Superclass;
   typedef std::shared_ptr< Self >       Pointer;
@@ -94,6 +100,12 @@ public:
 
   virtual void Update() override;
 
+  virtual void ReleaseData() override;
+
+  virtual void SetCancellationToken( CancellationToken::ConstPointer cancellationToken ) override;
+
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override;
+
   //BaseClass methods
   virtual bool MeetsCriterion( const ComponentBase::CriterionType & criterion ) override;
 
@@ -104,6 +116,8 @@ private:
 
   typename TheItkFilterType::Pointer m_theItkFilter;
 
+  CancellationToken::ConstPointer m_CancellationToken;
+
 protected:
 
   // return the class name and the template arguments to uniquely identify this component.
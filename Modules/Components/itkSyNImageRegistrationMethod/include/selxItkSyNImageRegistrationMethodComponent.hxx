@@ -19,6 +19,7 @@
 
 #include "selxItkSyNImageRegistrationMethodComponent.h"
 #include "selxItkImageRegistrationMethodv4Component.h"
+#include "selxItkCancellationCommand.h"
 
 #include "itkDisplacementFieldTransformParametersAdaptor.h"
 //TODO: get rid of these
@@ -202,10 +203,81 @@ ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputat
 
   typedef CommandIterationUpdate< TheItkFilterType > RegistrationCommandType;
   typename RegistrationCommandType::Pointer registrationObserver = RegistrationCommandType::New();
-  this->m_theItkFilter->AddObserver( itk::IterationEvent(), registrationObserver );
+  registrationObserver->SetComponent( this );
+  const unsigned long registrationObserverTag = this->m_theItkFilter->AddObserver( itk::IterationEvent(), registrationObserver );
+
+  // SyN has no optimizer to stop. Once the execution is cancelled, the remaining iterations of the current and the next levels
+  // are set to zero, such that the displacement fields are the result of the interrupted registration.
+  const auto    numberOfIterationsPerLevel = this->m_theItkFilter->GetNumberOfIterationsPerLevel();
+  unsigned long cancellationObserverTag    = 0;
+  if( this->m_CancellationToken )
+  {
+    auto                            filter               = this->m_theItkFilter.GetPointer();
+    ItkCancellationCommand::Pointer cancellationObserver = ItkCancellationCommand::New();
+    cancellationObserver->SetCancellationToken( this->m_CancellationToken );
+    cancellationObserver->SetStopFunction( [ filter, numberOfIterationsPerLevel ](){
+        auto noIterations = numberOfIterationsPerLevel;
+        noIterations.Fill( 0 );
+        filter->SetNumberOfIterationsPerLevel( noIterations );
+      } );
+    cancellationObserverTag = this->m_theItkFilter->AddObserver( itk::IterationEvent(), cancellationObserver );
+  }
 
   // perform the actual registration
-  this->m_theItkFilter->Update();
+  try
+  {
+    this->m_theItkFilter->Update();
+  }
+  catch( ... )
+  {
+    this->m_theItkFilter->RemoveObserver( registrationObserverTag );
+    if( this->m_CancellationToken )
+    {
+      this->m_theItkFilter->RemoveObserver( cancellationObserverTag );
+      this->m_theItkFilter->SetNumberOfIterationsPerLevel( numberOfIterationsPerLevel );
+    }
+    throw;
+  }
+  this->m_theItkFilter->RemoveObserver( registrationObserverTag );
+  if( this->m_CancellationToken )
+  {
+    this->m_theItkFilter->RemoveObserver( cancellationObserverTag );
+    this->m_theItkFilter->SetNumberOfIterationsPerLevel( numberOfIterationsPerLevel );
+  }
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >
+::SetCancellationToken( CancellationToken::ConstPointer cancellationToken )
+{
+  this->m_CancellationToken = cancellationToken;
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >
+::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  // SyN evaluates the metric itself, without an optimizer
+  this->m_theItkFilter->SetNumberOfThreads( numberOfThreads );
+  if( auto metric = dynamic_cast< ImageMetricType * >( this->m_theItkFilter->GetModifiableMetric() ) )
+  {
+    metric->SetMaximumNumberOfThreads( numberOfThreads );
+  }
+}
+
+
+template< int Dimensionality, class TPixel, class InternalComputationValueType >
+void
+ItkSyNImageRegistrationMethodComponent< Dimensionality, TPixel, InternalComputationValueType >::ReleaseData( void )
+{
+  // The fixed and moving to middle transforms each hold a forward and an inverse displacement field. They are only needed
+  // during the optimization; without them, a next Update starts from scratch instead of restoring the state of this one.
+  this->m_theItkFilter->SetFixedToMiddleTransform( nullptr );
+  this->m_theItkFilter->SetMovingToMiddleTransform( nullptr );
 }
 
 
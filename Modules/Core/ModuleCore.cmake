@@ -25,7 +25,11 @@ set( ${MODULE}_INCLUDE_DIRS
 set( ${MODULE}_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/src/selxComponentBase.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxCheckTemplateProperties.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxCompiledNetwork.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxInterfaceCompatibilityCache.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxNetworkContainer.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxProfiler.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxProgressMonitor.cxx
 )
 
 # Export tests
@@ -33,6 +37,9 @@ set( ${MODULE}_TEST_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/test/selxComponentSelectorTest.cxx
   ${${MODULE}_SOURCE_DIR}/test/selxComponentInterfaceTest.cxx
   ${${MODULE}_SOURCE_DIR}/test/selxNetworkBuilderTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxNetworkContainerTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxProfilerTest.cxx
+  ${${MODULE}_SOURCE_DIR}/test/selxProgressMonitorTest.cxx
 )
 
 set( ${MODULE}_LIBRARIES
@@ -49,6 +49,13 @@ public:
   }
 
 
+  template< typename ProviderType >
+  static InterfaceStatus CanAcceptConnectionFromProvider( const ProviderType &, const ComponentBase::InterfaceCriteriaType & )
+  {
+    return InterfaceStatus::noaccepter;
+  }
+
+
   //Empty RestInterfaces does 0 successful connects ;
   int ConnectFromImpl( ComponentBase::Pointer ) { return 0; }
 
@@ -76,6 +83,11 @@ public:
 
   InterfaceStatus CanAcceptConnectionFrom( ComponentBase::ConstPointer other, const ComponentBase::InterfaceCriteriaType interfaceCriteria );
 
+  // Type level version of CanAcceptConnectionFrom that does not require an instantiated accepting component. The provider
+  // can be a ComponentBase or a ComponentPrototypeBase, since both can tell by IsProviding() which interfaces they provide.
+  template< typename ProviderType >
+  static InterfaceStatus CanAcceptConnectionFromProvider( const ProviderType & provider, const ComponentBase::InterfaceCriteriaType & interfaceCriteria );
+
   int ConnectFromImpl( ComponentBase::Pointer );
 
   // Helper function by which a component can check if all its Accepting interfaces have been set after the handshakes
@@ -23,6 +23,8 @@
 #include "selxLogger.h"
 #include "selxCount.h"
 
+#include <typeindex>
+
 namespace selx
 {
 
@@ -115,6 +117,38 @@ Accepting< FirstInterface, RestInterfaces ... >::CanAcceptConnectionFrom( Compon
 }
 
 
+template< typename FirstInterface, typename ... RestInterfaces >
+template< typename ProviderType >
+InterfaceStatus
+Accepting< FirstInterface, RestInterfaces ... >::CanAcceptConnectionFromProvider( const ProviderType & provider,
+  const ComponentBase::InterfaceCriteriaType & interfaceCriteria )
+{
+  // Same status logic as CanAcceptConnectionFrom, but the dynamic_cast of the provider is replaced by a lookup of the interface type.
+  InterfaceStatus restInterfacesStatus = Accepting< RestInterfaces ... >::CanAcceptConnectionFromProvider( provider, interfaceCriteria );
+  if( restInterfacesStatus == InterfaceStatus::multiple )
+  {
+    return InterfaceStatus::multiple;
+  }
+  if( Count< FirstInterface >::MeetsCriteria( interfaceCriteria ) == 0 )
+  {
+    return restInterfacesStatus;
+  }
+  if( provider.IsProviding( std::type_index( typeid( FirstInterface ) ) ) )
+  {
+    if( restInterfacesStatus == InterfaceStatus::success )
+    {
+      return InterfaceStatus::multiple;
+    }
+    return InterfaceStatus::success;
+  }
+  if( restInterfacesStatus == InterfaceStatus::noaccepter )
+  {
+    return InterfaceStatus::noprovider;
+  }
+  return restInterfacesStatus;
+}
+
+
 template< typename FirstInterface, typename ... RestInterfaces >
 unsigned int
 Accepting< FirstInterface, RestInterfaces ... >::CountMeetsCriteria( const ComponentBase::InterfaceCriteriaType interfaceCriteria )
@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxCancellationToken_h
+#define selxCancellationToken_h
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace selx
+{
+/** Thrown when the execution of a network stops because its CancellationToken is cancelled or its deadline has passed */
+class ExecutionCancelledException : public std::runtime_error
+{
+public:
+
+  explicit ExecutionCancelledException( const std::string & message ) : std::runtime_error( message ) {}
+};
+
+/** \class CancellationToken
+ * \brief Cooperative cancellation of the execution of a network, by request or at a wall clock deadline
+ *
+ * The NetworkContainer does not start new component updates once the token is cancelled. Components that provide the
+ * CancellationInterface also poll the token during their update, e.g. from an iteration observer, and stop their optimization
+ * early. The token may be cancelled from any thread.
+ */
+class CancellationToken
+{
+public:
+
+  typedef std::shared_ptr< CancellationToken >       Pointer;
+  typedef std::shared_ptr< const CancellationToken > ConstPointer;
+  typedef std::chrono::steady_clock                  ClockType;
+
+  CancellationToken() : m_Cancelled( false ), m_Deadline( NoDeadline() ) {}
+
+  void Cancel() { this->m_Cancelled = true; }
+
+  /** Cancel automatically at the deadline */
+  void SetDeadline( ClockType::time_point deadline ) { this->m_Deadline = deadline.time_since_epoch().count(); }
+
+  /** Cancel automatically the given number of seconds from now */
+  void SetTimeout( double seconds )
+  {
+    this->SetDeadline( ClockType::now() + std::chrono::duration_cast< ClockType::duration >( std::chrono::duration< double >( seconds ) ) );
+  }
+
+  bool HasDeadline() const { return this->m_Deadline != NoDeadline(); }
+
+  bool IsCancelled() const
+  {
+    return this->m_Cancelled || ( this->HasDeadline() && ClockType::now().time_since_epoch().count() >= this->m_Deadline );
+  }
+
+  void ThrowIfCancelled() const
+  {
+    if( this->IsCancelled() )
+    {
+      throw ExecutionCancelledException( this->m_Cancelled ? "Execution cancelled" : "Execution cancelled: deadline exceeded" );
+    }
+  }
+
+private:
+
+  static ClockType::rep NoDeadline() { return ClockType::duration::max().count(); }
+
+  std::atomic< bool >           m_Cancelled;
+  std::atomic< ClockType::rep > m_Deadline;
+};
+} // end namespace selx
+
+#endif // selxCancellationToken_h
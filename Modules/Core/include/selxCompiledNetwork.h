@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxCompiledNetwork_h
+#define selxCompiledNetwork_h
+
+#include "selxBlueprint.h"
+#include "selxBlueprintImpl.h"
+#include "selxComponentPrototype.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace selx
+{
+/** \class CompiledNetwork
+ * \brief The outcome of configuring a blueprint: the component that was selected for each node, stored in a compact binary file
+ *
+ * Configuring a network by ApplyComponentConfiguration, ApplyConnectionConfiguration and PropagateConnectionConstraints
+ * is repeated for each run of the same blueprint. A CompiledNetwork records the result, i.e. the index in the
+ * ComponentRegistry of the component that is selected for each node and the components that were merged into an
+ * identical one, together with the blueprint itself. NetworkBuilder::ConfigureFrom() instantiates exactly these
+ * components, such that neither the blueprint files nor the component selection have to be processed again.
+ *
+ * The indices are only valid for the ComponentRegistry they were obtained from. The registry fingerprint, which is
+ * a hash of the component types and their template properties, guards against loading a network that was compiled
+ * by a different build of SuperElastix.
+ */
+class CompiledNetwork
+{
+public:
+
+  typedef std::shared_ptr< CompiledNetwork >       Pointer;
+  typedef std::shared_ptr< const CompiledNetwork > ConstPointer;
+
+  typedef BlueprintImpl::ComponentNameType ComponentNameType;
+  typedef std::uint64_t                    FingerprintType;
+  typedef std::uint64_t                    IndexType;
+
+  typedef std::map< ComponentNameType, IndexType >         SelectedComponentsType;
+  typedef std::map< ComponentNameType, ComponentNameType > MergedComponentsType;
+
+  /** The fingerprint of the prototypes of a ComponentRegistry, in registry order */
+  static FingerprintType Fingerprint( const std::vector< ComponentPrototypeBase::ConstPointer > & prototypes );
+
+  /** Write the network and the blueprint it was compiled from. Throws std::runtime_error if the file cannot be written. */
+  void Write( const std::string & fileName, const BlueprintImpl & blueprint ) const;
+
+  /** Read a network and set its components and connections into the (empty) blueprint, without parsing any blueprint file.
+   * Throws std::runtime_error if the file cannot be read or is not a compiled network. */
+  static Pointer Read( const std::string & fileName, Blueprint & blueprint );
+
+  /** Does the file start with the signature of a compiled network */
+  static bool IsCompiledNetworkFile( const std::string & fileName );
+
+  FingerprintType        registryFingerprint = 0;
+  SelectedComponentsType selectedComponents;
+  MergedComponentsType   mergedComponents;
+};
+} // end namespace selx
+
+#endif // selxCompiledNetwork_h
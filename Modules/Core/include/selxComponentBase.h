@@ -29,11 +29,15 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <typeindex>
 
 #include "selxLoggerImpl.h"
+#include "selxProgressMonitor.h"
 
 namespace selx
 {
+class ComponentPrototypeBase;
+
 class ComponentBase
 {
 public:
@@ -62,10 +66,22 @@ public:
 
   virtual InterfaceStatus CanAcceptConnectionFrom( ConstPointer, const InterfaceCriteriaType ) = 0;
 
+  // Handshake check against a component type that has not been instantiated, see ComponentSelector.
+  virtual InterfaceStatus CanAcceptConnectionFrom( const ComponentPrototypeBase &, const InterfaceCriteriaType ) = 0;
+
+  // Type level equivalent of a successful dynamic_cast of this component to the interface type.
+  virtual bool IsProviding( const std::type_index & ) const = 0;
+
   virtual unsigned int CountAcceptingInterfaces( const InterfaceCriteriaType ) = 0;
 
   virtual unsigned int CountProvidingInterfaces( const InterfaceCriteriaType ) = 0;
 
+  // Whether the NetworkBuilder may merge this component with an identical one, i.e. one of the same type with the same criteria and
+  // the same inputs, such that it is executed once and its outputs are provided to the components of both. This holds if its outputs
+  // only depend on its criteria and inputs, and are not modified by the components they are provided to. Transforms, metrics and
+  // optimizers that are set up by a registration method are not shareable. Default false.
+  virtual bool CanBeShared() const { return false; }
+
   //virtual const std::map< std::string, std::string >  TemplateProperties(); //TODO should be overridden
 
   // Each component is checked if its required connections are made after all handshakes.
@@ -114,9 +130,23 @@ public:
     this->m_Logger.Log( LogLevel::OFF, fmt, args ... );
   }
 
+  /** The network sets the monitor of its execution, or nullptr */
+  void SetProgressMonitor( ProgressMonitor * progressMonitor ) { this->m_ProgressMonitor = progressMonitor; }
+
+  /** Publish the progress of this component, e.g. from an iteration observer, if the network is monitored */
+  void ReportProgress( ProgressEvent event )
+  {
+    if( this->m_ProgressMonitor )
+    {
+      event.component = this->m_Name;
+      this->m_ProgressMonitor->Publish( std::move( event ) );
+    }
+  }
+
   const std::string m_Name;
   std::string m_HowToCite;
   LoggerImpl & m_Logger;
+  ProgressMonitor * m_ProgressMonitor;
 
 };
 } // end namespace selx
@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxComponentPrototype_h
+#define selxComponentPrototype_h
+
+#include "selxComponentBase.h"
+#include "selxCheckTemplateProperties.h"
+#include "selxInterfaceStatus.h"
+#include "selxInterfaceCompatibilityCache.h"
+#include "selxTypeList.h"
+
+#include <typeindex>
+
+namespace selx
+{
+/** \class ComponentPrototypeBase
+ * \brief A light weight, type level description of a Component that can be queried during component selection without instantiating the Component
+ *
+ * A Component may allocate heavy resources (itk filters, elastix or niftyreg objects) in its constructor. The ComponentSelector
+ * therefore narrows down its selection by the static properties of the Component types: its template properties and its
+ * accepting and providing interfaces. Only the Component that remains after selection is constructed by New().
+ */
+class ComponentPrototypeBase
+{
+public:
+
+  typedef std::shared_ptr< const ComponentPrototypeBase > ConstPointer;
+
+  typedef ComponentBase::CriterionType         CriterionType;
+  typedef ComponentBase::InterfaceCriteriaType InterfaceCriteriaType;
+  typedef std::map< std::string, std::string > TemplatePropertiesType;
+
+  virtual ~ComponentPrototypeBase() {}
+
+  /** The class name and template arguments that uniquely identify the Component type. Empty if the Component does not define them. */
+  virtual const TemplatePropertiesType & TemplateProperties() const = 0;
+
+  /** The typeid of the Component type, by which handshakes are cached in the InterfaceCompatibilityCache */
+  virtual std::type_index GetComponentType() const = 0;
+
+  /** Decide a criterion by the template properties only. Criteria that the prototype cannot decide return CriterionStatus::Unknown
+   * and must be passed to ComponentBase::MeetsCriterion of an instantiated Component. */
+  CriterionStatus CheckCriterion( const CriterionType & criterion ) const
+  {
+    return CheckTemplateProperties( this->TemplateProperties(), criterion );
+  }
+
+  virtual unsigned int CountAcceptingInterfaces( const InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  virtual unsigned int CountProvidingInterfaces( const InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  /** Is the interface type (by typeid) one of the providing interfaces of the Component type */
+  virtual bool IsProviding( const std::type_index & interfaceType ) const = 0;
+
+  /** Handshake check of this Component type as acceptor against an instantiated provider Component */
+  virtual InterfaceStatus CanAcceptConnectionFrom( const ComponentBase & provider, const InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  /** Handshake check of this Component type as acceptor against another Component type */
+  virtual InterfaceStatus CanAcceptConnectionFrom( const ComponentPrototypeBase & provider, const InterfaceCriteriaType & interfaceCriteria ) const = 0;
+
+  /** Construct the actual Component */
+  virtual ComponentBase::Pointer New( const std::string & name, LoggerImpl & logger ) const = 0;
+};
+
+template< class ComponentT >
+class ComponentPrototype : public ComponentPrototypeBase
+{
+public:
+
+  typedef ComponentT ComponentType;
+
+  /** Prototypes are stateless, so a single instance per Component type suffices */
+  static ConstPointer Get();
+
+  virtual const TemplatePropertiesType & TemplateProperties() const override;
+
+  virtual std::type_index GetComponentType() const override { return std::type_index( typeid( ComponentT ) ); }
+
+  virtual unsigned int CountAcceptingInterfaces( const InterfaceCriteriaType & interfaceCriteria ) const override;
+
+  virtual unsigned int CountProvidingInterfaces( const InterfaceCriteriaType & interfaceCriteria ) const override;
+
+  virtual bool IsProviding( const std::type_index & interfaceType ) const override;
+
+  virtual InterfaceStatus CanAcceptConnectionFrom( const ComponentBase & provider, const InterfaceCriteriaType & interfaceCriteria ) const override;
+
+  virtual InterfaceStatus CanAcceptConnectionFrom( const ComponentPrototypeBase & provider, const InterfaceCriteriaType & interfaceCriteria ) const override;
+
+  virtual ComponentBase::Pointer New( const std::string & name, LoggerImpl & logger ) const override;
+
+  ComponentPrototype();
+
+private:
+
+  // Components declare TemplateProperties() as a protected static function. Deriving from the Component (without ever
+  // instantiating this helper) gives access to it. Components without TemplateProperties() get an empty map.
+  struct TemplatePropertiesAccess : public ComponentT
+  {
+    template< typename T = ComponentT >
+    static TemplatePropertiesType Get( int, decltype( T::TemplateProperties() ) * = nullptr ) { return T::TemplateProperties(); }
+
+    static TemplatePropertiesType Get( long ) { return {}; }
+  };
+
+  const TemplatePropertiesType m_TemplateProperties;
+};
+
+/** Construct the list of prototypes of all Component types in a TypeList */
+template< typename >
+struct ConstructComponentPrototypesFromTypeList;
+} // end namespace selx
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxComponentPrototype.hxx"
+#endif
+
+#endif // selxComponentPrototype_h
@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxComponentPrototype_hxx
+#define selxComponentPrototype_hxx
+
+#include "selxComponentPrototype.h"
+
+namespace selx
+{
+template< class ComponentT >
+ComponentPrototype< ComponentT >::ComponentPrototype() : m_TemplateProperties( TemplatePropertiesAccess::Get( 0 ) )
+{
+}
+
+
+template< class ComponentT >
+typename ComponentPrototype< ComponentT >::ConstPointer
+ComponentPrototype< ComponentT >::Get()
+{
+  static const ConstPointer prototype = std::make_shared< const ComponentPrototype< ComponentT >>();
+  return prototype;
+}
+
+
+template< class ComponentT >
+const typename ComponentPrototype< ComponentT >::TemplatePropertiesType &
+ComponentPrototype< ComponentT >::TemplateProperties() const
+{
+  return this->m_TemplateProperties;
+}
+
+
+template< class ComponentT >
+unsigned int
+ComponentPrototype< ComponentT >::CountAcceptingInterfaces( const InterfaceCriteriaType & interfaceCriteria ) const
+{
+  return ComponentT::AcceptingInterfacesTypeList::CountMeetsCriteria( interfaceCriteria );
+}
+
+
+template< class ComponentT >
+unsigned int
+ComponentPrototype< ComponentT >::CountProvidingInterfaces( const InterfaceCriteriaType & interfaceCriteria ) const
+{
+  return ComponentT::ProvidingInterfacesTypeList::CountMeetsCriteria( interfaceCriteria );
+}
+
+
+template< class ComponentT >
+bool
+ComponentPrototype< ComponentT >::IsProviding( const std::type_index & interfaceType ) const
+{
+  return ComponentT::ProvidingInterfacesTypeList::IsProviding( interfaceType );
+}
+
+
+template< class ComponentT >
+InterfaceStatus
+ComponentPrototype< ComponentT >::CanAcceptConnectionFrom( const ComponentBase & provider, const InterfaceCriteriaType & interfaceCriteria ) const
+{
+  return InterfaceCompatibilityCache::Get( this->GetComponentType(), std::type_index( typeid( provider ) ), interfaceCriteria, [ & ](){
+      return ComponentT::AcceptingInterfacesTypeList::CanAcceptConnectionFromProvider( provider, interfaceCriteria );
+    } );
+}
+
+
+template< class ComponentT >
+InterfaceStatus
+ComponentPrototype< ComponentT >::CanAcceptConnectionFrom( const ComponentPrototypeBase & provider, const InterfaceCriteriaType & interfaceCriteria ) const
+{
+  return InterfaceCompatibilityCache::Get( this->GetComponentType(), provider.GetComponentType(), interfaceCriteria, [ & ](){
+      return ComponentT::AcceptingInterfacesTypeList::CanAcceptConnectionFromProvider( provider, interfaceCriteria );
+    } );
+}
+
+
+template< class ComponentT >
+ComponentBase::Pointer
+ComponentPrototype< ComponentT >::New( const std::string & name, LoggerImpl & logger ) const
+{
+  return std::make_shared< ComponentT >( name, logger );
+}
+
+
+template< >
+struct ConstructComponentPrototypesFromTypeList< TypeList< >>
+{
+  static void fill( std::vector< ComponentPrototypeBase::ConstPointer > & )
+  {
+  }
+};
+
+template< typename ComponentType, typename ... Rest >
+struct ConstructComponentPrototypesFromTypeList< TypeList< ComponentType, Rest ... >>
+{
+  static void fill( std::vector< ComponentPrototypeBase::ConstPointer > & prototypes )
+  {
+    prototypes.push_back( ComponentPrototype< ComponentType >::Get() );
+    ConstructComponentPrototypesFromTypeList< TypeList< Rest ... >>::fill( prototypes );
+  }
+};
+} // end namespace selx
+
+#endif // selxComponentPrototype_hxx
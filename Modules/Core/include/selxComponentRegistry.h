@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxComponentRegistry_h
+#define selxComponentRegistry_h
+
+#include "selxComponentPrototype.h"
+#include "selxTypeList.h"
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace selx
+{
+/** \class ComponentRegistry
+ * \brief The prototypes of all Components in a ComponentList, indexed by their template properties
+ *
+ * The registry is built once per ComponentList. For each template property key (e.g. NameOfClass, Dimensionality,
+ * PixelType, InternalComputationValueType) it holds the set of Components that define the key and, per value, the set
+ * of Components that match it. A ComponentSelector narrows its candidates by intersecting these sets instead of
+ * checking each candidate.
+ */
+
+template< class ComponentList >
+class ComponentRegistry
+{
+public:
+
+  typedef ComponentPrototypeBase::ConstPointer         PrototypePointer;
+  typedef std::vector< PrototypePointer >              PrototypeContainerType;
+  typedef PrototypeContainerType::size_type            IndexType;
+  typedef boost::dynamic_bitset< >                     ComponentSetType;
+
+  /** The registry of a ComponentList is built on first use */
+  static const ComponentRegistry & Get();
+
+  const PrototypeContainerType & GetPrototypes() const { return this->m_Prototypes; }
+
+  IndexType Size() const { return this->m_Prototypes.size(); }
+
+  /** The set of all Components in the registry */
+  ComponentSetType All() const { return ComponentSetType( this->Size() ).set(); }
+
+  /** The set of Components that have key as template property, or nullptr if none has. */
+  const ComponentSetType * Defining( const std::string & key ) const;
+
+  /** The set of Components that have value for template property key, or nullptr if none has. */
+  const ComponentSetType * Matching( const std::string & key, const std::string & value ) const;
+
+private:
+
+  ComponentRegistry();
+
+  struct PropertyIndex
+  {
+    ComponentSetType                                      defining;
+    std::unordered_map< std::string, ComponentSetType > byValue;
+  };
+
+  PrototypeContainerType                             m_Prototypes;
+  std::unordered_map< std::string, PropertyIndex > m_Index;
+};
+} // end namespace selx
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxComponentRegistry.hxx"
+#endif
+
+#endif // selxComponentRegistry_h
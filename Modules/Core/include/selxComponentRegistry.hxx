@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef selxComponentRegistry_hxx
+#define selxComponentRegistry_hxx
+
+#include "selxComponentRegistry.h"
+
+namespace selx
+{
+template< class ComponentList >
+ComponentRegistry< ComponentList >::ComponentRegistry()
+{
+  ConstructComponentPrototypesFromTypeList< ComponentList >::fill( this->m_Prototypes );
+
+  for( IndexType index = 0; index < this->m_Prototypes.size(); ++index )
+  {
+    for( auto const & property : this->m_Prototypes[ index ]->TemplateProperties() )
+    {
+      PropertyIndex & propertyIndex = this->m_Index[ property.first ];
+      if( propertyIndex.defining.empty() )
+      {
+        propertyIndex.defining.resize( this->m_Prototypes.size() );
+      }
+      propertyIndex.defining.set( index );
+
+      ComponentSetType & matching = propertyIndex.byValue[ property.second ];
+      if( matching.empty() )
+      {
+        matching.resize( this->m_Prototypes.size() );
+      }
+      matching.set( index );
+    }
+  }
+}
+
+
+template< class ComponentList >
+const ComponentRegistry< ComponentList > &
+ComponentRegistry< ComponentList >::Get()
+{
+  static const ComponentRegistry< ComponentList > registry;
+  return registry;
+}
+
+
+template< class ComponentList >
+const typename ComponentRegistry< ComponentList >::ComponentSetType *
+ComponentRegistry< ComponentList >::Defining( const std::string & key ) const
+{
+  auto propertyIndex = this->m_Index.find( key );
+  if( propertyIndex == this->m_Index.end() )
+  {
+    return nullptr;
+  }
+  return &propertyIndex->second.defining;
+}
+
+
+template< class ComponentList >
+const typename ComponentRegistry< ComponentList >::ComponentSetType *
+ComponentRegistry< ComponentList >::Matching( const std::string & key, const std::string & value ) const
+{
+  auto propertyIndex = this->m_Index.find( key );
+  if( propertyIndex == this->m_Index.end() )
+  {
+    return nullptr;
+  }
+  auto matching = propertyIndex->second.byValue.find( value );
+  if( matching == propertyIndex->second.byValue.end() )
+  {
+    return nullptr;
+  }
+  return &matching->second;
+}
+} // end namespace selx
+
+#endif // selxComponentRegistry_hxx
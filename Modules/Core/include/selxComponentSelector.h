@@ -21,6 +21,8 @@
 
 #include "itkObjectFactory.h"
 #include "selxComponentBase.h"
+#include "selxComponentPrototype.h"
+#include "selxComponentRegistry.h"
 #include "selxLogger.h"
 #include "selxTypeList.h"
 
@@ -28,6 +30,11 @@ namespace selx
 {
 /** \class ComponentSelector
  * \brief A Component factory that accepts criteria, possibly in multiple passes, to construct and return the right Component
+ *
+ * Selection is performed on ComponentPrototypes, such that Components are not instantiated while they are candidates.
+ * Criteria on template properties narrow the candidates by set intersections on the ComponentRegistry.
+ * Criteria that cannot be decided by the template properties of a prototype are deferred until the candidate is instantiated,
+ * which happens only when the number of remaining components or the selected component itself is requested.
  */
 
 template< class ComponentList >
@@ -46,8 +53,21 @@ public:
   typedef ComponentBase::CriterionType         CriterionType;
   typedef ComponentBase::InterfaceCriteriaType InterfaceCriteriaType;
 
-  typedef std::list< ComponentBasePointer > ComponentListType;
-  typedef ComponentListType::size_type      NumberOfComponentsType;
+  typedef ComponentRegistry< ComponentList >     ComponentRegistryType;
+  typedef typename ComponentRegistryType::ComponentSetType ComponentSetType;
+  typedef typename ComponentRegistryType::IndexType        IndexType;
+
+  /** A candidate is instantiated only if a deferred criterion needs to be checked or if it is selected */
+  struct ComponentCandidate
+  {
+    ComponentPrototypeBase::ConstPointer prototype;
+    ComponentBasePointer                 component;
+    std::vector< CriterionType >         deferredCriteria;
+  };
+
+  /** Candidates are stored at their index in the ComponentRegistry, m_Candidates marks which of them are still selected */
+  typedef std::vector< ComponentCandidate >     ComponentListType;
+  typedef typename ComponentListType::size_type NumberOfComponentsType;
   /** set selection criteria for possibleComponents*/
 
   ComponentSelector( const std::string & name, LoggerImpl & logger );
@@ -61,27 +81,52 @@ public:
 
   unsigned int NumberOfComponents( void );
 
+  /** Number of candidates without checking the deferred criteria, i.e. without instantiating any component. This is an upper bound of NumberOfComponents(). */
+  unsigned int NumberOfCandidates( void ) const;
+
   unsigned int RequireAcceptingInterfaceFrom( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria );
 
   unsigned int RequireProvidingInterfaceTo( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria );
 
+  /** Remove the candidates that cannot accept from any of the candidates of the other selector. Returns the number of remaining candidates. */
+  unsigned int RequireAcceptingInterfaceFrom( const Self & other, const InterfaceCriteriaType & interfaceCriteria );
+
+  /** Remove the candidates that cannot provide to any of the candidates of the other selector. Returns the number of remaining candidates. */
+  unsigned int RequireProvidingInterfaceTo( const Self & other, const InterfaceCriteriaType & interfaceCriteria );
+
   /** Return Component or Nullptr*/
   ComponentBasePointer GetComponent( void );
 
+  /** Restrict the candidates to the Component at index of the ComponentRegistry, e.g. as selected by an earlier configuration.
+   * Criteria added afterwards are still passed to the Component, since MeetsCriterion may configure it. */
+  void SelectCandidate( IndexType index );
+
+  /** The index in the ComponentRegistry of the uniquely selected Component, or ComponentSetType::npos */
+  IndexType GetSelectedIndex( void );
+
   void PrintComponents( void );
 
 protected:
 
-  ComponentListType m_PossibleComponents;
+  /** Instantiate the candidates that have deferred criteria and remove those that fail them */
+  void ApplyDeferredCriteria( void );
+
+  /** Remove the candidates for which the predicate returns true */
+  template< typename PredicateType >
+  void RemoveCandidatesIf( PredicateType predicate );
+
+  const ComponentRegistryType & m_Registry;
+  ComponentListType             m_PossibleComponents;
+  ComponentSetType              m_Candidates;
+
+  const std::string m_Name;
+  LoggerImpl &      m_Logger;
 
 private:
 
   ComponentSelector( const Self & ); //purposely not implemented
   void operator=( const Self & );    //purposely not implemented
 };
-
-template< typename >
-struct ContructComponentsFromTypeList;
 } // end namespace selx
 
 #ifndef ITK_MANUAL_INSTANTIATION
@@ -23,34 +23,30 @@
 
 namespace selx
 {
-template< >
-struct ContructComponentsFromTypeList< TypeList< >>
+template< class ComponentList >
+ComponentSelector< ComponentList >::ComponentSelector( const std::string & name, LoggerImpl & logger ) :
+  m_Registry( ComponentRegistryType::Get() ), m_Candidates( m_Registry.All() ), m_Name( name ), m_Logger( logger )
 {
-  static std::list< ComponentBase::Pointer > fill( std::list< ComponentBase::Pointer > & components,
-    const std::string & name,
-    LoggerImpl & logger )
+  for( auto const & prototype : this->m_Registry.GetPrototypes() )
   {
-    return components;
+    this->m_PossibleComponents.push_back( { prototype, nullptr, {} } );
   }
-};
+}
 
-template< typename ComponentType, typename ... Rest >
-struct ContructComponentsFromTypeList< TypeList< ComponentType, Rest ... >>
-{
-  static std::list< ComponentBase::Pointer > fill( std::list< ComponentBase::Pointer > & components,
-    const std::string & name,
-    LoggerImpl & logger )
-  {
-    components.push_back( std::make_shared< ComponentType >( name, logger ) );
-    return ContructComponentsFromTypeList< TypeList< Rest ... >>::fill( components, name, logger );
-  }
-};
 
 template< class ComponentList >
-ComponentSelector< ComponentList >::ComponentSelector( const std::string & name, LoggerImpl & logger )
+template< typename PredicateType >
+void
+ComponentSelector< ComponentList >::RemoveCandidatesIf( PredicateType predicate )
 {
-  m_PossibleComponents = std::list< ComponentBase::Pointer >();
-  m_PossibleComponents = ContructComponentsFromTypeList< ComponentList >::fill( m_PossibleComponents, name, logger );
+  for( IndexType index = this->m_Candidates.find_first(); index != ComponentSetType::npos; index = this->m_Candidates.find_next( index ) )
+  {
+    if( predicate( this->m_PossibleComponents[ index ] ) )
+    {
+      this->m_Candidates.reset( index );
+      this->m_PossibleComponents[ index ].component = nullptr;
+    }
+  }
 }
 
 
@@ -58,9 +54,45 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::AddCriterion( const CriterionType & criterion )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      return !component->MeetsCriterion( criterion );
-    } );
+  // Candidates that have the criterion key as template property are decided by the index of the registry.
+  ComponentSetType undecided = this->m_Candidates;
+  if( const ComponentSetType * defining = this->m_Registry.Defining( criterion.first ) )
+  {
+    if( ( this->m_Candidates & *defining ).any() )
+    {
+      if( criterion.second.size() != 1 ) // criteria can be of format: "keystring": ["value1", value2","value3"], but for templateproperties only 1 value is allowed.
+      {
+        throw std::runtime_error( "The criterion " + criterion.first + " may have only 1 value" );
+      }
+      const ComponentSetType * matching = this->m_Registry.Matching( criterion.first, criterion.second[ 0 ] );
+      const ComponentSetType   failed   = this->m_Candidates & ( matching ? ( *defining - *matching ) : *defining );
+      for( IndexType index = failed.find_first(); index != ComponentSetType::npos; index = failed.find_next( index ) )
+      {
+        this->m_PossibleComponents[ index ].component = nullptr;
+      }
+      this->m_Candidates -= failed;
+    }
+    undecided -= *defining;
+  }
+
+  // Only the component itself can tell for the others.
+  for( IndexType index = undecided.find_first(); index != ComponentSetType::npos; index = undecided.find_next( index ) )
+  {
+    ComponentCandidate & candidate = this->m_PossibleComponents[ index ];
+    if( candidate.component )
+    {
+      if( !candidate.component->MeetsCriterion( criterion ) )
+      {
+        this->m_Candidates.reset( index );
+        candidate.component = nullptr;
+      }
+    }
+    else
+    {
+      // Keep the order of the deferred criteria, since MeetsCriterion may configure the component.
+      candidate.deferredCriteria.push_back( criterion );
+    }
+  }
 }
 
 
@@ -68,8 +100,8 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::AddAcceptingInterfaceCriteria( const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      return 0 == component->CountAcceptingInterfaces( interfaceCriteria );
+  this->RemoveCandidatesIf([ & ]( const ComponentCandidate & candidate ){
+      return 0 == candidate.prototype->CountAcceptingInterfaces( interfaceCriteria );
     } );
 }
 
@@ -78,8 +110,8 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::AddProvidingInterfaceCriteria( const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      return 0 == component->CountProvidingInterfaces( interfaceCriteria );
+  this->RemoveCandidatesIf([ & ]( const ComponentCandidate & candidate ){
+      return 0 == candidate.prototype->CountProvidingInterfaces( interfaceCriteria );
     } );
 }
 
@@ -89,8 +121,8 @@ template< class ComponentList >
 unsigned int
 ComponentSelector< ComponentList >::RequireAcceptingInterfaceFrom( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      auto status = component->CanAcceptConnectionFrom( other, interfaceCriteria );
+  this->RemoveCandidatesIf([ & ]( const ComponentCandidate & candidate ){
+      auto status = candidate.prototype->CanAcceptConnectionFrom( *other, interfaceCriteria );
       return status == InterfaceStatus::noaccepter || status == InterfaceStatus::noprovider;
     } );
   return 0;
@@ -101,24 +133,93 @@ template< class ComponentList >
 unsigned int
 ComponentSelector< ComponentList >::RequireProvidingInterfaceTo( ComponentBasePointer other, const InterfaceCriteriaType & interfaceCriteria )
 {
-  this->m_PossibleComponents.remove_if([ & ]( ComponentBasePointer component ){
-      auto status = other->CanAcceptConnectionFrom( component, interfaceCriteria );
+  this->RemoveCandidatesIf([ & ]( const ComponentCandidate & candidate ){
+      auto status = other->CanAcceptConnectionFrom( *candidate.prototype, interfaceCriteria );
       return status == InterfaceStatus::noaccepter || status == InterfaceStatus::noprovider;
     } );
   return 0;
 }
 
 
+template< class ComponentList >
+unsigned int
+ComponentSelector< ComponentList >::RequireAcceptingInterfaceFrom( const Self & other, const InterfaceCriteriaType & interfaceCriteria )
+{
+  this->RemoveCandidatesIf([ & ]( const ComponentCandidate & candidate ){
+      for( IndexType index = other.m_Candidates.find_first(); index != ComponentSetType::npos; index = other.m_Candidates.find_next( index ) )
+      {
+        auto status = candidate.prototype->CanAcceptConnectionFrom( *other.m_PossibleComponents[ index ].prototype, interfaceCriteria );
+        if( status != InterfaceStatus::noaccepter && status != InterfaceStatus::noprovider )
+        {
+          return false;
+        }
+      }
+      return true;
+    } );
+  return this->NumberOfCandidates();
+}
+
+
+template< class ComponentList >
+unsigned int
+ComponentSelector< ComponentList >::RequireProvidingInterfaceTo( const Self & other, const InterfaceCriteriaType & interfaceCriteria )
+{
+  this->RemoveCandidatesIf([ & ]( const ComponentCandidate & candidate ){
+      for( IndexType index = other.m_Candidates.find_first(); index != ComponentSetType::npos; index = other.m_Candidates.find_next( index ) )
+      {
+        auto status = other.m_PossibleComponents[ index ].prototype->CanAcceptConnectionFrom( *candidate.prototype, interfaceCriteria );
+        if( status != InterfaceStatus::noaccepter && status != InterfaceStatus::noprovider )
+        {
+          return false;
+        }
+      }
+      return true;
+    } );
+  return this->NumberOfCandidates();
+}
+
+
+template< class ComponentList >
+void
+ComponentSelector< ComponentList >::ApplyDeferredCriteria()
+{
+  this->RemoveCandidatesIf([ & ]( ComponentCandidate & candidate ){
+      if( candidate.deferredCriteria.empty() )
+      {
+        return false;
+      }
+      if( !candidate.component )
+      {
+        candidate.component = candidate.prototype->New( this->m_Name, this->m_Logger );
+      }
+      auto deferredCriteria = std::move( candidate.deferredCriteria );
+      candidate.deferredCriteria.clear();
+      for( auto const & criterion : deferredCriteria )
+      {
+        if( !candidate.component->MeetsCriterion( criterion ) )
+        {
+          return true;
+        }
+      }
+      return false;
+    } );
+}
+
+
 template< class ComponentList >
 typename ComponentSelector< ComponentList >::ComponentBasePointer
 ComponentSelector< ComponentList >::GetComponent()
 {
-  //TODO check if Modified
-  //this->UpdatePossibleComponents();
+  this->ApplyDeferredCriteria();
 
-  if( this->m_PossibleComponents.size() == 1 )
+  if( this->m_Candidates.count() == 1 )
   {
-    return *( this->m_PossibleComponents.begin() );
+    ComponentCandidate & candidate = this->m_PossibleComponents[ this->m_Candidates.find_first() ];
+    if( !candidate.component )
+    {
+      candidate.component = candidate.prototype->New( this->m_Name, this->m_Logger );
+    }
+    return candidate.component;
   }
   else
   {
@@ -127,11 +228,44 @@ ComponentSelector< ComponentList >::GetComponent()
 }
 
 
+template< class ComponentList >
+void
+ComponentSelector< ComponentList >::SelectCandidate( IndexType index )
+{
+  if( index >= this->m_Registry.Size() )
+  {
+    throw std::runtime_error( "Component index " + std::to_string( index ) + " of " + this->m_Name + " is not in the registry" );
+  }
+  const bool isCandidate = this->m_Candidates.test( index );
+  this->m_Candidates.reset( index );
+  this->RemoveCandidatesIf([]( const ComponentCandidate & ){ return true; } );
+  this->m_Candidates.set( index, isCandidate );
+}
+
+
+template< class ComponentList >
+typename ComponentSelector< ComponentList >::IndexType
+ComponentSelector< ComponentList >::GetSelectedIndex()
+{
+  this->ApplyDeferredCriteria();
+  return this->m_Candidates.count() == 1 ? this->m_Candidates.find_first() : ComponentSetType::npos;
+}
+
+
 template< class ComponentList >
 unsigned int
 ComponentSelector< ComponentList >::NumberOfComponents()
 {
-  return this->m_PossibleComponents.size();
+  this->ApplyDeferredCriteria();
+  return this->m_Candidates.count();
+}
+
+
+template< class ComponentList >
+unsigned int
+ComponentSelector< ComponentList >::NumberOfCandidates() const
+{
+  return this->m_Candidates.count();
 }
 
 
@@ -139,17 +273,17 @@ template< class ComponentList >
 void
 ComponentSelector< ComponentList >::PrintComponents( void )
 {
-  /*
-  for (auto & component : this->m_PossibleComponents)
+  // Formatting the template properties map of every candidate is costly, so skip the loop altogether if debug messages are not logged
+  if( !this->m_Logger.ShouldLog( LogLevel::DBG ) )
   {
-    auto const & properties = component->TemplateProperties();
-    for (auto const & keyvalue : properties)
-    {
-      std::cout << "{ """ << keyvalue.first << """: """ << keyvalue.second << """}" << std::endl;
-    }
-    std::cout << std::endl;
+    return;
+  }
+
+  for( IndexType index = this->m_Candidates.find_first(); index != ComponentSetType::npos; index = this->m_Candidates.find_next( index ) )
+  {
+    const ComponentCandidate & candidate = this->m_PossibleComponents[ index ];
+    this->m_Logger.Log( LogLevel::DBG, "Candidate for '{0}': {1}", this->m_Name, this->m_Logger << candidate.prototype->TemplateProperties() );
   }
-  */
 }
 } // end namespace selx
 
@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxInterfaceCompatibilityCache_h
+#define selxInterfaceCompatibilityCache_h
+
+#include "selxInterfaceStatus.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+namespace selx
+{
+/** \class InterfaceCompatibilityCache
+ * \brief Process wide memo of the handshake status between an accepting and a providing Component type
+ *
+ * Whether a Component can accept a connection from another Component depends only on their Accepting and Providing
+ * TypeLists and on the interface criteria of the connection. The status is therefore computed once per pair of Component
+ * types and interface criteria, such that repeated handshakes during component selection cost a table lookup.
+ */
+class InterfaceCompatibilityCache
+{
+public:
+
+  typedef std::map< std::string, std::string > InterfaceCriteriaType;
+  typedef std::function< InterfaceStatus() >   ComputeFunctionType;
+
+  /** Return the cached status of the pair, or compute and cache it by compute() */
+  static InterfaceStatus Get( const std::type_index & acceptingType, const std::type_index & providingType,
+    const InterfaceCriteriaType & interfaceCriteria, const ComputeFunctionType & compute );
+
+  /** Number of cached entries */
+  static std::size_t Size();
+
+  static void Clear();
+
+private:
+
+  typedef std::pair< std::type_index, std::type_index > TypePairType;
+
+  struct TypePairHash
+  {
+    std::size_t operator()( const TypePairType & typePair ) const
+    {
+      return typePair.first.hash_code() ^ ( typePair.second.hash_code() << 1 );
+    }
+  };
+
+  typedef std::unordered_map< TypePairType, std::map< InterfaceCriteriaType, InterfaceStatus >, TypePairHash > CacheType;
+
+  static CacheType & GetCache();
+
+  static std::mutex & GetMutex();
+};
+} // end namespace selx
+
+#endif // selxInterfaceCompatibilityCache_h
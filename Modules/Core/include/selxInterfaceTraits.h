@@ -80,5 +80,32 @@ struct Properties< UpdateInterface >
   }
 };
 
+template< >
+struct Properties< ReleaseDataInterface >
+{
+  static const std::map< std::string, std::string > Get()
+  {
+    return{ { keys::NameOfInterface, "ReleaseDataInterface" } };
+  }
+};
+
+template< >
+struct Properties< CancellationInterface >
+{
+  static const std::map< std::string, std::string > Get()
+  {
+    return{ { keys::NameOfInterface, "CancellationInterface" } };
+  }
+};
+
+template< >
+struct Properties< NumberOfThreadsInterface >
+{
+  static const std::map< std::string, std::string > Get()
+  {
+    return{ { keys::NameOfInterface, "NumberOfThreadsInterface" } };
+  }
+};
+
 } // end namespace selx
 #endif // #define InterfaceTraits_h
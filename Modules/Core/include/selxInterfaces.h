@@ -23,6 +23,7 @@
 #include "itkDataObject.h"
 #include "selxAnyFileReader.h"
 #include "selxAnyFileWriter.h"
+#include "selxCancellationToken.h"
 
 namespace selx
 {
@@ -39,6 +40,10 @@ public:
   using Pointer = std::shared_ptr< SourceInterface >;
   virtual void SetMiniPipelineInput( itk::DataObject::Pointer ) = 0;
   virtual AnyFileReader::Pointer GetInputFileReader( void ) = 0;
+
+  // Called before the filter updates its inputs. Sources of data that can be read by region, such as images, request none,
+  // such that their consumers read only the regions they request when the network executes.
+  virtual void DeferMiniPipelineInputRead( void ) {}
 };
 
 class SinkInterface
@@ -70,6 +75,44 @@ public:
   virtual void Update() = 0;
 };
 
+class ReleaseDataInterface
+{
+  // A special interface: the NetworkBuilder checks components for this type of interface.
+  // By this interface the network frees the (bulk) data of a component as soon as all components that use it are updated.
+  // A component must be able to Update again after ReleaseData, e.g. when the network is executed with other inputs.
+
+public:
+
+  using Pointer = std::shared_ptr< ReleaseDataInterface >;
+  virtual void ReleaseData() = 0;
+};
+
+class CancellationInterface
+{
+  // A special interface: the NetworkBuilder checks components for this type of interface.
+  // By this interface the network passes the cancellation token to a component before it is updated, such that a long running
+  // Update can stop early, e.g. by stopping its optimizer at the next iteration, or by throwing ExecutionCancelledException.
+  // The token is nullptr if the execution cannot be cancelled.
+
+public:
+
+  using Pointer = std::shared_ptr< CancellationInterface >;
+  virtual void SetCancellationToken( CancellationToken::ConstPointer ) = 0;
+};
+
+class NumberOfThreadsInterface
+{
+  // A special interface: the NetworkContainer checks the components in its update order for this type of interface.
+  // By this interface the network passes a component its share of the thread budget right before it is updated. The component
+  // applies it to the parallelism of its backend, e.g. the number of threads of its itk filters or the OpenMP threads of NiftyReg,
+  // such that concurrently updated components do not oversubscribe the cores.
+
+public:
+
+  using Pointer = std::shared_ptr< NumberOfThreadsInterface >;
+  virtual void SetNumberOfThreads( unsigned int numberOfThreads ) = 0;
+};
+
 } // end namespace selx
 
 #endif // #define selxInterfaces_h
@@ -31,6 +31,13 @@
 #include <string>
 #include <cstring>
 #include <map>
+#include <deque>
+#include <set>
+#include <sstream>
+#include <typeinfo>
+#include <algorithm>
+#include <limits>
+#include <tuple>
 
 #include "selxLoggerImpl.h"
 #include "selxBlueprintImpl.h"
@@ -64,12 +71,22 @@ public:
   /** Read configuration at the blueprints nodes and edges and return true if all components could be uniquely selected*/
   virtual bool Configure();
 
-  /** if all components are uniquely selected, they can be connected */
+  /** Instantiate the components that were selected by an earlier configuration, bypassing ApplyComponentConfiguration,
+   * ApplyConnectionConfiguration and PropagateConnectionConstraints. The component criteria are still passed to the selected
+   * components, since MeetsCriterion configures them. */
+  virtual bool ConfigureFrom( const CompiledNetwork & compiledNetwork );
+
+  virtual CompiledNetwork GetCompiledNetwork();
+
+  /** if all components are uniquely selected, they can be connected. Components are connected only once, subsequent calls return the same result. */
   virtual bool ConnectComponents();
 
   virtual bool CheckConnectionsSatisfied();
 
-  virtual NetworkContainer GetRealizedNetwork();
+  /** The network is realized only once, such that a configured and connected NetworkBuilder can be executed repeatedly */
+  virtual NetworkContainer & GetRealizedNetwork();
+
+  virtual bool Reconfigure( ComponentNamesType & reconfiguredComponentNames );
 
   virtual SourceInterfaceMapType GetSourceInterfaces();
 
@@ -81,6 +98,8 @@ public:
 
   virtual SinkInterface::DataObjectPointer GetInitializedOutput( const NetworkBuilderBase::ComponentNameType & );
 
+  virtual void SetProfiler( Profiler * profiler ) { this->m_Profiler = profiler; }
+
 protected:
 
   typedef ComponentBase::CriteriaType       CriteriaType;
@@ -90,21 +109,60 @@ protected:
   typedef ComponentSelector< ComponentList >      ComponentSelectorType;
   typedef typename ComponentSelectorType::Pointer ComponentSelectorPointer;
 
-  typedef std::map< ComponentNameType, ComponentSelectorPointer > ComponentSelectorContainerType;
-  typedef typename ComponentSelectorContainerType::iterator       ComponentSelectorIteratorType;
+  // Components are identified by their integer id in the blueprint graph; names are only used for logging and the string based interface.
+  typedef BlueprintImpl::ComponentIndexType   ComponentIndexType;
+  typedef BlueprintImpl::ComponentIndicesType ComponentIndicesType;
+
+  // The selector of each component, by component id
+  typedef std::vector< ComponentSelectorPointer >           ComponentSelectorContainerType;
+  typedef typename ComponentSelectorContainerType::iterator ComponentSelectorIteratorType;
+
+  /** A connection of the blueprint by the ids of its components, with the interface criteria of its properties */
+  struct ConnectionType
+  {
+    BlueprintImpl::ConnectionIndexType   index;
+    ComponentIndexType                   providing;
+    ComponentIndexType                   accepting;
+    BlueprintImpl::ConnectionNameType    name;
+    ComponentBase::InterfaceCriteriaType interfaceCriteria;
+  };
+  typedef std::vector< ConnectionType > ConnectionContainerType;
 
   /** Read configuration at the blueprints nodes and try to find instantiated components */
   virtual void ApplyComponentConfiguration();
 
+  /** Create the selector of a component with the criteria of its node */
+  ComponentSelectorPointer CreateComponentSelector( ComponentIndexType componentIndex );
+
   /** Read configuration at the blueprints edges and try to find instantiated components */
   virtual void ApplyConnectionConfiguration();
 
-  /** For all uniquely selected components test handshake to non-uniquely selected components */
-  virtual void PropagateConnectionsWithUniqueComponents();
+  /** Narrow the selection of the providing and/or accepting component of a connection by its interface criteria */
+  void ApplyConnectionCriteria( const ConnectionType & connection, bool applyToProviding, bool applyToAccepting );
+
+  /** Remember the components and connections that the network is configured with, to find the modified ones in Reconfigure */
+  void StoreConfiguration();
+
+  /** Test handshakes between the candidates of connected components and remove the candidates without any match */
+  virtual void PropagateConnectionConstraints();
 
   /** See which components need more configuration criteria */
   virtual ComponentNamesType GetNonUniqueComponentNames();
 
+  /** Merge the uniquely selected components that can be shared into an identical component upstream in the update order, if
+   * any. Components are identical if they are of the same type, with the same criteria and the same (merged) connections from
+   * the same (merged) components. Returns the number of merged components. */
+  virtual std::size_t EliminateCommonSubexpressions();
+
+  /** The component that a merged component is merged into, or the component itself */
+  ComponentIndexType GetMergedInto( ComponentIndexType componentIndex ) const { return this->m_MergedInto[ componentIndex ]; }
+
+  /** The connections of the blueprint, which are read from the blueprint once */
+  const ConnectionContainerType & GetConnections();
+
+  /** The selected component, or nullptr if the selection is not unique */
+  ComponentBase::Pointer GetComponent( ComponentIndexType componentIndex ) { return this->m_ComponentSelectorContainer[ componentIndex ]->GetComponent(); }
+
   void Cite();
 
   //TODO make const correct
@@ -114,9 +172,26 @@ protected:
 
   // A selector for each node, that each can hold multiple instantiated components. Ultimately is should be 1 component each.
   ComponentSelectorContainerType  m_ComponentSelectorContainer;
+  // For each component the identical component it is merged into, or itself. Merged components share the selector of the latter.
+  ComponentIndicesType            m_MergedInto;
+  std::size_t                     m_NumberOfMergedComponents;
+  ConnectionContainerType         m_Connections;
+  bool                            m_HasConnections;
+  // The components as they were configured, by id
+  std::vector< BlueprintImpl::ComponentPropertyType > m_ConfiguredComponents;
+  // Per component, whether its incoming connections are connected
+  std::vector< bool >             m_ConnectedComponents;
+  // Per component, the element of the update order of the realized network, or std::numeric_limits< std::size_t >::max()
+  std::vector< std::size_t >      m_UpdateIndices;
+  // Per component, whether the results of its update may be reused by the network that is realized next
+  std::vector< bool >             m_UpToDateComponents;
   bool                            m_isConfigured;
+  bool                            m_isConnected;
+  bool                            m_AllConnectionsSucceeded;
+  std::unique_ptr< NetworkContainer > m_RealizedNetwork;
   LoggerImpl &                    m_Logger;
   const BlueprintImpl &                 m_Blueprint;
+  Profiler *                      m_Profiler;
 
 private:
 };
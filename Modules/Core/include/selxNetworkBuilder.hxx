@@ -25,8 +25,15 @@
 namespace selx
 {
 template< typename ComponentList >
-NetworkBuilder< ComponentList >::NetworkBuilder( LoggerImpl & logger, const BlueprintImpl & blueprint ) : m_Logger( logger ), m_isConfigured( false ), m_Blueprint( blueprint )
+NetworkBuilder< ComponentList >::NetworkBuilder( LoggerImpl & logger, const BlueprintImpl & blueprint ) :
+  m_MergedInto( blueprint.GetNumberOfComponents() ), m_NumberOfMergedComponents( 0 ), m_HasConnections( false ),
+  m_ConnectedComponents( blueprint.GetNumberOfComponents(), false ), m_UpToDateComponents( blueprint.GetNumberOfComponents(), false ), m_isConfigured( false ),
+  m_isConnected( false ), m_AllConnectionsSucceeded( false ), m_Logger( logger ), m_Blueprint( blueprint ), m_Profiler( nullptr )
 {
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_MergedInto.size(); ++componentIndex )
+  {
+    this->m_MergedInto[ componentIndex ] = componentIndex;
+  }
 }
 
 
@@ -50,36 +57,45 @@ NetworkBuilder< ComponentList >::Configure()
   // Configuration consists of 3 steps:
   // - ApplyNodeConfiguration()
   // - ApplyConnectionConfiguration()
-  // - PropagateConnectionsWithUniqueComponents();
+  // - PropagateConnectionConstraints();
 
   if( !this->m_isConfigured )
   {
+    Profiler::Scope scope( this->m_Profiler, "Configure", "phase" );
     this->m_Logger.Log( LogLevel::INF, "Applying component criteria ... " );
     this->ApplyComponentConfiguration();
     auto nonUniqueComponentNames = this->GetNonUniqueComponentNames();
     this->m_Logger.Log(  LogLevel::INF,
                          "Applying component criteria ... Done. {0:d} out of {1:d} components were uniquely selected.",
-                         m_Blueprint.GetComponentNames().size()-nonUniqueComponentNames.size(),
-                         m_Blueprint.GetComponentNames().size() );
+                         m_Blueprint.GetNumberOfComponents()-nonUniqueComponentNames.size(),
+                         m_Blueprint.GetNumberOfComponents() );
 
     this->m_Logger.Log( LogLevel::INF, "Applying connection criteria ..." );
     this->ApplyConnectionConfiguration();
     nonUniqueComponentNames = this->GetNonUniqueComponentNames();
     this->m_Logger.Log(  LogLevel::INF,
                          "Applying connection criteria ... Done. {0:d} out of {1:d} components were uniquely selected.",
-                         m_Blueprint.GetComponentNames().size()-nonUniqueComponentNames.size(),
-                         m_Blueprint.GetComponentNames().size() );
+                         m_Blueprint.GetNumberOfComponents()-nonUniqueComponentNames.size(),
+                         m_Blueprint.GetNumberOfComponents() );
 
     if( nonUniqueComponentNames.size() > 0 )
     {
-      this->m_Logger.Log( LogLevel::INF, "Performing handshakes between unique and non-unique component(s) ..." );
-      this->PropagateConnectionsWithUniqueComponents();
+      this->m_Logger.Log( LogLevel::INF, "Performing handshakes between connected component(s) ..." );
+      this->PropagateConnectionConstraints();
       nonUniqueComponentNames = this->GetNonUniqueComponentNames();
       this->m_Logger.Log(  LogLevel::INF,
-                           "Performing handshakes between unique and non-unique component(s) ... Done. {0:d} out of {1:d} components were uniquely selected.",
-                           m_Blueprint.GetComponentNames().size()-nonUniqueComponentNames.size(),
-                           m_Blueprint.GetComponentNames().size() );
+                           "Performing handshakes between connected component(s) ... Done. {0:d} out of {1:d} components were uniquely selected.",
+                           m_Blueprint.GetNumberOfComponents()-nonUniqueComponentNames.size(),
+                           m_Blueprint.GetNumberOfComponents() );
+    }
+
+    if( nonUniqueComponentNames.empty() )
+    {
+      this->m_Logger.Log( LogLevel::INF, "Merging identical components ..." );
+      const std::size_t numberOfMergedComponents = this->EliminateCommonSubexpressions();
+      this->m_Logger.Log( LogLevel::INF, "Merging identical components ... Done. {0:d} component(s) merged.", numberOfMergedComponents );
     }
+    this->StoreConfiguration();
     this->m_isConfigured = true;
   }
 
@@ -88,7 +104,7 @@ NetworkBuilder< ComponentList >::Configure()
   // TODO: Print the available criteria
   if( nonUniqueComponentNames.size() > 0 )
   {
-    this->m_Logger.Log( LogLevel::CRT, ( this->m_Logger << nonUniqueComponentNames ) + " need more criteria." );
+    this->m_Logger.Log( LogLevel::CRT, "{0} need more criteria.", this->m_Logger << nonUniqueComponentNames );
     return false;
   }
 
@@ -96,22 +112,119 @@ NetworkBuilder< ComponentList >::Configure()
 }
 
 
+template< typename ComponentList >
+bool
+NetworkBuilder< ComponentList >::ConfigureFrom( const CompiledNetwork & compiledNetwork )
+{
+  if( this->m_isConfigured )
+  {
+    return this->GetNonUniqueComponentNames().empty();
+  }
+
+  Profiler::Scope scope( this->m_Profiler, "Configure", "phase" );
+  if( compiledNetwork.registryFingerprint != CompiledNetwork::Fingerprint( ComponentRegistry< ComponentList >::Get().GetPrototypes() ) )
+  {
+    std::string msg = "The network was compiled with different components than this build of SuperElastix. Recompile the blueprint.";
+    this->m_Logger.Log( LogLevel::CRT, msg );
+    throw std::runtime_error( msg );
+  }
+
+  this->m_Logger.Log( LogLevel::INF, "Instantiating compiled components ..." );
+  this->m_ComponentSelectorContainer.resize( this->m_Blueprint.GetNumberOfComponents() );
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_Blueprint.GetNumberOfComponents(); ++componentIndex )
+  {
+    const ComponentNameType & componentName = this->m_Blueprint.GetComponentName( componentIndex );
+    auto                      selected      = compiledNetwork.selectedComponents.find( componentName );
+    if( selected == compiledNetwork.selectedComponents.end() )
+    {
+      std::string msg = "Component " + componentName + " is not in the compiled network.";
+      this->m_Logger.Log( LogLevel::CRT, msg );
+      throw std::runtime_error( msg );
+    }
+    if( compiledNetwork.mergedComponents.count( componentName ) > 0 )
+    {
+      continue;
+    }
+
+    ComponentSelectorPointer componentSelector = std::make_shared< ComponentSelectorType >( componentName, this->m_Logger );
+    componentSelector->SelectCandidate( selected->second );
+    for( auto const & criterion : this->m_Blueprint.GetComponentParameterMap( componentIndex ) )
+    {
+      componentSelector->AddCriterion( criterion );
+    }
+
+    if( componentSelector->NumberOfComponents() == 0 )
+    {
+      std::string msg = "The compiled component for " + componentName + " does not fulfill its criteria.";
+      this->m_Logger.Log( LogLevel::CRT, msg );
+      throw std::runtime_error( msg );
+    }
+    this->m_ComponentSelectorContainer[ componentIndex ] = componentSelector;
+  }
+
+  for( auto const & merged : compiledNetwork.mergedComponents )
+  {
+    if( !this->m_Blueprint.ComponentExists( merged.second ) || compiledNetwork.mergedComponents.count( merged.second ) > 0 )
+    {
+      std::string msg = "Component " + merged.first + " is merged into unknown component " + merged.second + ".";
+      this->m_Logger.Log( LogLevel::CRT, msg );
+      throw std::runtime_error( msg );
+    }
+    const ComponentIndexType mergedIndex = this->m_Blueprint.GetComponentIndex( merged.first );
+    const ComponentIndexType intoIndex   = this->m_Blueprint.GetComponentIndex( merged.second );
+    this->m_MergedInto[ mergedIndex ]                 = intoIndex;
+    this->m_ComponentSelectorContainer[ mergedIndex ] = this->m_ComponentSelectorContainer[ intoIndex ];
+    ++this->m_NumberOfMergedComponents;
+  }
+  this->m_Logger.Log( LogLevel::INF, "Instantiating compiled components ... Done. {0:d} component(s) merged.", this->m_NumberOfMergedComponents );
+
+  this->StoreConfiguration();
+  this->m_isConfigured = true;
+  return true;
+}
+
+
+template< typename ComponentList >
+CompiledNetwork
+NetworkBuilder< ComponentList >::GetCompiledNetwork()
+{
+  if( !this->Configure() )
+  {
+    std::string msg = "Only a network of uniquely selected components can be compiled.";
+    this->m_Logger.Log( LogLevel::ERR, msg );
+    throw std::runtime_error( msg );
+  }
+
+  CompiledNetwork compiledNetwork;
+  compiledNetwork.registryFingerprint = CompiledNetwork::Fingerprint( ComponentRegistry< ComponentList >::Get().GetPrototypes() );
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_Blueprint.GetNumberOfComponents(); ++componentIndex )
+  {
+    const ComponentNameType & componentName = this->m_Blueprint.GetComponentName( componentIndex );
+    compiledNetwork.selectedComponents[ componentName ] = this->m_ComponentSelectorContainer[ componentIndex ]->GetSelectedIndex();
+    if( this->GetMergedInto( componentIndex ) != componentIndex )
+    {
+      compiledNetwork.mergedComponents[ componentName ] = this->m_Blueprint.GetComponentName( this->GetMergedInto( componentIndex ) );
+    }
+  }
+  return compiledNetwork;
+}
+
+
 template< typename ComponentList >
 NetworkBuilderBase::ComponentNamesType
 NetworkBuilder< ComponentList >::GetNonUniqueComponentNames()
 {
-  ComponentNamesType                  nonUniqueComponentNames;
-  const BlueprintImpl::ComponentNamesType componentNames = m_Blueprint.GetComponentNames();
-  for( auto const & name : componentNames )
+  ComponentNamesType nonUniqueComponentNames;
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_ComponentSelectorContainer.size(); ++componentIndex )
   {
     // The current idea of the configuration setup is that the number of
     // possible components at a node can only be reduced by adding criteria.
     // If a node has 0 possible components, the configuration is aborted (with an exception)
     // If all nodes have exactly 1 possible component, no more criteria are needed.
 
-    if( this->m_ComponentSelectorContainer[ name ]->NumberOfComponents() > 1 )
+    if( this->m_ComponentSelectorContainer[ componentIndex ]->NumberOfComponents() > 1 )
     {
-      nonUniqueComponentNames.push_back( name );
+      nonUniqueComponentNames.push_back( this->m_Blueprint.GetComponentName( componentIndex ) );
     }
   }
   return nonUniqueComponentNames;
@@ -141,34 +254,42 @@ NetworkBuilder< ComponentList >::ApplyComponentConfiguration()
   // realized components at each node and not the ComponentSelectors that,
   // in turn, hold 1 (or more) component.
 
-  for( auto const & componentName : this->m_Blueprint.GetComponentNames() )
+  this->m_ComponentSelectorContainer.resize( this->m_Blueprint.GetNumberOfComponents() );
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_Blueprint.GetNumberOfComponents(); ++componentIndex )
   {
-    ComponentSelectorPointer currentComponentSelector = std::make_shared< ComponentSelectorType >( componentName, this->m_Logger );
+    // insert new element
+    this->m_ComponentSelectorContainer[ componentIndex ] = this->CreateComponentSelector( componentIndex );
+  }
+  return;
+}
 
-    BlueprintImpl::ParameterMapType currentProperty = this->m_Blueprint.GetComponent( componentName );
-    for( auto const& criterion : currentProperty )
-    {
-      currentComponentSelector->AddCriterion( criterion );
-      
-      this->m_Logger.Log( LogLevel::DBG,
-                          "Finding component for '{0}': {1} component(s) satisfies {{ '{2}' : '{3}' }}  and previous criteria.",
-                          componentName,
-                          currentComponentSelector->NumberOfComponents(),
-                          criterion.first,
-                          this->m_Logger << criterion.second);
-    }
 
-    if( currentComponentSelector->NumberOfComponents() == 0 )
-    {
-      std::string msg = "No components fulfill all criteria for " + componentName + ".";
-      this->m_Logger.Log( LogLevel::CRT, msg );
-      throw std::runtime_error( msg );
-    }
+template< typename ComponentList >
+typename NetworkBuilder< ComponentList >::ComponentSelectorPointer
+NetworkBuilder< ComponentList >::CreateComponentSelector( ComponentIndexType componentIndex )
+{
+  const ComponentNameType & componentName            = this->m_Blueprint.GetComponentName( componentIndex );
+  ComponentSelectorPointer  currentComponentSelector = std::make_shared< ComponentSelectorType >( componentName, this->m_Logger );
 
-    // insert new element
-    this->m_ComponentSelectorContainer[ componentName ] = currentComponentSelector;
+  for( auto const& criterion : this->m_Blueprint.GetComponentParameterMap( componentIndex ) )
+  {
+    currentComponentSelector->AddCriterion( criterion );
+
+    this->m_Logger.Log( LogLevel::DBG,
+                        "Finding component for '{0}': {1} candidate(s) satisfies {{ '{2}' : '{3}' }}  and previous criteria.",
+                        componentName,
+                        currentComponentSelector->NumberOfCandidates(),
+                        criterion.first,
+                        this->m_Logger << criterion.second);
   }
-  return;
+
+  if( currentComponentSelector->NumberOfComponents() == 0 )
+  {
+    std::string msg = "No components fulfill all criteria for " + componentName + ".";
+    this->m_Logger.Log( LogLevel::CRT, msg );
+    throw std::runtime_error( msg );
+  }
+  return currentComponentSelector;
 }
 
 
@@ -184,161 +305,252 @@ NetworkBuilder< ComponentList >::ApplyConnectionConfiguration()
   // be e.g. that Dimensionality equals 3. The providing Component could have 1 (or more)
   // interface that is of that dimensionality and the accepting interface as well, but the
   // interfaces could still be of different types (including different other template arguments)
-  for( auto const & providingComponentName : this->m_Blueprint.GetComponentNames() )
+  for( auto const & connection : this->GetConnections() )
   {
-    for( auto const & acceptingComponentName : this->m_Blueprint.GetOutputNames( providingComponentName ) )
-    {
-      for ( auto const & connectionName : this->m_Blueprint.GetConnectionNames( providingComponentName, acceptingComponentName ) )
-      {
-        BlueprintImpl::ParameterMapType connectionProperties = this->m_Blueprint.GetConnection( providingComponentName, acceptingComponentName, connectionName );
+    this->ApplyConnectionCriteria( connection, true, true );
+  }
+}
 
-        // TODO: #110
-        ComponentBase::InterfaceCriteriaType interfaceCriteria;
-        for( const auto& connectionProperty : connectionProperties )
-        {
-          assert( connectionProperty.second.size() <= 1 );
-          if( connectionProperty.second.size() == 1 ) {
-            interfaceCriteria[connectionProperty.first] = connectionProperty.second[0];
-          }
-        }
 
-        // TODO: connectionName in log message
-        this->m_ComponentSelectorContainer[ providingComponentName ]->AddProvidingInterfaceCriteria( interfaceCriteria );
-        this->m_Logger.Log(LogLevel::DBG,
-          "Finding component for '{0}': {1} component(s) satisfies 'ProvidingInterface' {2} and previous criteria.",
-          providingComponentName,
-          this->m_ComponentSelectorContainer[providingComponentName]->NumberOfComponents(),
-          this->m_Logger << interfaceCriteria );
-
-        this->m_ComponentSelectorContainer[ acceptingComponentName ]->AddAcceptingInterfaceCriteria( interfaceCriteria );
-        this->m_Logger.Log(LogLevel::DBG,
-          "Finding component for '{0}': {1} component(s) satisfies 'AcceptingInterface' {2} and previous criteria.",
-          acceptingComponentName,
-          this->m_ComponentSelectorContainer[acceptingComponentName]->NumberOfComponents(),
-          this->m_Logger << interfaceCriteria );
-
-        if( this->m_ComponentSelectorContainer[ acceptingComponentName ]->NumberOfComponents() == 0 )
-        {
-          std::string msg = acceptingComponentName + "does not provide any connections with the given criteria.";
-          this->m_Logger.Log( LogLevel::ERR, msg );
-          throw std::runtime_error( msg );
-        }
+template< typename ComponentList >
+void
+NetworkBuilder< ComponentList >::ApplyConnectionCriteria( const ConnectionType & connection, bool applyToProviding, bool applyToAccepting )
+{
+  const ComponentNameType & providingComponentName = this->m_Blueprint.GetComponentName( connection.providing );
+  const ComponentNameType & acceptingComponentName = this->m_Blueprint.GetComponentName( connection.accepting );
+  auto &                    providingSelector      = this->m_ComponentSelectorContainer[ connection.providing ];
+  auto &                    acceptingSelector      = this->m_ComponentSelectorContainer[ connection.accepting ];
 
-        if( this->m_ComponentSelectorContainer[ providingComponentName ]->NumberOfComponents() == 0 )
-        {
-          std::string msg = providingComponentName + "does not accept any connections with the given criteria.";
-          this->m_Logger.Log( LogLevel::ERR, msg );
-          throw std::runtime_error( msg );
-        }
+  // TODO: connectionName in log message
+  if( applyToProviding )
+  {
+    providingSelector->AddProvidingInterfaceCriteria( connection.interfaceCriteria );
+    this->m_Logger.Log(LogLevel::DBG,
+      "Finding component for '{0}': {1} component(s) satisfies 'ProvidingInterface' {2} and previous criteria.",
+      providingComponentName,
+      providingSelector->NumberOfComponents(),
+      this->m_Logger << connection.interfaceCriteria );
+  }
+
+  if( applyToAccepting )
+  {
+    acceptingSelector->AddAcceptingInterfaceCriteria( connection.interfaceCriteria );
+    this->m_Logger.Log(LogLevel::DBG,
+      "Finding component for '{0}': {1} component(s) satisfies 'AcceptingInterface' {2} and previous criteria.",
+      acceptingComponentName,
+      acceptingSelector->NumberOfComponents(),
+      this->m_Logger << connection.interfaceCriteria );
+  }
+
+  if( acceptingSelector->NumberOfComponents() == 0 )
+  {
+    std::string msg = acceptingComponentName + "does not provide any connections with the given criteria.";
+    this->m_Logger.Log( LogLevel::ERR, msg );
+    throw std::runtime_error( msg );
+  }
+
+  if( providingSelector->NumberOfComponents() == 0 )
+  {
+    std::string msg = providingComponentName + "does not accept any connections with the given criteria.";
+    this->m_Logger.Log( LogLevel::ERR, msg );
+    throw std::runtime_error( msg );
+  }
+}
+
+
+template< typename ComponentList >
+const typename NetworkBuilder< ComponentList >::ConnectionContainerType &
+NetworkBuilder< ComponentList >::GetConnections()
+{
+  if( this->m_HasConnections )
+  {
+    return this->m_Connections;
+  }
+
+  auto connections = this->m_Blueprint.GetConnections();
+  for( auto connection = connections.first; connection != connections.second; ++connection )
+  {
+    const BlueprintImpl::ConnectionPropertyType & connectionProperty = this->m_Blueprint.GetConnectionProperty( *connection );
+
+    // TODO: #110
+    ComponentBase::InterfaceCriteriaType interfaceCriteria;
+    for( const auto & keyAndValues : connectionProperty.parameterMap )
+    {
+      assert( keyAndValues.second.size() <= 1 );
+      if( keyAndValues.second.size() > 0 )
+      {
+        interfaceCriteria[ keyAndValues.first ] = keyAndValues.second[ 0 ];
       }
     }
+
+    this->m_Connections.push_back( { *connection, this->m_Blueprint.GetUpstreamIndex( *connection ), this->m_Blueprint.GetDownstreamIndex( *connection ),
+                                     connectionProperty.name, interfaceCriteria } );
   }
+  this->m_HasConnections = true;
+  return this->m_Connections;
 }
 
 
 template< typename ComponentList >
 void
-NetworkBuilder< ComponentList >::PropagateConnectionsWithUniqueComponents()
+NetworkBuilder< ComponentList >::PropagateConnectionConstraints()
 {
-  // Narrow down the selection of non-uniquely selected components by finding all
-  // connections to a component that is uniquely selected and verifying the matching interface types.
-  bool anySelectionNarrowed( true );
+  // Narrow down the selection of non-uniquely selected components by arc consistency (AC-3) over the blueprint graph:
+  // a candidate is removed if none of the candidates at the other end of a connection has a matching interface.
+  // Each connection gives 2 arcs: one that narrows the providing component and one that narrows the accepting component.
+  // Only if a component is narrowed, the arcs that depend on its candidates are checked again.
+  struct Arc
+  {
+    ComponentIndexType                   component;         // the component that is narrowed
+    ComponentIndexType                   other;             // the component at the other end of the connection
+    bool                                 isProviding;       // whether component provides to other
+    ComponentBase::InterfaceCriteriaType interfaceCriteria;
+  };
+
+  std::vector< Arc >                        arcs;
+  std::vector< std::vector< std::size_t > > arcsByOther( this->m_Blueprint.GetNumberOfComponents() );
+  for( auto const & connection : this->GetConnections() )
+  {
+    // The 2 arcs of a connection are stored next to each other, such that the reverse arc of arc i is i ^ 1.
+    arcsByOther[ connection.accepting ].push_back( arcs.size() );
+    arcs.push_back( { connection.providing, connection.accepting, true, connection.interfaceCriteria } );
+    arcsByOther[ connection.providing ].push_back( arcs.size() );
+    arcs.push_back( { connection.accepting, connection.providing, false, connection.interfaceCriteria } );
+  }
 
-  while( anySelectionNarrowed )
+  std::deque< std::size_t > worklist;
+  std::vector< bool >       isQueued( arcs.size(), true );
+  for( std::size_t arcIndex = 0; arcIndex < arcs.size(); ++arcIndex )
   {
-    anySelectionNarrowed = false;
-    auto nonUniqueComponentNames = this->GetNonUniqueComponentNames();
-    for( auto const & componentName : nonUniqueComponentNames )
+    worklist.push_back( arcIndex );
+  }
+
+  while( !worklist.empty() )
+  {
+    const std::size_t arcIndex = worklist.front();
+    worklist.pop_front();
+    isQueued[ arcIndex ] = false;
+
+    const Arc &               arc               = arcs[ arcIndex ];
+    auto &                    componentSelector = this->m_ComponentSelectorContainer[ arc.component ];
+    auto &                    otherSelector     = this->m_ComponentSelectorContainer[ arc.other ];
+    const ComponentNameType & componentName     = this->m_Blueprint.GetComponentName( arc.component );
+    const ComponentNameType & otherName         = this->m_Blueprint.GetComponentName( arc.other );
+
+    // Uniquely selected components are not narrowed; a mismatch between them is reported by ConnectComponents.
+    const unsigned int beforeCriteria = componentSelector->NumberOfCandidates();
+    if( beforeCriteria <= 1 )
+    {
+      continue;
+    }
+
+    const std::string interfaceKind = arc.isProviding ? "ProvidingInterface" : "AcceptingInterface";
+    this->m_Logger.Log( LogLevel::DBG, "Propagating '{0}' properties from '{1}' to {3} components at '{2}' ... ", interfaceKind, otherName, componentName, beforeCriteria );
+    const unsigned int afterCriteria = arc.isProviding
+      ? componentSelector->RequireProvidingInterfaceTo( *otherSelector, arc.interfaceCriteria )
+      : componentSelector->RequireAcceptingInterfaceFrom( *otherSelector, arc.interfaceCriteria );
+    this->m_Logger.Log( LogLevel::DBG, "Propagating '{0}' properties from '{1}' to {3} components at '{2}' ... Done. Reduced '{2}' to {4} components", interfaceKind, otherName, componentName, beforeCriteria, afterCriteria );
+
+    if( afterCriteria == 0 )
     {
-      // check all components that accept from component "componentName"
-      for( auto const & acceptingComponentName : this->m_Blueprint.GetOutputNames( componentName ) )
+      std::string msg = arc.isProviding
+        ? "No component exists for '" + componentName + "' that has a suitable interface to provide to '" + otherName + "'"
+        : "No component exists for '" + componentName + "' that has a suitable interface to accept from '" + otherName + "'";
+      this->m_Logger.Log( LogLevel::ERR, msg );
+      throw std::runtime_error( msg );
+    }
+
+    if( afterCriteria < beforeCriteria )
+    {
+      // The removed candidates had no match at otherName, so the reverse arc needs no check.
+      for( auto const & dependentArcIndex : arcsByOther[ arc.component ] )
       {
-        // if the accepting component is also not uniquely selected, we do not try to check all valid combinations, since this would make the handshake logic too complicated
-        if( std::find( nonUniqueComponentNames.begin(), nonUniqueComponentNames.end(), acceptingComponentName ) == nonUniqueComponentNames.end() )
+        if( dependentArcIndex != ( arcIndex ^ 1 ) && !isQueued[ dependentArcIndex ] )
         {
-          for ( const auto & connectionName : this->m_Blueprint.GetConnectionNames( componentName, acceptingComponentName ) )
-          {
-            BlueprintImpl::ParameterMapType connectionProperties = this->m_Blueprint.GetConnection( componentName, acceptingComponentName, connectionName );
-
-            // TODO: #110
-            ComponentBase::InterfaceCriteriaType interfaceCriteria;
-            for( const auto& connectionProperty : connectionProperties )
-            {
-              assert( connectionProperty.second.size() <= 1 );
-              if( connectionProperty.second.size() == 1 ) {
-                interfaceCriteria[connectionProperty.first] = connectionProperty.second[0];
-              }
-            }
-
-            // TODO: connectionName in log message
-            auto               acceptingComponent = this->m_ComponentSelectorContainer[ acceptingComponentName ]->GetComponent();
-            const unsigned int beforeCriteria    = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
-            this->m_Logger.Log( LogLevel::DBG, "Propagating 'ProvidingInterface' properties from '{0}' to {2} components at '{1}' ... ", componentName, acceptingComponentName, beforeCriteria );
-            this->m_ComponentSelectorContainer[ componentName ]->RequireProvidingInterfaceTo( acceptingComponent, interfaceCriteria );
-            const unsigned int afterCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
-            this->m_Logger.Log( LogLevel::DBG, "Propagating 'ProvidingInterface' properties from '{0}' to {2} components at '{1}' ... Done. Reduced '{1}' to {3} components", componentName, acceptingComponentName, beforeCriteria, afterCriteria );
-
-            if( beforeCriteria > afterCriteria )
-            {
-              anySelectionNarrowed = true;
-            }
-            this->m_Logger.Log( LogLevel::TRC, "Selection Narrowed: {} ", anySelectionNarrowed );
-            
-            if (afterCriteria == 0)
-            {
-              std::string msg = "No component exists for '" + componentName + "' that has a suitable interface to provide to '" + acceptingComponentName + "'" ;
-              this->m_Logger.Log(LogLevel::ERR, msg);
-              throw std::runtime_error( msg );
-            }
-          }
+          isQueued[ dependentArcIndex ] = true;
+          worklist.push_back( dependentArcIndex );
         }
       }
-      // check all components that provide to component "componentName"
-      for( auto const & providingComponentName : this->m_Blueprint.GetInputNames( componentName ) )
+    }
+  }
+}
+
+
+template< typename ComponentList >
+std::size_t
+NetworkBuilder< ComponentList >::EliminateCommonSubexpressions()
+{
+  // The signature of a component describes its type, criteria and incoming connections. Strings are length-prefixed, like in the
+  // canonical description of a blueprint, such that different components never get the same signature. In the update order the
+  // components upstream are merged first, such that identical subgraphs are merged as a whole.
+  auto writeString = []( std::ostream & out, const std::string & value ){
+      out << value.size() << ':' << value;
+    };
+  auto writeParameterMap = [ &writeString ]( std::ostream & out, const BlueprintImpl::ParameterMapType & parameterMap ){
+      out << '{';
+      for( auto const & keyAndValues : parameterMap )
       {
-        // if the providing component is also not uniquely selected, we do not try to check all valid combinations, since this would make the handshake logic too complicated
-        if( std::find( nonUniqueComponentNames.begin(), nonUniqueComponentNames.end(), providingComponentName ) == nonUniqueComponentNames.end() )
+        writeString( out, keyAndValues.first );
+        out << '[';
+        for( auto const & value : keyAndValues.second )
         {
-          for (const auto & connectionName : this->m_Blueprint.GetConnectionNames( providingComponentName, componentName ) )
-          {
-            BlueprintImpl::ParameterMapType connectionProperties = this->m_Blueprint.GetConnection( providingComponentName, componentName, connectionName);
-
-            // TODO:#110
-            ComponentBase::InterfaceCriteriaType interfaceCriteria;
-            for( const auto& connectionProperty : connectionProperties )
-            {
-              assert( connectionProperty.second.size() <= 1 );
-              if( connectionProperty.second.size() == 1 ) {
-                interfaceCriteria[connectionProperty.first] = connectionProperty.second[0];
-              }
-            }
-
-            // TODO(FB): Use this to provide more info to user
-            auto providingComponent = this->m_ComponentSelectorContainer[ providingComponentName ]->GetComponent();
-
-            const unsigned int beforeCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
-            this->m_Logger.Log(LogLevel::DBG, "Propagating 'AcceptingInterface' properties from '{0}' to {2} components at '{1}' ... ", componentName, providingComponentName, beforeCriteria);
-            this->m_ComponentSelectorContainer[ componentName ]->RequireAcceptingInterfaceFrom( providingComponent, interfaceCriteria );
-            const unsigned int afterCriteria = this->m_ComponentSelectorContainer[ componentName ]->NumberOfComponents();
-            this->m_Logger.Log(LogLevel::DBG, "Propagating 'AcceptingInterface' properties from '{0}' to {2} components at '{1}' ... Done. Reduced '{1}' to {3} components", componentName, providingComponentName, beforeCriteria, afterCriteria);
-
-            if( beforeCriteria > afterCriteria )
-            {
-              anySelectionNarrowed = true;
-            }
-            this->m_Logger.Log( LogLevel::TRC, "Selection Narrowed: {} ", anySelectionNarrowed );
-            if (afterCriteria == 0)
-            {
-              std::string msg = "No component exists for '" + componentName + "' that has a suitable interface to accept from '" + providingComponentName + "'";
-              this->m_Logger.Log(LogLevel::ERR, msg);
-              throw std::runtime_error(msg);
-            }
-
-          }
+          writeString( out, value );
         }
+        out << ']';
       }
+      out << '}';
+    };
+
+  // The incoming connections of each component
+  std::vector< std::vector< const ConnectionType * > > inputConnections( this->m_Blueprint.GetNumberOfComponents() );
+  for( auto const & connection : this->GetConnections() )
+  {
+    inputConnections[ connection.accepting ].push_back( &connection );
+  }
+
+  std::map< std::string, ComponentIndexType > componentsBySignature;
+  for( const auto & componentIndex : this->m_Blueprint.GetUpdateOrderIndices() )
+  {
+    ComponentBase::Pointer component = this->GetComponent( componentIndex );
+    // Sources and Sinks are the distinct inputs and outputs of the network
+    if( !component->CanBeShared()
+      || component->CountProvidingInterfaces( { { keys::NameOfInterface, keys::SourceInterface } } ) > 0
+      || component->CountProvidingInterfaces( { { keys::NameOfInterface, keys::SinkInterface } } ) > 0 )
+    {
+      continue;
+    }
+
+    std::ostringstream signature;
+    writeString( signature, typeid( *component ).name() );
+    writeParameterMap( signature, this->m_Blueprint.GetComponentParameterMap( componentIndex ) );
+
+    // The connections are sorted, since the order of the inputs is arbitrary.
+    std::vector< std::string > connections;
+    for( const auto & connection : inputConnections[ componentIndex ] )
+    {
+      std::ostringstream connectionSignature;
+      connectionSignature << this->GetMergedInto( connection->providing ) << ':';
+      writeString( connectionSignature, connection->name );
+      writeParameterMap( connectionSignature, this->m_Blueprint.GetConnectionProperty( connection->index ).parameterMap );
+      connections.push_back( connectionSignature.str() );
+    }
+    std::sort( connections.begin(), connections.end() );
+    for( const auto & connection : connections )
+    {
+      signature << 'E' << connection;
+    }
+
+    const auto identical = componentsBySignature.emplace( signature.str(), componentIndex );
+    if( !identical.second )
+    {
+      this->m_Logger.Log( LogLevel::DBG, "Merging '{0}' into the identical component '{1}'.", this->m_Blueprint.GetComponentName( componentIndex ),
+        this->m_Blueprint.GetComponentName( identical.first->second ) );
+      this->m_MergedInto[ componentIndex ]                 = identical.first->second;
+      this->m_ComponentSelectorContainer[ componentIndex ] = this->m_ComponentSelectorContainer[ identical.first->second ];
+      ++this->m_NumberOfMergedComponents;
     }
   }
+  return this->m_NumberOfMergedComponents;
 }
 
 
@@ -346,55 +558,54 @@ template< typename ComponentList >
 bool
 NetworkBuilder< ComponentList >::ConnectComponents()
 {
-  bool isAllSuccess = true;
+  if( this->m_isConnected )
+  {
+    return this->m_AllConnectionsSucceeded;
+  }
 
-  for( auto const & providingComponentName : this->m_Blueprint.GetComponentNames() )
+  Profiler::Scope scope( this->m_Profiler, "ConnectComponents", "phase" );
+  bool            isAllSuccess = true;
+
+  for( auto const & connection : this->GetConnections() )
   {
-    for( auto const & acceptingComponentName : this->m_Blueprint.GetOutputNames( providingComponentName ) )
+    // A merged component has the same inputs as the component it is merged into, which are connected already. After Reconfigure
+    // only the reconfigured components are connected.
+    if( this->GetMergedInto( connection.accepting ) != connection.accepting || this->m_ConnectedComponents[ connection.accepting ] )
     {
-      // GetComponent returns NULL if possible components !=1. We assume ComponentSelectorContainers have unique components since Configure().
-      ComponentBase::Pointer providingComponent = this->m_ComponentSelectorContainer[ providingComponentName ]->GetComponent();
-      ComponentBase::Pointer acceptingComponent = this->m_ComponentSelectorContainer[ acceptingComponentName ]->GetComponent();
+      continue;
+    }
 
-      // multiple parallel 'named' connections between 2 components can exist
-      auto connectionNames = this->m_Blueprint.GetConnectionNames( providingComponentName, acceptingComponentName );
-      for ( auto connectionName : connectionNames )
-      {
-        BlueprintImpl::ParameterMapType          connectionProperties = this->m_Blueprint.GetConnection( providingComponentName, acceptingComponentName, connectionName );
-      
-        // TODO:#110
-        ComponentBase::InterfaceCriteriaType interfaceCriteria;
-        std::for_each( connectionProperties.begin(), connectionProperties.end(), [ &interfaceCriteria ](
-            BlueprintImpl::ParameterMapType::value_type kv ) mutable {
-            if( kv.second.size() > 0 )
-            {
-              interfaceCriteria[ kv.first ] = kv.second[ 0 ];
-            }
-          } );
-
-        std::string message1, message2;
-        if (connectionNames.size() > 1) // specialize log messages if multiple parallel connections exist
-        {
-          message1 = "Connect '{0}' to '{1}' by connection '{2}' ... ";
-          message2 = "Connect '{0}' to '{1}' by connection '{3}' ... Done, by {2} interface(s).";
-        }
-        else
-        {
-          message1 = "Connect '{0}' to '{1}' ... ";
-          message2 = "Connect '{0}' to '{1}' ... Done, by {2} interface(s).";
+    const ComponentNameType & providingComponentName = this->m_Blueprint.GetComponentName( connection.providing );
+    const ComponentNameType & acceptingComponentName = this->m_Blueprint.GetComponentName( connection.accepting );
 
-        }
-        this->m_Logger.Log(LogLevel::DBG, message1 , providingComponentName, acceptingComponentName, connectionName);
-        int numberOfConnections = acceptingComponent->AcceptConnectionFrom(providingComponent, interfaceCriteria);
-        this->m_Logger.Log(LogLevel::DBG, message2 , providingComponentName, acceptingComponentName, numberOfConnections, connectionName);
-        if( numberOfConnections == 0 )
-        {
-          isAllSuccess = false;
-          this->m_Logger.Log( LogLevel::CRT, "Connection from '{0}' to '{1}' was specified but no compatible interfaces were found.", providingComponentName, acceptingComponentName);
-        }
-      }
+    // GetComponent returns NULL if possible components !=1. We assume ComponentSelectorContainers have unique components since Configure().
+    ComponentBase::Pointer providingComponent = this->GetComponent( connection.providing );
+    ComponentBase::Pointer acceptingComponent = this->GetComponent( connection.accepting );
+
+    // multiple parallel 'named' connections between 2 components can exist
+    std::string message1, message2;
+    if( !connection.name.empty() ) // specialize log messages for named connections
+    {
+      message1 = "Connect '{0}' to '{1}' by connection '{2}' ... ";
+      message2 = "Connect '{0}' to '{1}' by connection '{3}' ... Done, by {2} interface(s).";
+    }
+    else
+    {
+      message1 = "Connect '{0}' to '{1}' ... ";
+      message2 = "Connect '{0}' to '{1}' ... Done, by {2} interface(s).";
+    }
+    this->m_Logger.Log(LogLevel::DBG, message1 , providingComponentName, acceptingComponentName, connection.name);
+    int numberOfConnections = acceptingComponent->AcceptConnectionFrom(providingComponent, connection.interfaceCriteria);
+    this->m_Logger.Log(LogLevel::DBG, message2 , providingComponentName, acceptingComponentName, numberOfConnections, connection.name);
+    if( numberOfConnections == 0 )
+    {
+      isAllSuccess = false;
+      this->m_Logger.Log( LogLevel::CRT, "Connection from '{0}' to '{1}' was specified but no compatible interfaces were found.", providingComponentName, acceptingComponentName);
     }
   }
+  this->m_ConnectedComponents.assign( this->m_Blueprint.GetNumberOfComponents(), true );
+  this->m_isConnected = true;
+  this->m_AllConnectionsSucceeded = isAllSuccess;
   return isAllSuccess;
 }
 
@@ -406,10 +617,11 @@ NetworkBuilder< ComponentList >::CheckConnectionsSatisfied()
   bool isAllSatisfied = true;
 
   // TODO: Print the unsatisfied connections
-  for( auto const & name : this->m_Blueprint.GetComponentNames() )
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_ComponentSelectorContainer.size(); ++componentIndex )
   {
-    ComponentBase::Pointer component   = this->m_ComponentSelectorContainer[ name ]->GetComponent();
-    bool                   isSatisfied = component->ConnectionsSatisfied();
+    const ComponentNameType & name        = this->m_Blueprint.GetComponentName( componentIndex );
+    ComponentBase::Pointer    component   = this->GetComponent( componentIndex );
+    bool                      isSatisfied = component->ConnectionsSatisfied();
     if( isSatisfied == false )
     {
       isAllSatisfied = false;
@@ -427,12 +639,13 @@ NetworkBuilder< ComponentList >::GetSourceInterfaces()
   /** Scans all Components to find those with Sourcing capability and store them in SourceComponents list */
 
   SourceInterfaceMapType sourceInterfaceMap;
-  for( const auto & componentSelector : this->m_ComponentSelectorContainer )
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_ComponentSelectorContainer.size(); ++componentIndex )
   {
-    ComponentBase::Pointer component = componentSelector.second->GetComponent();
+    const ComponentNameType & componentName = this->m_Blueprint.GetComponentName( componentIndex );
+    ComponentBase::Pointer    component     = this->GetComponent( componentIndex );
 
     if(component == nullptr) {
-      std::string msg = "No component found for '" + componentSelector.first + "'.";
+      std::string msg = "No component found for '" + componentName + "'.";
       this->m_Logger.Log( LogLevel::CRT, msg );
       throw std::runtime_error(msg);
     }
@@ -445,7 +658,7 @@ NetworkBuilder< ComponentList >::GetSourceInterfaces()
         this->m_Logger.Log( LogLevel::CRT, "dynamic_cast<SourceInterface*> fails, but based on component criterion it shouldn't" );
         throw std::runtime_error( "dynamic_cast<SourceInterface*> fails, but based on component criterion it shouldn't" );
       }
-      sourceInterfaceMap[ componentSelector.first ] = provingSourceInterface;
+      sourceInterfaceMap[ componentName ] = provingSourceInterface;
     }
   }
   return sourceInterfaceMap;
@@ -459,12 +672,13 @@ NetworkBuilder< ComponentList >::GetSinkInterfaces()
   /** Scans all Components to find those with Sinking capability and store them in SinkComponents list */
 
   SinkInterfaceMapType sinkInterfaceMap;
-  for( auto const & componentSelector : this->m_ComponentSelectorContainer )
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_ComponentSelectorContainer.size(); ++componentIndex )
   {
-    ComponentBase::Pointer component = componentSelector.second->GetComponent();
+    const ComponentNameType & componentName = this->m_Blueprint.GetComponentName( componentIndex );
+    ComponentBase::Pointer    component     = this->GetComponent( componentIndex );
 
     if(component == nullptr) {
-      std::string msg = "No component found for '" + componentSelector.first + "'.";
+      std::string msg = "No component found for '" + componentName + "'.";
       this->m_Logger.Log( LogLevel::CRT, msg );
       throw std::runtime_error(msg);
     }
@@ -477,7 +691,7 @@ NetworkBuilder< ComponentList >::GetSinkInterfaces()
         this->m_Logger.Log(LogLevel::CRT, "dynamic_cast<SinkInterface*> fails, but based on component criterion it shouldn't");
         throw std::runtime_error( "dynamic_cast<SinkInterface*> fails, but based on component criterion it shouldn't" );
       }
-      sinkInterfaceMap[ componentSelector.first ] = provingSinkInterface;
+      sinkInterfaceMap[ componentName ] = provingSinkInterface;
     }
   }
   return sinkInterfaceMap;
@@ -536,9 +750,14 @@ NetworkBuilder< ComponentList >::GetInitializedOutput( const NetworkBuilderBase:
 
 
 template< typename ComponentList >
-NetworkContainer
+NetworkContainer &
 NetworkBuilder< ComponentList >::GetRealizedNetwork()
 {
+  if( this->m_RealizedNetwork )
+  {
+    return *this->m_RealizedNetwork;
+  }
+
   // vector that stores all components
   NetworkContainer::ComponentContainerType components;
   NetworkContainer::UpdateOrderType updateOrder;
@@ -546,10 +765,17 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
 
   if( this->Configure() )
   {
-    for( const auto & componentSelector : this->m_ComponentSelectorContainer )
+    const ComponentIndicesType componentUpdateOrder = this->m_Blueprint.GetUpdateOrderIndices();
+    for( ComponentIndexType componentIndex = 0; componentIndex < this->m_ComponentSelectorContainer.size(); ++componentIndex )
     {
+      // A merged component is stored once, under the name it is merged into
+      if( this->GetMergedInto( componentIndex ) != componentIndex )
+      {
+        continue;
+      }
+
       //store all components
-      ComponentBase::Pointer component = componentSelector.second->GetComponent();
+      ComponentBase::Pointer component = this->GetComponent( componentIndex );
       components.push_back( component );
 
       /** Scans all Components to find those with Sinking capability and store the outputs in outputObjectsMap */
@@ -561,13 +787,19 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
           this->m_Logger.Log(LogLevel::CRT, "dynamic_cast<SinkInterface*> fails, but based on component criterion it shouldn't");
           throw std::runtime_error( "dynamic_cast<SinkInterface*> fails, but based on component criterion it shouldn't" );
         }
-        outputObjectsMap[ componentSelector.first ] = provingSinkInterface->GetMiniPipelineOutput();
+        outputObjectsMap[ this->m_Blueprint.GetComponentName( componentIndex ) ] = provingSinkInterface->GetMiniPipelineOutput();
       }
     }
 
-    for (const auto & componentName : this->m_Blueprint.GetUpdateOrder())
+    for (const auto & componentIndex : componentUpdateOrder)
     {
-      auto component = this->m_ComponentSelectorContainer[componentName]->GetComponent();
+      // A merged component shares its instance with the component it is merged into, which is updated once
+      if( this->GetMergedInto( componentIndex ) != componentIndex )
+      {
+        continue;
+      }
+
+      auto component = this->GetComponent( componentIndex );
       if (component->CountProvidingInterfaces({ { keys::NameOfInterface, keys::UpdateInterface } }) == 1)
       {
         auto provingUpdateInterface = std::dynamic_pointer_cast<UpdateInterface>(component);
@@ -577,6 +809,7 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
           throw std::runtime_error("dynamic_cast<provingUpdateInterface*> fails, but based on component criterion it shouldn't");
         }
         // check if the UpdateInterface has been connected to a (controller) component. If so don't take over the control by adding it into updateOrder.
+        // A component that is kept by Reconfigure is controlled by the network already.
         auto connectionInfoUpdateInterface = std::dynamic_pointer_cast<ConnectionInfo<UpdateInterface>>(component);
         
         if (connectionInfoUpdateInterface->GetProvidedTo().size() == 0)
@@ -584,10 +817,208 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
           updateOrder.push_back(provingUpdateInterface);
           connectionInfoUpdateInterface->SetProvidedTo("NetworkBuilder");
         }
+        else if( connectionInfoUpdateInterface->GetProvidedTo() == std::vector< std::string >( { "NetworkBuilder" } ) )
+        {
+          updateOrder.push_back(provingUpdateInterface);
+        }
+      }
+    }
+
+    // The adjacency of the components, by id
+    const std::size_t                 numberOfComponents = this->m_Blueprint.GetNumberOfComponents();
+    std::vector< ComponentIndicesType > inputIndices( numberOfComponents );
+    std::vector< ComponentIndicesType > outputIndices( numberOfComponents );
+    for( const auto & connection : this->GetConnections() )
+    {
+      inputIndices[ connection.accepting ].push_back( connection.providing );
+      outputIndices[ connection.providing ].push_back( connection.accepting );
+    }
+
+    // The blueprint graph determines which updates depend on each other: an updating component depends on the nearest
+    // updating components upstream, possibly via components that do not update themselves.
+    const std::size_t          noUpdate = std::numeric_limits< std::size_t >::max();
+    std::vector< std::size_t > updateIndices( numberOfComponents, noUpdate );
+    for( const auto & componentIndex : componentUpdateOrder )
+    {
+      auto updateInterface = std::dynamic_pointer_cast< UpdateInterface >( this->GetComponent( componentIndex ) );
+      auto updateEntry = std::find( updateOrder.begin(), updateOrder.end(), updateInterface );
+      if( updateInterface && updateEntry != updateOrder.end() )
+      {
+        updateIndices[ componentIndex ] = std::distance( updateOrder.begin(), updateEntry );
+      }
+    }
+
+    // The updates that reach a component that does not update itself, e.g. an itk filter of which the pipeline is updated on demand
+    std::vector< std::vector< std::size_t >> sharingUpdates( numberOfComponents );
+
+    NetworkContainer::UpdateDependenciesType updateDependencies( updateOrder.size() );
+    for( ComponentIndexType updatingIndex = 0; updatingIndex < numberOfComponents; ++updatingIndex )
+    {
+      if( updateIndices[ updatingIndex ] == noUpdate )
+      {
+        continue;
+      }
+      std::vector< bool >  visited( numberOfComponents, false );
+      ComponentIndicesType upstream = inputIndices[ updatingIndex ];
+      while( !upstream.empty() )
+      {
+        const ComponentIndexType componentIndex = upstream.back();
+        upstream.pop_back();
+        if( visited[ componentIndex ] )
+        {
+          continue;
+        }
+        visited[ componentIndex ] = true;
+        if( updateIndices[ componentIndex ] != noUpdate )
+        {
+          updateDependencies[ updateIndices[ updatingIndex ] ].push_back( updateIndices[ componentIndex ] );
+        }
+        else
+        {
+          sharingUpdates[ componentIndex ].push_back( updateIndices[ updatingIndex ] );
+          upstream.insert( upstream.end(), inputIndices[ componentIndex ].begin(), inputIndices[ componentIndex ].end() );
+        }
+      }
+    }
+    // Merged components share their update index, which would otherwise give duplicate dependencies.
+    for( auto & dependencies : updateDependencies )
+    {
+      std::sort( dependencies.begin(), dependencies.end() );
+      dependencies.erase( std::unique( dependencies.begin(), dependencies.end() ), dependencies.end() );
+    }
+
+    // Independent updates that reach the same component that does not update itself would update its pipeline concurrently, so
+    // the parallel execution serializes them. The data of Sources is brought up to date before Execute.
+    NetworkContainer::SerializedUpdatesType serializedUpdates;
+    for( ComponentIndexType componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+    {
+      auto & updates = sharingUpdates[ componentIndex ];
+      std::sort( updates.begin(), updates.end() );
+      updates.erase( std::unique( updates.begin(), updates.end() ), updates.end() );
+      if( updates.size() > 1
+        && this->GetComponent( componentIndex )->CountProvidingInterfaces( { { keys::NameOfInterface, keys::SourceInterface } } ) == 0 )
+      {
+        serializedUpdates.push_back( updates );
+      }
+    }
+    std::sort( serializedUpdates.begin(), serializedUpdates.end() );
+    serializedUpdates.erase( std::unique( serializedUpdates.begin(), serializedUpdates.end() ), serializedUpdates.end() );
+
+    // Each Sink output depends on all updating components upstream of it, such that the network can update only the requested outputs.
+    NetworkContainer::OutputDependenciesType outputDependencies;
+    for( const auto & nameAndObject : outputObjectsMap )
+    {
+      auto &               dependencies = outputDependencies[ nameAndObject.first ];
+      std::vector< bool >  visited( numberOfComponents, false );
+      ComponentIndicesType upstream = { this->m_Blueprint.GetComponentIndex( nameAndObject.first ) };
+      while( !upstream.empty() )
+      {
+        const ComponentIndexType componentIndex = upstream.back();
+        upstream.pop_back();
+        if( visited[ componentIndex ] )
+        {
+          continue;
+        }
+        visited[ componentIndex ] = true;
+        if( updateIndices[ componentIndex ] != noUpdate )
+        {
+          dependencies.push_back( updateIndices[ componentIndex ] );
+        }
+        upstream.insert( upstream.end(), inputIndices[ componentIndex ].begin(), inputIndices[ componentIndex ].end() );
+      }
+    }
+
+    // Liveness of the data of components that can release it: the data is used by the component itself if it updates, and by the
+    // nearest updating components downstream. Data that flows into the mini pipeline of a Sink without an update in between is
+    // used after Execute: the NetworkContainer then releases it only on ReleaseData.
+    NetworkContainer::ReleaseDataType releaseData;
+    for( ComponentIndexType releasingIndex = 0; releasingIndex < numberOfComponents; ++releasingIndex )
+    {
+      ComponentBase::Pointer component = this->GetComponent( releasingIndex );
+      if( this->GetMergedInto( releasingIndex ) != releasingIndex
+        || component->CountProvidingInterfaces( { { keys::NameOfInterface, keys::ReleaseDataInterface } } ) != 1 )
+      {
+        continue;
+      }
+      auto providingReleaseDataInterface = std::dynamic_pointer_cast< ReleaseDataInterface >( component );
+      if( !providingReleaseDataInterface )   // is actually a double-check for sanity: based on criterion cast should be successful
+      {
+        this->m_Logger.Log( LogLevel::CRT, "dynamic_cast<ReleaseDataInterface*> fails, but based on component criterion it shouldn't" );
+        throw std::runtime_error( "dynamic_cast<ReleaseDataInterface*> fails, but based on component criterion it shouldn't" );
+      }
+
+      std::vector< std::size_t > uses;
+      bool                       usedAfterExecute = false;
+      if( updateIndices[ releasingIndex ] != noUpdate )
+      {
+        uses.push_back( updateIndices[ releasingIndex ] );
+      }
+      // The outputs of the components merged into this one are outputs of this one as well
+      std::vector< bool >  visited( numberOfComponents, false );
+      ComponentIndicesType downstream;
+      for( ComponentIndexType mergedIndex = 0; mergedIndex < numberOfComponents; ++mergedIndex )
+      {
+        if( this->GetMergedInto( mergedIndex ) == releasingIndex )
+        {
+          downstream.insert( downstream.end(), outputIndices[ mergedIndex ].begin(), outputIndices[ mergedIndex ].end() );
+        }
+      }
+      while( !downstream.empty() )
+      {
+        const ComponentIndexType componentIndex = downstream.back();
+        downstream.pop_back();
+        if( visited[ componentIndex ] )
+        {
+          continue;
+        }
+        visited[ componentIndex ] = true;
+        if( updateIndices[ componentIndex ] != noUpdate )
+        {
+          uses.push_back( updateIndices[ componentIndex ] );
+          continue;
+        }
+        if( outputIndices[ componentIndex ].empty() )
+        {
+          usedAfterExecute = true;
+        }
+        downstream.insert( downstream.end(), outputIndices[ componentIndex ].begin(), outputIndices[ componentIndex ].end() );
       }
+      releaseData.emplace_back( providingReleaseDataInterface, usedAfterExecute ? std::vector< std::size_t >() : uses );
     }
 
-    return NetworkContainer( components, updateOrder, outputObjectsMap );
+    // Components that can stop their update early get the cancellation token of each execution
+    NetworkContainer::CancellationInterfacesType cancellationInterfaces;
+    for( const auto & component : components )
+    {
+      if( component->CountProvidingInterfaces( { { keys::NameOfInterface, keys::CancellationInterface } } ) != 1 )
+      {
+        continue;
+      }
+      auto providingCancellationInterface = std::dynamic_pointer_cast< CancellationInterface >( component );
+      if( !providingCancellationInterface )   // is actually a double-check for sanity: based on criterion cast should be successful
+      {
+        this->m_Logger.Log( LogLevel::CRT, "dynamic_cast<CancellationInterface*> fails, but based on component criterion it shouldn't" );
+        throw std::runtime_error( "dynamic_cast<CancellationInterface*> fails, but based on component criterion it shouldn't" );
+      }
+      cancellationInterfaces.push_back( providingCancellationInterface );
+    }
+
+    this->m_RealizedNetwork.reset( new NetworkContainer( components, updateOrder, outputObjectsMap, updateDependencies, outputDependencies,
+      releaseData, cancellationInterfaces, serializedUpdates ) );
+
+    // The results of the components that were kept by Reconfigure
+    std::vector< bool > upToDate( updateOrder.size(), false );
+    for( ComponentIndexType componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+    {
+      if( updateIndices[ componentIndex ] != noUpdate && this->m_UpToDateComponents[ componentIndex ] )
+      {
+        upToDate[ updateIndices[ componentIndex ] ] = true;
+      }
+    }
+    this->m_RealizedNetwork->SetUpToDate( upToDate );
+    this->m_UpToDateComponents.assign( numberOfComponents, false );
+    this->m_UpdateIndices = updateIndices;
+    return *this->m_RealizedNetwork;
   }
   else
   {
@@ -595,19 +1026,160 @@ NetworkBuilder< ComponentList >::GetRealizedNetwork()
     msg << "Network is not realized yet";
     this->m_Logger.Log(LogLevel::ERR, "{}", msg.str() );
     throw std::runtime_error( msg.str() );
-    return NetworkContainer( components, updateOrder, outputObjectsMap );
   }
 
 
 }
 
+template< typename ComponentList >
+bool
+NetworkBuilder< ComponentList >::Reconfigure( ComponentNamesType & reconfiguredComponentNames )
+{
+  reconfiguredComponentNames.clear();
+  if( !this->m_isConfigured )
+  {
+    return false;
+  }
+
+  // The components and connections must be the same, only their parameter maps may be modified. Connections are compared by
+  // their interface criteria, since these are all that the network uses.
+  const std::size_t numberOfComponents = this->m_Blueprint.GetNumberOfComponents();
+  if( numberOfComponents != this->m_ConfiguredComponents.size() )
+  {
+    return false;
+  }
+  for( ComponentIndexType componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+  {
+    if( this->m_Blueprint.GetComponentName( componentIndex ) != this->m_ConfiguredComponents[ componentIndex ].name )
+    {
+      return false;
+    }
+  }
+  typedef std::tuple< ComponentIndexType, ComponentIndexType, BlueprintImpl::ConnectionNameType, ComponentBase::InterfaceCriteriaType > ConnectionKeyType;
+  auto connectionKeys = []( const ConnectionContainerType & connections ){
+      std::vector< ConnectionKeyType > keys;
+      for( const auto & connection : connections )
+      {
+        keys.emplace_back( connection.providing, connection.accepting, connection.name, connection.interfaceCriteria );
+      }
+      std::sort( keys.begin(), keys.end() );
+      return keys;
+    };
+  const auto configuredConnectionKeys = connectionKeys( this->m_Connections );
+  this->m_Connections.clear();
+  this->m_HasConnections = false;
+  if( connectionKeys( this->GetConnections() ) != configuredConnectionKeys )
+  {
+    return false;
+  }
+
+  // The modified components, the components merged with them and all components downstream are reconfigured
+  std::vector< ComponentIndicesType > outputIndices( numberOfComponents );
+  for( const auto & connection : this->GetConnections() )
+  {
+    outputIndices[ connection.providing ].push_back( connection.accepting );
+  }
+  std::vector< bool >  isReconfigured( numberOfComponents, false );
+  ComponentIndicesType modified;
+  for( ComponentIndexType componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+  {
+    if( this->m_Blueprint.GetComponentParameterMap( componentIndex ) != this->m_ConfiguredComponents[ componentIndex ].parameterMap )
+    {
+      modified.push_back( componentIndex );
+    }
+  }
+  if( modified.empty() )
+  {
+    return true;
+  }
+  while( !modified.empty() )
+  {
+    const ComponentIndexType componentIndex = modified.back();
+    modified.pop_back();
+    if( isReconfigured[ componentIndex ] )
+    {
+      continue;
+    }
+    isReconfigured[ componentIndex ] = true;
+    modified.insert( modified.end(), outputIndices[ componentIndex ].begin(), outputIndices[ componentIndex ].end() );
+    for( ComponentIndexType mergedIndex = 0; mergedIndex < numberOfComponents; ++mergedIndex )
+    {
+      if( this->GetMergedInto( mergedIndex ) == this->GetMergedInto( componentIndex ) )
+      {
+        modified.push_back( mergedIndex );
+      }
+    }
+  }
+
+  // The updates of the components that are kept are up to date if they were so in the network that was realized, if any
+  for( ComponentIndexType componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+  {
+    if( this->m_RealizedNetwork )
+    {
+      this->m_UpToDateComponents[ componentIndex ] = this->m_UpdateIndices[ componentIndex ] != std::numeric_limits< std::size_t >::max()
+        && this->m_RealizedNetwork->GetUpToDate()[ this->m_UpdateIndices[ componentIndex ] ];
+    }
+    this->m_UpToDateComponents[ componentIndex ] = this->m_UpToDateComponents[ componentIndex ] && !isReconfigured[ componentIndex ];
+  }
+
+  // The reconfigured components are selected anew, without merging
+  Profiler::Scope scope( this->m_Profiler, "Configure", "phase" );
+  for( ComponentIndexType componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+  {
+    if( isReconfigured[ componentIndex ] )
+    {
+      this->m_ComponentSelectorContainer[ componentIndex ] = this->CreateComponentSelector( componentIndex );
+      this->m_NumberOfMergedComponents -= this->GetMergedInto( componentIndex ) != componentIndex ? 1 : 0;
+      this->m_MergedInto[ componentIndex ] = componentIndex;
+      this->m_ConnectedComponents[ componentIndex ] = false;
+      reconfiguredComponentNames.push_back( this->m_Blueprint.GetComponentName( componentIndex ) );
+    }
+  }
+  for( const auto & connection : this->GetConnections() )
+  {
+    if( isReconfigured[ connection.providing ] || isReconfigured[ connection.accepting ] )
+    {
+      this->ApplyConnectionCriteria( connection, isReconfigured[ connection.providing ], isReconfigured[ connection.accepting ] );
+    }
+  }
+  // The components that are kept are uniquely selected and are not narrowed
+  this->PropagateConnectionConstraints();
+  this->StoreConfiguration();
+
+  this->m_Logger.Log( LogLevel::INF, "Reconfigured {0:d} out of {1:d} components.", reconfiguredComponentNames.size(), numberOfComponents );
+  this->m_RealizedNetwork.reset();
+  this->m_isConnected = false;
+  if( !this->GetNonUniqueComponentNames().empty() )
+  {
+    this->m_Logger.Log( LogLevel::CRT, "{0} need more criteria.", this->m_Logger << this->GetNonUniqueComponentNames() );
+    return false;
+  }
+  return true;
+}
+
+
+template< typename ComponentList >
+void
+NetworkBuilder< ComponentList >::StoreConfiguration()
+{
+  this->m_ConfiguredComponents.clear();
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_Blueprint.GetNumberOfComponents(); ++componentIndex )
+  {
+    this->m_ConfiguredComponents.emplace_back( this->m_Blueprint.GetComponentName( componentIndex ), this->m_Blueprint.GetComponentParameterMap( componentIndex ) );
+  }
+  this->GetConnections();
+}
+
+
 template< typename ComponentList >
 void
 NetworkBuilder< ComponentList >::Cite()
 {
-  const BlueprintImpl::ComponentNamesType componentNames = m_Blueprint.GetComponentNames();
-  for( auto const & componentName : componentNames ) {
-    this->m_ComponentSelectorContainer[componentName]->GetComponent()->Cite();
+  for( ComponentIndexType componentIndex = 0; componentIndex < this->m_ComponentSelectorContainer.size(); ++componentIndex ) {
+    if( this->GetMergedInto( componentIndex ) != componentIndex ) {
+      continue;
+    }
+    this->GetComponent( componentIndex )->Cite();
   }
 }
 
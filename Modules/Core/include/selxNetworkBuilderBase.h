@@ -37,6 +37,8 @@
 #include "selxAnyFileReader.h"
 #include "selxAnyFileWriter.h"
 #include "selxLoggerImpl.h"
+#include "selxProfiler.h"
+#include "selxCompiledNetwork.h"
 
 namespace selx
 {
@@ -64,12 +66,26 @@ public:
   /** Read configuration at the blueprints nodes and edges and return true if all components could be uniquely selected*/
   virtual bool Configure() = 0;
 
+  /** Instantiate the components that were selected by an earlier configuration of the same blueprint, without applying the
+   * component and connection configuration. Throws if the network was compiled with a different component registry. */
+  virtual bool ConfigureFrom( const CompiledNetwork & compiledNetwork ) = 0;
+
+  /** The selected components of a configured network, to configure the same blueprint by ConfigureFrom() */
+  virtual CompiledNetwork GetCompiledNetwork() = 0;
+
   /** if all components are uniquely selected, they can be connected */
   virtual bool ConnectComponents() = 0;
 
   virtual bool CheckConnectionsSatisfied() = 0;
 
-  virtual NetworkContainer GetRealizedNetwork() = 0;
+  /** The network keeps track of which of its updates are up to date, such that executing the same network again skips them */
+  virtual NetworkContainer & GetRealizedNetwork() = 0;
+
+  /** Bring a realized network up to date with the parameter maps of the components in the blueprint, which may have been modified
+   * since the network was configured. Only the modified components and the components downstream are selected and connected
+   * anew, and their updates are executed again; the components upstream keep their results. Gives the names of the reconfigured
+   * components, or returns false if the network must be built anew, e.g. when components or connections were added or removed. */
+  virtual bool Reconfigure( ComponentNamesType & reconfiguredComponentNames ) = 0;
 
   virtual SourceInterfaceMapType GetSourceInterfaces() = 0;
 
@@ -83,6 +99,9 @@ public:
 
   virtual void Cite() = 0;
 
+  /** Record the configuration and connection phases with the profiler, if not null */
+  virtual void SetProfiler( Profiler * profiler ) = 0;
+
 private:
 };
 } // end namespace selx
@@ -22,6 +22,8 @@
 
 #include "selxComponentBase.h"
 #include "selxInterfaces.h"
+#include "selxProfiler.h"
+#include "selxProgressMonitor.h"
 
 #include "itkDataObject.h"
 
@@ -40,21 +42,133 @@ public:
   using ComponentContainerType = std::vector< std::shared_ptr< ComponentBase >>;
   using UpdateOrderType = std::vector<std::shared_ptr< UpdateInterface >>;
   using OutputObjectsMapType   = std::map< std::string, itk::DataObject::Pointer >;
+  // For each element in the UpdateOrder, the indices of the elements that must be updated before it.
+  using UpdateDependenciesType = std::vector< std::vector< std::size_t >>;
+  // For each Sink output, the indices of the elements in the UpdateOrder that it depends on.
+  using OutputDependenciesType = std::map< std::string, std::vector< std::size_t >>;
+  using OutputNamesType        = std::vector< std::string >;
+  // The components that can release their data, each with the indices of the elements in the UpdateOrder that use the data.
+  // Data that is also used outside of Execute, e.g. by the mini pipeline of a Sink, has no such elements.
+  using ReleaseDataType = std::vector< std::pair< std::shared_ptr< ReleaseDataInterface >, std::vector< std::size_t >>>;
+  // The components that receive the cancellation token before Execute
+  using CancellationInterfacesType = std::vector< std::shared_ptr< CancellationInterface >>;
+  // Groups of indices of elements in the UpdateOrder that share upstream data which is computed on demand, e.g. by an itk
+  // pipeline. The elements of a group are not updated concurrently.
+  using SerializedUpdatesType = std::vector< std::vector< std::size_t >>;
 
-  NetworkContainer( ComponentContainerType components, UpdateOrderType updateOrder, OutputObjectsMapType outputObjectsMap );
+  NetworkContainer( ComponentContainerType components, UpdateOrderType updateOrder, OutputObjectsMapType outputObjectsMap,
+    UpdateDependenciesType updateDependencies = UpdateDependenciesType(), OutputDependenciesType outputDependencies = OutputDependenciesType(),
+    ReleaseDataType releaseData = ReleaseDataType(), CancellationInterfacesType cancellationInterfaces = CancellationInterfacesType(),
+    SerializedUpdatesType serializedUpdates = SerializedUpdatesType() );
   ~NetworkContainer() {}
 
   /** Run the (registration) algorithm */
   void Execute();
 
+  /** Run only the part of the algorithm that the requested Sink outputs depend on. Updates that no Sink output depends on,
+   * such as those of controller components, are always executed, together with the updates they depend on. */
+  void Execute( const OutputNamesType & requestedOutputs );
+
+  /** The maximum number of components that Execute updates concurrently. With 1 (default) or without update dependencies,
+   * the components are updated serially in the update order, which is deterministic. */
+  void SetNumberOfThreads( unsigned int numberOfThreads ) { this->m_NumberOfThreads = numberOfThreads; }
+  unsigned int GetNumberOfThreads() const { return this->m_NumberOfThreads; }
+
+  /** The total number of threads of the components that are updated concurrently. Before each update, a component that
+   * provides the NumberOfThreadsInterface gets the share of the budget that is not in use by the other running updates,
+   * divided over the updates that can start along with it. The budget also limits the number of concurrent updates.
+   * Default 0: no budget, each component uses the default parallelism of its backend. */
+  void SetThreadBudget( unsigned int threadBudget ) { this->m_ThreadBudget = threadBudget; }
+  unsigned int GetThreadBudget() const { return this->m_ThreadBudget; }
+
+  /** Release the data of a component during Execute, as soon as the last update that uses it has finished. Default on;
+   * switch off to keep intermediate data for debugging. */
+  void SetReleaseIntermediateData( bool releaseIntermediateData ) { this->m_ReleaseIntermediateData = releaseIntermediateData; }
+  bool GetReleaseIntermediateData() const { return this->m_ReleaseIntermediateData; }
+
+  /** Record the Update of each component with the profiler, if not null */
+  void SetProfiler( Profiler * profiler ) { this->m_Profiler = profiler; }
+  Profiler * GetProfiler() const { return this->m_Profiler; }
+
+  /** Publish the start and end of each update to the monitor, and let the components publish their progress to it, if not null */
+  void SetProgressMonitor( ProgressMonitor * progressMonitor ) { this->m_ProgressMonitor = progressMonitor; }
+  ProgressMonitor * GetProgressMonitor() const { return this->m_ProgressMonitor; }
+
+  /** Stop Execute once the token is cancelled or its deadline has passed: no new updates are started, the components that provide
+   * the CancellationInterface stop early, and Execute throws ExecutionCancelledException. Default nullptr: not cancellable. */
+  void SetCancellationToken( CancellationToken::ConstPointer cancellationToken ) { this->m_CancellationToken = cancellationToken; }
+  CancellationToken::ConstPointer GetCancellationToken() const { return this->m_CancellationToken; }
+
+  /** The Sink outputs of which all updates finished during the last Execute, before it was cancelled (if so). Updates that
+   * were interrupted by the cancellation do not count as finished, since they may have stopped early. */
+  OutputNamesType GetFinishedOutputNames() const;
+
+  /** Release the data of all components that can, e.g. after the Sink outputs have been taken */
+  void ReleaseData();
+
+  /** Skip the updates that are up to date during Execute, such that executing the network again only updates what was invalidated.
+   * Default off: Execute updates all selected components. */
+  void SetIncrementalExecution( bool incrementalExecution ) { this->m_IncrementalExecution = incrementalExecution; }
+  bool GetIncrementalExecution() const { return this->m_IncrementalExecution; }
+
+  /** Per element of the UpdateOrder, whether it was updated by a previous Execute and its results are still valid. With incremental
+   * execution, an up to date element is skipped if none of the elements it depends on is updated. An element that releases its
+   * data is no longer up to date. Default: none is up to date. */
+  void SetUpToDate( const std::vector< bool > & upToDate );
+  const std::vector< bool > & GetUpToDate() const { return this->m_UpToDate; }
+
+  /** Mark all elements of the UpdateOrder as not up to date, e.g. when the inputs of the network are modified */
+  void Invalidate();
+
   /** Get the Sinking output objects */
   OutputObjectsMapType GetOutputObjectsMap();
 
 private:
 
+  /** Flags the elements of the UpdateOrder that are needed for the requested outputs */
+  std::vector< bool > SelectUpdates( const OutputNamesType & requestedOutputs ) const;
+
+  /** Update an element of the UpdateOrder with numberOfThreads (0: the default of the component), recorded by the profiler under
+   * the name of its component. Throws ExecutionCancelledException if the execution is cancelled before or during the update. */
+  void Update( std::size_t update, unsigned int numberOfThreads ) const;
+
+  void ExecuteSelected( const std::vector< bool > & selected );
+
+  /** Flags the selected elements of the UpdateOrder that are not up to date or depend on an element that is updated. Without
+   * incremental execution, all selected elements. */
+  std::vector< bool > SelectOutOfDate( const std::vector< bool > & selected ) const;
+
+  /** Release the data of an element of m_ReleaseData, after which the update that produced it is no longer up to date */
+  void ReleaseData( std::size_t component );
+
+  /** For each selected element of the UpdateOrder, the components in m_ReleaseData that it is the last user of, if it finishes last.
+   * remainingUses counts the selected users per component. */
+  std::vector< std::vector< std::size_t >> GetReleasesPerUpdate( const std::vector< bool > & selected, std::vector< std::size_t > & remainingUses ) const;
+
+  /** Update the selected components as soon as the components they depend on are updated, by a pool of m_NumberOfThreads threads */
+  void ExecuteParallel( const std::vector< bool > & selected );
+
   const ComponentContainerType m_ComponentContainer;
   const UpdateOrderType m_UpdateOrder;
   const OutputObjectsMapType   m_OutputObjectsMap;
+  const UpdateDependenciesType m_UpdateDependencies;
+  const OutputDependenciesType m_OutputDependencies;
+  const ReleaseDataType        m_ReleaseData;
+  const CancellationInterfacesType m_CancellationInterfaces;
+  const SerializedUpdatesType  m_SerializedUpdates;
+  unsigned int                 m_NumberOfThreads;
+  unsigned int                 m_ThreadBudget;
+  bool                         m_ReleaseIntermediateData;
+  bool                         m_IncrementalExecution;
+  Profiler *                   m_Profiler;
+  ProgressMonitor *            m_ProgressMonitor;
+  CancellationToken::ConstPointer m_CancellationToken;
+  // Per element of the UpdateOrder, whether it finished during the last Execute
+  std::vector< bool > m_Finished;
+  // Per element of the UpdateOrder, whether its results of a previous Execute are still valid
+  std::vector< bool > m_UpToDate;
+  // Per element of m_ReleaseData, the element of the UpdateOrder of the same component, or m_UpdateOrder.size() if it does not update
+  std::vector< std::size_t > m_ReleaseDataUpdates;
 };
 } // end namespace selx
 #endif // selxNetworkContainer_h
@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxProfiler_h
+#define selxProfiler_h
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace selx
+{
+/** \class Profiler
+ * \brief Records the wall time, CPU time and peak memory growth of the phases of a SuperElastix run
+ *
+ * The NetworkBuilder, the NetworkContainer and the SuperElastixFilter report their phases (e.g. Configure, ConnectComponents)
+ * and the Update of each component to the Profiler that is set on them, if any. The recorded events can be written as
+ * a Chrome trace (chrome://tracing, Perfetto) and summarized per name as a table.
+ */
+class Profiler
+{
+public:
+
+  struct Event
+  {
+    std::string name;
+    std::string category;
+    // Index of the thread that recorded the event, in order of first use
+    std::size_t threadIndex;
+    // Microseconds since the construction of the Profiler
+    long long startTime;
+    long long wallTime;
+    // Microseconds of CPU time of the process, i.e. including the threads of concurrent events
+    long long cpuTime;
+    // Growth of the peak resident set size of the process in kilobytes
+    long long peakResidentSetSizeIncrease;
+  };
+
+  typedef std::vector< Event >              EventContainerType;
+  typedef std::map< std::string, double >   TotalTimesMapType;
+
+  /** \class Scope
+   * \brief Records an event from its construction to its destruction. Without a Profiler nothing is measured.
+   */
+  class Scope
+  {
+public:
+
+    Scope( Profiler * profiler, const std::string & name, const std::string & category );
+    ~Scope();
+
+    Scope( const Scope & ) = delete;
+    Scope & operator=( const Scope & ) = delete;
+
+private:
+
+    Profiler *  m_Profiler;
+    std::string m_Name;
+    std::string m_Category;
+    long long   m_StartTime;
+    long long   m_StartCpuTime;
+    long long   m_StartPeakResidentSetSize;
+  };
+
+  Profiler();
+
+  void Clear();
+
+  EventContainerType GetEvents() const;
+
+  /** Total wall time in seconds per event name of the category */
+  TotalTimesMapType GetTotalWallTimes( const std::string & category ) const;
+
+  /** Write the events in the Chrome trace event format */
+  void WriteChromeTrace( std::ostream & out ) const;
+
+  /** Write a table with the number of events, total wall time, total CPU time and largest peak memory growth per event name */
+  void WriteSummary( std::ostream & out ) const;
+
+private:
+
+  void AddEvent( Event event );
+
+  long long GetTime() const;
+
+  static long long GetCpuTime();
+
+  static long long GetPeakResidentSetSize();
+
+  const std::chrono::steady_clock::time_point m_StartTime;
+  mutable std::mutex                          m_Mutex;
+  EventContainerType                          m_Events;
+  std::map< std::thread::id, std::size_t >    m_ThreadIndices;
+};
+} // end namespace selx
+
+#endif // selxProfiler_h
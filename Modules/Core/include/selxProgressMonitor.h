@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxProgressMonitor_h
+#define selxProgressMonitor_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace selx
+{
+/** Progress of a component, published during the execution of a network. Values that are not applicable are NaN. */
+struct ProgressEvent
+{
+  std::string component;
+  // E.g. "started" and "finished" for each component update, "level" at the start of a resolution level, "iteration" per iteration
+  std::string stage;
+  unsigned int level;
+  unsigned long iteration;
+  double metricValue;
+  double gradientNorm;
+  // Fraction of the component's work that is done, if the toolkit reports it
+  double progress;
+  // Seconds since the construction of the ProgressMonitor
+  double time;
+
+  ProgressEvent() : level( 0 ), iteration( 0 ), metricValue( std::numeric_limits< double >::quiet_NaN() ),
+    gradientNorm( std::numeric_limits< double >::quiet_NaN() ), progress( std::numeric_limits< double >::quiet_NaN() ), time( 0.0 ) {}
+};
+
+/** \class ProgressMonitor
+ * \brief Collects the progress and convergence events of the components of a network, from any thread
+ *
+ * Components publish to a bounded lock-free ring buffer, such that reporting an iteration does not wait for other
+ * components nor for the consumer. The events are consumed by Poll, or by a dispatch thread between Start and Stop, which
+ * pass them to the callback and append them to an in-memory time series. When the ring buffer is full, events are dropped
+ * and counted rather than blocking the registration.
+ */
+class ProgressMonitor
+{
+public:
+
+  typedef std::function< void ( const ProgressEvent & ) > CallbackType;
+  typedef std::vector< ProgressEvent >                    EventContainerType;
+
+  /** The capacity of the ring buffer is rounded up to a power of two */
+  explicit ProgressMonitor( std::size_t capacity = 4096 );
+  ~ProgressMonitor();
+
+  ProgressMonitor( const ProgressMonitor & ) = delete;
+  ProgressMonitor & operator=( const ProgressMonitor & ) = delete;
+
+  /** Lock-free. Returns false if the event was dropped because the ring buffer is full. Sets the time of the event. */
+  bool Publish( ProgressEvent event );
+
+  /** Called for every consumed event, in publication order per component. Set it before Start. The callback must not call
+   * Poll or GetTimeSeries. */
+  void SetCallback( CallbackType callback ) { this->m_Callback = callback; }
+
+  /** Append the consumed events to the time series. Default on; switch off if the callback is the only consumer. */
+  void SetKeepTimeSeries( bool keepTimeSeries ) { this->m_KeepTimeSeries = keepTimeSeries; }
+
+  /** Consume the published events in the calling thread */
+  void Poll();
+
+  /** Consume the published events by a dispatch thread, every interval */
+  void Start( std::chrono::milliseconds interval = std::chrono::milliseconds( 50 ) );
+
+  /** Stop the dispatch thread after consuming the remaining events */
+  void Stop();
+
+  /** The consumed events, i.e. the convergence of each component over time */
+  EventContainerType GetTimeSeries() const;
+
+  /** The consumed events of one component */
+  EventContainerType GetTimeSeries( const std::string & component ) const;
+
+  void ClearTimeSeries();
+
+  std::size_t GetNumberOfDroppedEvents() const { return this->m_NumberOfDroppedEvents; }
+
+  /** Write the event as one line of JSON */
+  static void WriteJsonLine( std::ostream & out, const ProgressEvent & event );
+
+private:
+
+  struct Slot
+  {
+    std::atomic< std::size_t > sequence;
+    ProgressEvent              event;
+  };
+
+  bool Pop( ProgressEvent & event );
+
+  const std::chrono::steady_clock::time_point m_StartTime;
+
+  std::unique_ptr< Slot[] > m_Slots;
+  const std::size_t         m_Mask;
+  // Separate cache lines for the producers and the consumer
+  alignas( 64 ) std::atomic< std::size_t > m_EnqueuePosition;
+  alignas( 64 ) std::atomic< std::size_t > m_DequeuePosition;
+  std::atomic< std::size_t > m_NumberOfDroppedEvents;
+
+  CallbackType m_Callback;
+  bool         m_KeepTimeSeries;
+
+  // Serializes the consumers and guards the time series
+  mutable std::mutex m_ConsumerMutex;
+  EventContainerType m_TimeSeries;
+
+  std::thread             m_DispatchThread;
+  std::mutex              m_DispatchMutex;
+  std::condition_variable m_DispatchCondition;
+  bool                    m_StopDispatching;
+};
+} // end namespace selx
+
+#endif // selxProgressMonitor_h
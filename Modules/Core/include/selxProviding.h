@@ -22,6 +22,8 @@
 
 #include "selxConnectionInfo.h"
 
+#include <typeindex>
+
 namespace selx
 {
 template< typename ... Interfaces >
@@ -34,6 +36,8 @@ public:
 
   static unsigned int CountMeetsCriteria( const ComponentBase::InterfaceCriteriaType ) { return 0; }
 
+  static bool IsProviding( const std::type_index & ) { return false; }
+
 protected:
 };
 
@@ -44,6 +48,9 @@ public:
 
   static unsigned int CountMeetsCriteria( const ComponentBase::InterfaceCriteriaType );
 
+  // Type level equivalent of a successful dynamic_cast of the component to the interface
+  static bool IsProviding( const std::type_index & interfaceType );
+
 protected:
 };
 } //end namespace selx
@@ -28,5 +28,13 @@ Providing< FirstInterface, RestInterfaces ... >::CountMeetsCriteria( const Compo
 {
   return Count< FirstInterface, RestInterfaces ... >::MeetsCriteria( interfaceCriteria );
 }
+
+
+template< typename FirstInterface, typename ... RestInterfaces >
+bool
+Providing< FirstInterface, RestInterfaces ... >::IsProviding( const std::type_index & interfaceType )
+{
+  return interfaceType == std::type_index( typeid( FirstInterface ) ) || Providing< RestInterfaces ... >::IsProviding( interfaceType );
+}
 } //end namespace selx
 #endif // Providing_hxx
@@ -29,6 +29,7 @@
 #include "selxAccepting.h"
 #include "selxProviding.h"
 #include "selxCount.h"
+#include "selxComponentPrototype.h"
 #include "selxLogger.h"
 
 namespace selx
@@ -56,6 +57,13 @@ protected:
 
   virtual InterfaceStatus CanAcceptConnectionFrom( ComponentBase::ConstPointer, const InterfaceCriteriaType interfaceCriteria ) override;
 
+  virtual InterfaceStatus CanAcceptConnectionFrom( const ComponentPrototypeBase & provider, const InterfaceCriteriaType interfaceCriteria ) override;
+
+  virtual bool IsProviding( const std::type_index & interfaceType ) const override
+  {
+    return ProvidingInterfaces::IsProviding( interfaceType );
+  }
+
   virtual unsigned int CountAcceptingInterfaces( const ComponentBase::InterfaceCriteriaType interfaceCriteria ) override
   {
     return AcceptingInterfaces::CountMeetsCriteria( interfaceCriteria );
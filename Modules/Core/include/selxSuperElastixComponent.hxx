@@ -45,7 +45,20 @@ InterfaceStatus
 SuperElastixComponent< AcceptingInterfaces, ProvidingInterfaces >
 ::CanAcceptConnectionFrom( ComponentBase::ConstPointer other, const InterfaceCriteriaType interfaceCriteria )
 {
-  return AcceptingInterfaces::CanAcceptConnectionFrom( other, interfaceCriteria );
+  return InterfaceCompatibilityCache::Get( std::type_index( typeid( *this ) ), std::type_index( typeid( *other ) ), interfaceCriteria, [ & ](){
+      return AcceptingInterfaces::CanAcceptConnectionFrom( other, interfaceCriteria );
+    } );
+}
+
+
+template< typename AcceptingInterfaces, typename ProvidingInterfaces >
+InterfaceStatus
+SuperElastixComponent< AcceptingInterfaces, ProvidingInterfaces >
+::CanAcceptConnectionFrom( const ComponentPrototypeBase & provider, const InterfaceCriteriaType interfaceCriteria )
+{
+  return InterfaceCompatibilityCache::Get( std::type_index( typeid( *this ) ), provider.GetComponentType(), interfaceCriteria, [ & ](){
+      return AcceptingInterfaces::CanAcceptConnectionFromProvider( provider, interfaceCriteria );
+    } );
 }
 
 
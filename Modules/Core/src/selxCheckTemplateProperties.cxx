@@ -32,10 +32,11 @@
 namespace selx
 {
 CriterionStatus
-CheckTemplateProperties( const std::map< std::string, std::string > templateProperties,
-  const std::pair< std::string, std::vector< std::string >> criterion )
+CheckTemplateProperties( const std::map< std::string, std::string > & templateProperties,
+  const std::pair< std::string, std::vector< std::string >> & criterion )
 {
-  if( templateProperties.count( criterion.first ) == 1 ) // e.g. is "Dimensionality" a template property? Or is NameOfClass queried?
+  auto templateProperty = templateProperties.find( criterion.first );
+  if( templateProperty != templateProperties.end() ) // e.g. is "Dimensionality" a template property? Or is NameOfClass queried?
   {
     if( criterion.second.size() != 1 )  // criteria can be of format: "keystring": ["value1", value2","value3"], but for templateproperties only 1 value is allowed.
     {
@@ -46,7 +47,7 @@ CheckTemplateProperties( const std::map< std::string, std::string > templateProp
     }
     for( auto const & criterionValue : criterion.second )
     {
-      if( criterionValue != templateProperties.at( criterion.first ) )
+      if( criterionValue != templateProperty->second )
       {
         return CriterionStatus::Failed;
       }
@@ -0,0 +1,297 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxCompiledNetwork.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+namespace selx
+{
+namespace
+{
+// Signature and version of the file format
+const char Signature[] = { 'S', 'E', 'L', 'X', 'N', 'E', 'T', '1' };
+
+class BinaryWriter
+{
+public:
+
+  explicit BinaryWriter( std::ostream & stream ) : m_Stream( stream ) {}
+
+  // Integers are written little endian, independent of the platform
+  void Write( std::uint64_t value )
+  {
+    char bytes[ 8 ];
+    for( int i = 0; i < 8; ++i )
+    {
+      bytes[ i ] = static_cast< char >( ( value >> ( 8 * i ) ) & 0xff );
+    }
+    this->m_Stream.write( bytes, 8 );
+  }
+
+  void Write( const std::string & value )
+  {
+    this->Write( static_cast< std::uint64_t >( value.size() ) );
+    this->m_Stream.write( value.data(), value.size() );
+  }
+
+  void Write( const BlueprintImpl::ParameterMapType & parameterMap )
+  {
+    this->Write( static_cast< std::uint64_t >( parameterMap.size() ) );
+    for( auto const & parameter : parameterMap )
+    {
+      this->Write( parameter.first );
+      this->Write( static_cast< std::uint64_t >( parameter.second.size() ) );
+      for( auto const & value : parameter.second )
+      {
+        this->Write( value );
+      }
+    }
+  }
+
+private:
+
+  std::ostream & m_Stream;
+};
+
+class BinaryReader
+{
+public:
+
+  BinaryReader( std::istream & stream, std::uint64_t size, const std::string & fileName ) :
+    m_Stream( stream ), m_Remaining( size ), m_FileName( fileName ) {}
+
+  std::uint64_t ReadInteger()
+  {
+    unsigned char bytes[ 8 ];
+    this->ReadBytes( reinterpret_cast< char * >( bytes ), 8 );
+    std::uint64_t value = 0;
+    for( int i = 0; i < 8; ++i )
+    {
+      value |= static_cast< std::uint64_t >( bytes[ i ] ) << ( 8 * i );
+    }
+    return value;
+  }
+
+  // A count of elements that each take at least one byte, such that corrupt counts are detected before allocating
+  std::uint64_t ReadCount()
+  {
+    const std::uint64_t count = this->ReadInteger();
+    if( count > this->m_Remaining )
+    {
+      this->Fail();
+    }
+    return count;
+  }
+
+  std::string ReadString()
+  {
+    std::string value( this->ReadCount(), '\0' );
+    this->ReadBytes( &value[ 0 ], value.size() );
+    return value;
+  }
+
+  BlueprintImpl::ParameterMapType ReadParameterMap()
+  {
+    BlueprintImpl::ParameterMapType parameterMap;
+    for( std::uint64_t numberOfParameters = this->ReadCount(); numberOfParameters > 0; --numberOfParameters )
+    {
+      auto & values = parameterMap[ this->ReadString() ];
+      for( std::uint64_t numberOfValues = this->ReadCount(); numberOfValues > 0; --numberOfValues )
+      {
+        values.push_back( this->ReadString() );
+      }
+    }
+    return parameterMap;
+  }
+
+  void ReadBytes( char * bytes, std::uint64_t size )
+  {
+    if( size > this->m_Remaining || !this->m_Stream.read( bytes, size ) )
+    {
+      this->Fail();
+    }
+    this->m_Remaining -= size;
+  }
+
+  std::uint64_t Remaining() const { return this->m_Remaining; }
+
+  void Fail() const
+  {
+    throw std::runtime_error( "Compiled network " + this->m_FileName + " is truncated or corrupt" );
+  }
+
+private:
+
+  std::istream &    m_Stream;
+  std::uint64_t     m_Remaining;
+  const std::string m_FileName;
+};
+} // end anonymous namespace
+
+CompiledNetwork::FingerprintType
+CompiledNetwork::Fingerprint( const std::vector< ComponentPrototypeBase::ConstPointer > & prototypes )
+{
+  // FNV-1a over the component type names and template properties. The type names are those of the compiler that built
+  // the registry, such that networks compiled by a different build are rejected.
+  FingerprintType hash = 14695981039346656037ull;
+  auto            add  = [ &hash ]( const std::string & text ) {
+                           for( const char character : text )
+                           {
+                             hash ^= static_cast< unsigned char >( character );
+                             hash *= 1099511628211ull;
+                           }
+                           hash ^= 0xff;
+                           hash *= 1099511628211ull;
+                         };
+  for( auto const & prototype : prototypes )
+  {
+    add( prototype->GetComponentType().name() );
+    for( auto const & property : prototype->TemplateProperties() )
+    {
+      add( property.first );
+      add( property.second );
+    }
+  }
+  return hash;
+}
+
+
+void
+CompiledNetwork::Write( const std::string & fileName, const BlueprintImpl & blueprint ) const
+{
+  std::ofstream stream( fileName, std::ios::binary );
+  if( !stream )
+  {
+    throw std::runtime_error( "Could not open " + fileName + " for writing" );
+  }
+
+  BinaryWriter writer( stream );
+  stream.write( Signature, sizeof( Signature ) );
+  writer.Write( this->registryFingerprint );
+
+  const auto componentNames = blueprint.GetComponentNames();
+  writer.Write( static_cast< std::uint64_t >( componentNames.size() ) );
+  for( auto const & componentName : componentNames )
+  {
+    auto selected = this->selectedComponents.find( componentName );
+    if( selected == this->selectedComponents.end() )
+    {
+      throw std::runtime_error( "Component " + componentName + " of the blueprint is not in the compiled network" );
+    }
+    auto merged = this->mergedComponents.find( componentName );
+    writer.Write( componentName );
+    writer.Write( blueprint.GetComponent( componentName ) );
+    writer.Write( selected->second );
+    writer.Write( merged == this->mergedComponents.end() ? std::string() : merged->second );
+  }
+
+  std::uint64_t numberOfConnections = 0;
+  for( auto const & componentName : componentNames )
+  {
+    const auto outputNames = blueprint.GetOutputNames( componentName );
+    for( auto const & outputName : std::set< ComponentNameType >( outputNames.begin(), outputNames.end() ) )
+    {
+      numberOfConnections += blueprint.GetConnectionNames( componentName, outputName ).size();
+    }
+  }
+  writer.Write( numberOfConnections );
+  for( auto const & componentName : componentNames )
+  {
+    const auto outputNames = blueprint.GetOutputNames( componentName );
+    for( auto const & outputName : std::set< ComponentNameType >( outputNames.begin(), outputNames.end() ) )
+    {
+      for( auto const & connectionName : blueprint.GetConnectionNames( componentName, outputName ) )
+      {
+        writer.Write( componentName );
+        writer.Write( outputName );
+        writer.Write( connectionName );
+        writer.Write( blueprint.GetConnection( componentName, outputName, connectionName ) );
+      }
+    }
+  }
+
+  if( !stream.flush() )
+  {
+    throw std::runtime_error( "Could not write " + fileName );
+  }
+}
+
+
+CompiledNetwork::Pointer
+CompiledNetwork::Read( const std::string & fileName, Blueprint & blueprint )
+{
+  std::ifstream stream( fileName, std::ios::binary | std::ios::ate );
+  if( !stream )
+  {
+    throw std::runtime_error( "Could not open " + fileName + " for reading" );
+  }
+  const std::uint64_t size = static_cast< std::uint64_t >( stream.tellg() );
+  stream.seekg( 0 );
+
+  char signature[ sizeof( Signature ) ];
+  if( size < sizeof( Signature ) || !stream.read( signature, sizeof( Signature ) )
+    || !std::equal( signature, signature + sizeof( Signature ), Signature ) )
+  {
+    throw std::runtime_error( fileName + " is not a compiled network of this version of SuperElastix" );
+  }
+
+  Pointer      network = std::make_shared< CompiledNetwork >();
+  BinaryReader content( stream, size - sizeof( Signature ), fileName );
+  network->registryFingerprint = content.ReadInteger();
+
+  for( std::uint64_t numberOfComponents = content.ReadCount(); numberOfComponents > 0; --numberOfComponents )
+  {
+    const ComponentNameType componentName = content.ReadString();
+    blueprint.SetComponent( componentName, content.ReadParameterMap() );
+    network->selectedComponents[ componentName ] = content.ReadInteger();
+    const ComponentNameType mergedInto = content.ReadString();
+    if( !mergedInto.empty() )
+    {
+      network->mergedComponents[ componentName ] = mergedInto;
+    }
+  }
+
+  for( std::uint64_t numberOfConnections = content.ReadCount(); numberOfConnections > 0; --numberOfConnections )
+  {
+    const ComponentNameType upstream       = content.ReadString();
+    const ComponentNameType downstream     = content.ReadString();
+    const std::string       connectionName = content.ReadString();
+    blueprint.SetConnection( upstream, downstream, content.ReadParameterMap(), connectionName );
+  }
+
+  if( content.Remaining() != 0 )
+  {
+    content.Fail();
+  }
+  return network;
+}
+
+
+bool
+CompiledNetwork::IsCompiledNetworkFile( const std::string & fileName )
+{
+  std::ifstream stream( fileName, std::ios::binary );
+  char          signature[ sizeof( Signature ) ];
+  return stream.read( signature, sizeof( Signature ) ) && std::equal( signature, signature + sizeof( Signature ), Signature );
+}
+} // end namespace selx
@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxInterfaceCompatibilityCache.h"
+
+namespace selx
+{
+InterfaceStatus
+InterfaceCompatibilityCache::Get( const std::type_index & acceptingType, const std::type_index & providingType,
+  const InterfaceCriteriaType & interfaceCriteria, const ComputeFunctionType & compute )
+{
+  const TypePairType typePair( acceptingType, providingType );
+  {
+    std::lock_guard< std::mutex > lock( GetMutex() );
+    auto typePairEntry = GetCache().find( typePair );
+    if( typePairEntry != GetCache().end() )
+    {
+      auto entry = typePairEntry->second.find( interfaceCriteria );
+      if( entry != typePairEntry->second.end() )
+      {
+        return entry->second;
+      }
+    }
+  }
+
+  // The handshake is computed without holding the lock. Concurrent computations of the same entry give the same status.
+  const InterfaceStatus status = compute();
+
+  std::lock_guard< std::mutex > lock( GetMutex() );
+  GetCache()[ typePair ].emplace( interfaceCriteria, status );
+  return status;
+}
+
+
+std::size_t
+InterfaceCompatibilityCache::Size()
+{
+  std::lock_guard< std::mutex > lock( GetMutex() );
+  std::size_t size = 0;
+  for( auto const & typePairEntry : GetCache() )
+  {
+    size += typePairEntry.second.size();
+  }
+  return size;
+}
+
+
+void
+InterfaceCompatibilityCache::Clear()
+{
+  std::lock_guard< std::mutex > lock( GetMutex() );
+  GetCache().clear();
+}
+
+
+InterfaceCompatibilityCache::CacheType &
+InterfaceCompatibilityCache::GetCache()
+{
+  static CacheType cache;
+  return cache;
+}
+
+
+std::mutex &
+InterfaceCompatibilityCache::GetMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+} // end namespace selx
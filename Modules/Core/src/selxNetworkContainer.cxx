@@ -21,24 +21,513 @@
 #include "selxKeys.h"
 #include "selxSuperElastixComponent.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace selx
 {
-NetworkContainer::NetworkContainer( ComponentContainerType components, UpdateOrderType updateOrder, OutputObjectsMapType outputObjectsMap ) :
+NetworkContainer::NetworkContainer( ComponentContainerType components, UpdateOrderType updateOrder, OutputObjectsMapType outputObjectsMap,
+  UpdateDependenciesType updateDependencies, OutputDependenciesType outputDependencies, ReleaseDataType releaseData,
+  CancellationInterfacesType cancellationInterfaces, SerializedUpdatesType serializedUpdates ) :
   m_ComponentContainer( components ),
   m_UpdateOrder( updateOrder),
-  m_OutputObjectsMap( outputObjectsMap )
+  m_OutputObjectsMap( outputObjectsMap ),
+  m_UpdateDependencies( updateDependencies ),
+  m_OutputDependencies( outputDependencies ),
+  m_ReleaseData( releaseData ),
+  m_CancellationInterfaces( cancellationInterfaces ),
+  m_SerializedUpdates( serializedUpdates ),
+  m_NumberOfThreads( 1 ),
+  m_ThreadBudget( 0 ),
+  m_ReleaseIntermediateData( true ),
+  m_IncrementalExecution( false ),
+  m_Profiler( nullptr ),
+  m_ProgressMonitor( nullptr ),
+  m_Finished( updateOrder.size(), false ),
+  m_UpToDate( updateOrder.size(), false ),
+  m_ReleaseDataUpdates( releaseData.size(), updateOrder.size() )
+{
+  if( !this->m_UpdateDependencies.empty() && this->m_UpdateDependencies.size() != this->m_UpdateOrder.size() )
+  {
+    throw std::runtime_error( "NetworkContainer: the number of update dependencies does not match the number of components in the update order." );
+  }
+  for( const auto & nameAndDependencies : this->m_OutputDependencies )
+  {
+    for( const auto & dependency : nameAndDependencies.second )
+    {
+      if( dependency >= this->m_UpdateOrder.size() )
+      {
+        throw std::runtime_error( "NetworkContainer: output " + nameAndDependencies.first + " depends on a component that is not in the update order." );
+      }
+    }
+  }
+  for( const auto & componentAndUses : this->m_ReleaseData )
+  {
+    for( const auto & use : componentAndUses.second )
+    {
+      if( use >= this->m_UpdateOrder.size() )
+      {
+        throw std::runtime_error( "NetworkContainer: data is used by a component that is not in the update order." );
+      }
+    }
+  }
+  for( const auto & updates : this->m_SerializedUpdates )
+  {
+    for( const auto & update : updates )
+    {
+      if( update >= this->m_UpdateOrder.size() )
+      {
+        throw std::runtime_error( "NetworkContainer: a serialized update is not in the update order." );
+      }
+    }
+  }
+  // The interfaces of the same component point to the same most derived object
+  for( std::size_t component = 0; component < this->m_ReleaseData.size(); ++component )
+  {
+    for( std::size_t update = 0; update < this->m_UpdateOrder.size(); ++update )
+    {
+      if( dynamic_cast< const void * >( this->m_ReleaseData[ component ].first.get() ) == dynamic_cast< const void * >( this->m_UpdateOrder[ update ].get() ) )
+      {
+        this->m_ReleaseDataUpdates[ component ] = update;
+      }
+    }
+  }
+}
+
+
+void
+NetworkContainer::SetUpToDate( const std::vector< bool > & upToDate )
+{
+  if( upToDate.size() != this->m_UpdateOrder.size() )
+  {
+    throw std::runtime_error( "NetworkContainer: the number of up to date flags does not match the number of components in the update order." );
+  }
+  this->m_UpToDate = upToDate;
+}
+
+
+void
+NetworkContainer::Invalidate()
 {
+  this->m_UpToDate.assign( this->m_UpdateOrder.size(), false );
 }
 
 
 void
 NetworkContainer::Execute()
 {
+  this->ExecuteSelected( std::vector< bool >( this->m_UpdateOrder.size(), true ) );
+}
+
+
+void
+NetworkContainer::Execute( const OutputNamesType & requestedOutputs )
+{
+  this->ExecuteSelected( this->SelectUpdates( requestedOutputs ) );
+}
+
+
+std::vector< bool >
+NetworkContainer::SelectUpdates( const OutputNamesType & requestedOutputs ) const
+{
+  const std::size_t numberOfUpdates = this->m_UpdateOrder.size();
+  if( this->m_OutputDependencies.empty() )
+  {
+    return std::vector< bool >( numberOfUpdates, true );
+  }
+
+  std::vector< bool >        feedsOutput( numberOfUpdates, false );
+  std::vector< std::size_t > worklist;
+  for( const auto & nameAndDependencies : this->m_OutputDependencies )
+  {
+    const bool requested = std::find( requestedOutputs.begin(), requestedOutputs.end(), nameAndDependencies.first ) != requestedOutputs.end();
+    for( const auto & dependency : nameAndDependencies.second )
+    {
+      feedsOutput[ dependency ] = true;
+      if( requested )
+      {
+        worklist.push_back( dependency );
+      }
+    }
+  }
+  for( std::size_t update = 0; update < numberOfUpdates; ++update )
+  {
+    if( !feedsOutput[ update ] )
+    {
+      worklist.push_back( update );
+    }
+  }
+
+  // The updates that a selected update depends on are selected as well
+  std::vector< bool > selected( numberOfUpdates, false );
+  while( !worklist.empty() )
+  {
+    const std::size_t update = worklist.back();
+    worklist.pop_back();
+    if( selected[ update ] )
+    {
+      continue;
+    }
+    selected[ update ] = true;
+    if( !this->m_UpdateDependencies.empty() )
+    {
+      worklist.insert( worklist.end(), this->m_UpdateDependencies[ update ].begin(), this->m_UpdateDependencies[ update ].end() );
+    }
+  }
+  return selected;
+}
+
+
+std::vector< bool >
+NetworkContainer::SelectOutOfDate( const std::vector< bool > & selected ) const
+{
+  if( !this->m_IncrementalExecution )
+  {
+    return selected;
+  }
+
+  // The dependencies precede their dependents in the update order. Without known dependencies, an update depends on all before it.
+  std::vector< bool > outOfDate( this->m_UpdateOrder.size(), false );
+  bool                anyOutOfDate = false;
+  for( std::size_t update = 0; update < this->m_UpdateOrder.size(); ++update )
+  {
+    if( !selected[ update ] )
+    {
+      continue;
+    }
+    bool dependencyOutOfDate = anyOutOfDate;
+    if( !this->m_UpdateDependencies.empty() )
+    {
+      dependencyOutOfDate = std::any_of( this->m_UpdateDependencies[ update ].begin(), this->m_UpdateDependencies[ update ].end(),
+        [ &outOfDate ]( std::size_t dependency ){
+          return outOfDate[ dependency ];
+        } );
+    }
+    outOfDate[ update ] = !this->m_UpToDate[ update ] || dependencyOutOfDate;
+    anyOutOfDate       |= outOfDate[ update ];
+  }
+  return outOfDate;
+}
+
+
+std::vector< std::vector< std::size_t >>
+NetworkContainer::GetReleasesPerUpdate( const std::vector< bool > & selected, std::vector< std::size_t > & remainingUses ) const
+{
+  std::vector< std::vector< std::size_t >> releasesPerUpdate( this->m_UpdateOrder.size() );
+  remainingUses.assign( this->m_ReleaseData.size(), 0 );
+  if( !this->m_ReleaseIntermediateData )
+  {
+    return releasesPerUpdate;
+  }
+  for( std::size_t component = 0; component < this->m_ReleaseData.size(); ++component )
+  {
+    for( const auto & use : this->m_ReleaseData[ component ].second )
+    {
+      if( selected[ use ] )
+      {
+        ++remainingUses[ component ];
+        releasesPerUpdate[ use ].push_back( component );
+      }
+    }
+  }
+  return releasesPerUpdate;
+}
+
+
+void
+NetworkContainer::Update( std::size_t update, unsigned int numberOfThreads ) const
+{
+  std::string name;
+  if( this->m_Profiler || this->m_ProgressMonitor )
+  {
+    const auto component = std::dynamic_pointer_cast< ComponentBase >( this->m_UpdateOrder[ update ] );
+    name = component ? component->m_Name : "Update " + std::to_string( update );
+  }
+  Profiler::Scope scope( this->m_Profiler, name, "component" );
+  if( this->m_CancellationToken )
+  {
+    this->m_CancellationToken->ThrowIfCancelled();
+  }
+  if( numberOfThreads > 0 )
+  {
+    if( const auto numberOfThreadsInterface = std::dynamic_pointer_cast< NumberOfThreadsInterface >( this->m_UpdateOrder[ update ] ) )
+    {
+      numberOfThreadsInterface->SetNumberOfThreads( numberOfThreads );
+    }
+  }
+  ProgressEvent event;
+  if( this->m_ProgressMonitor )
+  {
+    event.component = name;
+    event.stage     = "started";
+    this->m_ProgressMonitor->Publish( event );
+  }
+  this->m_UpdateOrder[ update ]->Update();
+  if( this->m_ProgressMonitor )
+  {
+    event.stage = "finished";
+    this->m_ProgressMonitor->Publish( event );
+  }
+  // A component that honors the token returns normally with the result of an interrupted optimization
+  if( this->m_CancellationToken )
+  {
+    this->m_CancellationToken->ThrowIfCancelled();
+  }
+}
+
+
+void
+NetworkContainer::ExecuteSelected( const std::vector< bool > & selected )
+{
+  // The up to date updates are finished already
+  this->m_Finished.assign( this->m_UpdateOrder.size(), false );
+  const std::vector< bool > outOfDate = this->SelectOutOfDate( selected );
+  for( std::size_t update = 0; update < this->m_UpdateOrder.size(); ++update )
+  {
+    this->m_Finished[ update ] = selected[ update ] && !outOfDate[ update ];
+  }
+  for( const auto & cancellationInterface : this->m_CancellationInterfaces )
+  {
+    cancellationInterface->SetCancellationToken( this->m_CancellationToken );
+  }
+  for( const auto & component : this->m_ComponentContainer )
+  {
+    component->SetProgressMonitor( this->m_ProgressMonitor );
+  }
+
+  if( this->m_NumberOfThreads > 1 && this->m_UpdateOrder.size() > 1 && !this->m_UpdateDependencies.empty() )
+  {
+    this->ExecuteParallel( outOfDate );
+    return;
+  }
+
+  std::vector< std::size_t > remainingUses;
+  const auto                 releasesPerUpdate = this->GetReleasesPerUpdate( outOfDate, remainingUses );
+
   /** For those components that have an update interface the update is executed in the right pipeline order. **/
-  for( auto updateInterface : this->m_UpdateOrder )
+  for( std::size_t update = 0; update < this->m_UpdateOrder.size(); ++update )
+  {
+    if( outOfDate[ update ] )
+    {
+      // Serially, each update has the whole budget
+      this->m_UpToDate[ update ] = false;
+      this->Update( update, this->m_ThreadBudget );
+      this->m_Finished[ update ] = true;
+      this->m_UpToDate[ update ] = true;
+      for( const auto & component : releasesPerUpdate[ update ] )
+      {
+        if( --remainingUses[ component ] == 0 )
+        {
+          this->ReleaseData( component );
+        }
+      }
+    }
+  }
+}
+
+
+void
+NetworkContainer::ReleaseData()
+{
+  for( std::size_t component = 0; component < this->m_ReleaseData.size(); ++component )
+  {
+    this->ReleaseData( component );
+  }
+}
+
+
+void
+NetworkContainer::ReleaseData( std::size_t component )
+{
+  this->m_ReleaseData[ component ].first->ReleaseData();
+  if( this->m_ReleaseDataUpdates[ component ] < this->m_UpToDate.size() )
+  {
+    this->m_UpToDate[ this->m_ReleaseDataUpdates[ component ] ] = false;
+  }
+}
+
+
+void
+NetworkContainer::ExecuteParallel( const std::vector< bool > & selected )
+{
+  const std::size_t numberOfTasks = std::count( selected.begin(), selected.end(), true );
+
+  std::vector< std::size_t >                numberOfPendingDependencies( this->m_UpdateOrder.size() );
+  std::vector< std::vector< std::size_t > > dependents( this->m_UpdateOrder.size() );
+  std::deque< std::size_t >                 readyTasks;
+  for( std::size_t task = 0; task < this->m_UpdateOrder.size(); ++task )
+  {
+    if( !selected[ task ] )
+    {
+      continue;
+    }
+    // Dependencies that are not selected are up to date
+    for( auto const & dependency : this->m_UpdateDependencies[ task ] )
+    {
+      if( selected[ dependency ] )
+      {
+        ++numberOfPendingDependencies[ task ];
+        dependents[ dependency ].push_back( task );
+      }
+    }
+  }
+  // The selected elements of a serialized group are updated one after the other, in update order
+  for( auto updates : this->m_SerializedUpdates )
+  {
+    std::sort( updates.begin(), updates.end() );
+    std::size_t previous = this->m_UpdateOrder.size();
+    for( const auto & task : updates )
+    {
+      if( !selected[ task ] )
+      {
+        continue;
+      }
+      if( previous < this->m_UpdateOrder.size() )
+      {
+        ++numberOfPendingDependencies[ task ];
+        dependents[ previous ].push_back( task );
+      }
+      previous = task;
+    }
+  }
+  for( std::size_t task = 0; task < this->m_UpdateOrder.size(); ++task )
+  {
+    if( selected[ task ] && numberOfPendingDependencies[ task ] == 0 )
+    {
+      readyTasks.push_back( task );
+    }
+  }
+
+  std::vector< std::size_t > remainingUses;
+  const auto                 releasesPerUpdate = this->GetReleasesPerUpdate( selected, remainingUses );
+
+  std::mutex              mutex;
+  std::condition_variable taskFinished;
+  std::size_t             numberOfFinishedTasks = 0;
+  std::exception_ptr      firstException;
+  std::size_t             numberOfRunningTasks = 0;
+  unsigned int            numberOfThreadsInUse = 0;
+
+  // The calling thread is one of the workers
+  std::size_t numberOfWorkers = std::min< std::size_t >( this->m_NumberOfThreads, numberOfTasks );
+  if( this->m_ThreadBudget > 0 )
+  {
+    numberOfWorkers = std::min< std::size_t >( numberOfWorkers, this->m_ThreadBudget );
+  }
+
+  // Each worker takes the first ready task, in update order. After an exception no new tasks are started.
+  auto worker = [ & ](){
+    std::unique_lock< std::mutex > lock( mutex );
+    while( true )
+    {
+      taskFinished.wait( lock, [ & ](){
+          return !readyTasks.empty() || numberOfFinishedTasks == numberOfTasks || firstException;
+        } );
+      if( firstException || numberOfFinishedTasks == numberOfTasks )
+      {
+        return;
+      }
+      const std::size_t task = readyTasks.front();
+      readyTasks.pop_front();
+
+      // The free part of the budget is shared by this task and the ready tasks that the idle workers can start along with it
+      unsigned int numberOfThreads = 0;
+      if( this->m_ThreadBudget > 0 )
+      {
+        const std::size_t numberOfStartingTasks = std::min( readyTasks.size() + 1, numberOfWorkers - numberOfRunningTasks );
+        const unsigned int numberOfFreeThreads  = this->m_ThreadBudget - std::min( numberOfThreadsInUse, this->m_ThreadBudget );
+        numberOfThreads       = std::max( 1u, static_cast< unsigned int >( numberOfFreeThreads / numberOfStartingTasks ) );
+        numberOfThreadsInUse += numberOfThreads;
+      }
+      ++numberOfRunningTasks;
+      this->m_UpToDate[ task ] = false;
+      lock.unlock();
+
+      std::exception_ptr exception;
+      try
+      {
+        this->Update( task, numberOfThreads );
+      }
+      catch( ... )
+      {
+        exception = std::current_exception();
+      }
+
+      lock.lock();
+      --numberOfRunningTasks;
+      numberOfThreadsInUse -= numberOfThreads;
+      if( exception )
+      {
+        if( !firstException )
+        {
+          firstException = exception;
+        }
+      }
+      else
+      {
+        this->m_Finished[ task ] = true;
+        this->m_UpToDate[ task ] = true;
+        for( const auto & component : releasesPerUpdate[ task ] )
+        {
+          if( --remainingUses[ component ] == 0 )
+          {
+            this->ReleaseData( component );
+          }
+        }
+        ++numberOfFinishedTasks;
+        for( auto const & dependent : dependents[ task ] )
+        {
+          if( --numberOfPendingDependencies[ dependent ] == 0 )
+          {
+            readyTasks.push_back( dependent );
+          }
+        }
+      }
+      taskFinished.notify_all();
+    }
+  };
+
+  std::vector< std::thread > threads;
+  for( std::size_t threadIndex = 1; threadIndex < numberOfWorkers; ++threadIndex )
+  {
+    threads.emplace_back( worker );
+  }
+  worker();
+  for( auto & thread : threads )
+  {
+    thread.join();
+  }
+
+  if( firstException )
+  {
+    std::rethrow_exception( firstException );
+  }
+}
+
+
+NetworkContainer::OutputNamesType
+NetworkContainer::GetFinishedOutputNames() const
+{
+  const bool      allFinished = std::find( this->m_Finished.begin(), this->m_Finished.end(), false ) == this->m_Finished.end();
+  OutputNamesType finishedOutputNames;
+  for( const auto & nameAndObject : this->m_OutputObjectsMap )
   {
-    updateInterface->Update();
+    auto dependencies = this->m_OutputDependencies.find( nameAndObject.first );
+    // Without known dependencies an output depends on all updates
+    const bool finished = dependencies == this->m_OutputDependencies.end() ? allFinished :
+      std::all_of( dependencies->second.begin(), dependencies->second.end(), [ this ]( std::size_t update ){
+        return this->m_Finished[ update ];
+      } );
+    if( finished )
+    {
+      finishedOutputNames.push_back( nameAndObject.first );
+    }
   }
+  return finishedOutputNames;
 }
 
 
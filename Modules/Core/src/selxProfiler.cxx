@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace selx
+{
+namespace
+{
+std::string
+EscapeJson( const std::string & text )
+{
+  std::string escaped;
+  for( const char character : text )
+  {
+    switch( character )
+    {
+      case '"':
+        escaped += "\\\""; break;
+      case '\\':
+        escaped += "\\\\"; break;
+      case '\n':
+        escaped += "\\n"; break;
+      case '\t':
+        escaped += "\\t"; break;
+      default:
+        if( static_cast< unsigned char >( character ) < 0x20 )
+        {
+          escaped += ' ';
+        }
+        else
+        {
+          escaped += character;
+        }
+    }
+  }
+  return escaped;
+}
+}
+
+Profiler::Scope::Scope( Profiler * profiler, const std::string & name, const std::string & category ) :
+  m_Profiler( profiler ),
+  m_StartTime( 0 ),
+  m_StartCpuTime( 0 ),
+  m_StartPeakResidentSetSize( 0 )
+{
+  if( this->m_Profiler )
+  {
+    this->m_Name                     = name;
+    this->m_Category                 = category;
+    this->m_StartPeakResidentSetSize = Profiler::GetPeakResidentSetSize();
+    this->m_StartCpuTime             = Profiler::GetCpuTime();
+    this->m_StartTime                = this->m_Profiler->GetTime();
+  }
+}
+
+
+Profiler::Scope::~Scope()
+{
+  if( this->m_Profiler )
+  {
+    Event event;
+    event.name                        = this->m_Name;
+    event.category                    = this->m_Category;
+    event.threadIndex                 = 0;
+    event.startTime                   = this->m_StartTime;
+    event.wallTime                    = this->m_Profiler->GetTime() - this->m_StartTime;
+    event.cpuTime                     = Profiler::GetCpuTime() - this->m_StartCpuTime;
+    event.peakResidentSetSizeIncrease = Profiler::GetPeakResidentSetSize() - this->m_StartPeakResidentSetSize;
+    this->m_Profiler->AddEvent( event );
+  }
+}
+
+
+Profiler::Profiler() : m_StartTime( std::chrono::steady_clock::now() )
+{
+}
+
+
+void
+Profiler::Clear()
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  this->m_Events.clear();
+}
+
+
+Profiler::EventContainerType
+Profiler::GetEvents() const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  return this->m_Events;
+}
+
+
+Profiler::TotalTimesMapType
+Profiler::GetTotalWallTimes( const std::string & category ) const
+{
+  TotalTimesMapType totalWallTimes;
+  for( const auto & event : this->GetEvents() )
+  {
+    if( event.category == category )
+    {
+      totalWallTimes[ event.name ] += event.wallTime * 1e-6;
+    }
+  }
+  return totalWallTimes;
+}
+
+
+void
+Profiler::WriteChromeTrace( std::ostream & out ) const
+{
+  const auto events = this->GetEvents();
+  out << "{\"traceEvents\":[";
+  for( std::size_t index = 0; index < events.size(); ++index )
+  {
+    const Event & event = events[ index ];
+    out << ( index == 0 ? "\n" : ",\n" )
+        << "{\"name\":\"" << EscapeJson( event.name ) << "\",\"cat\":\"" << EscapeJson( event.category ) << "\",\"ph\":\"X\""
+        << ",\"ts\":" << event.startTime << ",\"dur\":" << event.wallTime << ",\"pid\":0,\"tid\":" << event.threadIndex
+        << ",\"args\":{\"cpu_us\":" << event.cpuTime << ",\"peak_rss_delta_kb\":" << event.peakResidentSetSizeIncrease << "}}";
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+void
+Profiler::WriteSummary( std::ostream & out ) const
+{
+  struct SummaryType
+  {
+    std::size_t count;
+    long long wallTime;
+    long long cpuTime;
+    long long peakResidentSetSizeIncrease;
+  };
+
+  std::map< std::string, SummaryType > summaries;
+  std::size_t                          nameWidth = 4;
+  for( const auto & event : this->GetEvents() )
+  {
+    auto & summary = summaries.emplace( event.name, SummaryType{ 0, 0, 0, 0 } ).first->second;
+    ++summary.count;
+    summary.wallTime                   += event.wallTime;
+    summary.cpuTime                    += event.cpuTime;
+    summary.peakResidentSetSizeIncrease = std::max( summary.peakResidentSetSizeIncrease, event.peakResidentSetSizeIncrease );
+    nameWidth                           = std::max( nameWidth, event.name.size() );
+  }
+
+  std::vector< std::pair< std::string, SummaryType >> sortedSummaries( summaries.begin(), summaries.end() );
+  std::stable_sort( sortedSummaries.begin(), sortedSummaries.end(), []( const std::pair< std::string, SummaryType > & a,
+    const std::pair< std::string, SummaryType > & b ){
+      return a.second.wallTime > b.second.wallTime;
+    } );
+
+  const auto flags = out.flags();
+  out << std::left << std::setw( nameWidth ) << "Name" << std::right
+      << std::setw( 8 ) << "Count" << std::setw( 14 ) << "Wall (ms)" << std::setw( 14 ) << "CPU (ms)" << std::setw( 16 ) << "Peak RSS (kB)" << "\n";
+  out << std::fixed << std::setprecision( 3 );
+  for( const auto & nameAndSummary : sortedSummaries )
+  {
+    out << std::left << std::setw( nameWidth ) << nameAndSummary.first << std::right
+        << std::setw( 8 ) << nameAndSummary.second.count
+        << std::setw( 14 ) << nameAndSummary.second.wallTime * 1e-3
+        << std::setw( 14 ) << nameAndSummary.second.cpuTime * 1e-3
+        << std::setw( 16 ) << nameAndSummary.second.peakResidentSetSizeIncrease << "\n";
+  }
+  out.flags( flags );
+}
+
+
+void
+Profiler::AddEvent( Event event )
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  event.threadIndex = this->m_ThreadIndices.emplace( std::this_thread::get_id(), this->m_ThreadIndices.size() ).first->second;
+  this->m_Events.push_back( event );
+}
+
+
+long long
+Profiler::GetTime() const
+{
+  return std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - this->m_StartTime ).count();
+}
+
+
+long long
+Profiler::GetCpuTime()
+{
+#ifdef _WIN32
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if( !GetProcessTimes( GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime ) )
+  {
+    return 0;
+  }
+  // FILETIME counts 100 nanosecond intervals
+  const auto toMicroseconds = []( const FILETIME & time ){
+      return static_cast< long long >( ( static_cast< unsigned long long >( time.dwHighDateTime ) << 32 ) | time.dwLowDateTime ) / 10;
+    };
+  return toMicroseconds( kernelTime ) + toMicroseconds( userTime );
+#else
+  struct rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+  {
+    return 0;
+  }
+  return ( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000LL + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+
+long long
+Profiler::GetPeakResidentSetSize()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+  {
+    return 0;
+  }
+  return static_cast< long long >( counters.PeakWorkingSetSize / 1024 );
+#else
+  struct rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+  {
+    return 0;
+  }
+#ifdef __APPLE__
+  // Bytes on macOS, kilobytes on Linux
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+} // end namespace selx
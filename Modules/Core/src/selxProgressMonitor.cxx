@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxProgressMonitor.h"
+
+#include <cmath>
+#include <iomanip>
+
+namespace selx
+{
+namespace
+{
+std::size_t
+RoundUpToPowerOfTwo( std::size_t value )
+{
+  std::size_t powerOfTwo = 2;
+  while( powerOfTwo < value )
+  {
+    powerOfTwo *= 2;
+  }
+  return powerOfTwo;
+}
+
+
+void
+WriteJsonString( std::ostream & out, const std::string & text )
+{
+  out << '"';
+  for( const char character : text )
+  {
+    if( character == '"' || character == '\\' )
+    {
+      out << '\\' << character;
+    }
+    else if( static_cast< unsigned char >( character ) < 0x20 )
+    {
+      out << ' ';
+    }
+    else
+    {
+      out << character;
+    }
+  }
+  out << '"';
+}
+
+
+void
+WriteJsonNumber( std::ostream & out, double value )
+{
+  if( std::isfinite( value ) )
+  {
+    out << value;
+  }
+  else
+  {
+    out << "null";
+  }
+}
+}
+
+ProgressMonitor::ProgressMonitor( std::size_t capacity ) :
+  m_StartTime( std::chrono::steady_clock::now() ),
+  m_Slots( new Slot[ RoundUpToPowerOfTwo( capacity ) ] ),
+  m_Mask( RoundUpToPowerOfTwo( capacity ) - 1 ),
+  m_EnqueuePosition( 0 ),
+  m_DequeuePosition( 0 ),
+  m_NumberOfDroppedEvents( 0 ),
+  m_KeepTimeSeries( true ),
+  m_StopDispatching( false )
+{
+  for( std::size_t position = 0; position <= this->m_Mask; ++position )
+  {
+    this->m_Slots[ position ].sequence.store( position, std::memory_order_relaxed );
+  }
+}
+
+
+ProgressMonitor::~ProgressMonitor()
+{
+  this->Stop();
+}
+
+
+bool
+ProgressMonitor::Publish( ProgressEvent event )
+{
+  event.time = std::chrono::duration< double >( std::chrono::steady_clock::now() - this->m_StartTime ).count();
+
+  // Bounded multi-producer queue: a producer claims a slot by advancing the enqueue position, and hands it to the consumer
+  // by advancing the sequence number of the slot.
+  std::size_t position = this->m_EnqueuePosition.load( std::memory_order_relaxed );
+  while( true )
+  {
+    Slot &               slot       = this->m_Slots[ position & this->m_Mask ];
+    const std::size_t    sequence   = slot.sequence.load( std::memory_order_acquire );
+    const std::ptrdiff_t difference = static_cast< std::ptrdiff_t >( sequence ) - static_cast< std::ptrdiff_t >( position );
+    if( difference == 0 )
+    {
+      if( this->m_EnqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+      {
+        slot.event = std::move( event );
+        slot.sequence.store( position + 1, std::memory_order_release );
+        return true;
+      }
+    }
+    else if( difference < 0 )
+    {
+      ++this->m_NumberOfDroppedEvents;
+      return false;
+    }
+    else
+    {
+      position = this->m_EnqueuePosition.load( std::memory_order_relaxed );
+    }
+  }
+}
+
+
+bool
+ProgressMonitor::Pop( ProgressEvent & event )
+{
+  std::size_t position = this->m_DequeuePosition.load( std::memory_order_relaxed );
+  while( true )
+  {
+    Slot &               slot       = this->m_Slots[ position & this->m_Mask ];
+    const std::size_t    sequence   = slot.sequence.load( std::memory_order_acquire );
+    const std::ptrdiff_t difference = static_cast< std::ptrdiff_t >( sequence ) - static_cast< std::ptrdiff_t >( position + 1 );
+    if( difference == 0 )
+    {
+      if( this->m_DequeuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+      {
+        event = std::move( slot.event );
+        slot.sequence.store( position + this->m_Mask + 1, std::memory_order_release );
+        return true;
+      }
+    }
+    else if( difference < 0 )
+    {
+      return false;
+    }
+    else
+    {
+      position = this->m_DequeuePosition.load( std::memory_order_relaxed );
+    }
+  }
+}
+
+
+void
+ProgressMonitor::Poll()
+{
+  std::lock_guard< std::mutex > lock( this->m_ConsumerMutex );
+  ProgressEvent                 event;
+  while( this->Pop( event ) )
+  {
+    if( this->m_Callback )
+    {
+      this->m_Callback( event );
+    }
+    if( this->m_KeepTimeSeries )
+    {
+      this->m_TimeSeries.push_back( std::move( event ) );
+    }
+  }
+}
+
+
+void
+ProgressMonitor::Start( std::chrono::milliseconds interval )
+{
+  if( this->m_DispatchThread.joinable() )
+  {
+    return;
+  }
+  this->m_StopDispatching = false;
+  this->m_DispatchThread  = std::thread( [ this, interval ](){
+      std::unique_lock< std::mutex > lock( this->m_DispatchMutex );
+      while( !this->m_StopDispatching )
+      {
+        lock.unlock();
+        this->Poll();
+        lock.lock();
+        this->m_DispatchCondition.wait_for( lock, interval, [ this ](){ return this->m_StopDispatching; } );
+      }
+    } );
+}
+
+
+void
+ProgressMonitor::Stop()
+{
+  if( this->m_DispatchThread.joinable() )
+  {
+    {
+      std::lock_guard< std::mutex > lock( this->m_DispatchMutex );
+      this->m_StopDispatching = true;
+    }
+    this->m_DispatchCondition.notify_all();
+    this->m_DispatchThread.join();
+  }
+  this->Poll();
+}
+
+
+ProgressMonitor::EventContainerType
+ProgressMonitor::GetTimeSeries() const
+{
+  std::lock_guard< std::mutex > lock( this->m_ConsumerMutex );
+  return this->m_TimeSeries;
+}
+
+
+ProgressMonitor::EventContainerType
+ProgressMonitor::GetTimeSeries( const std::string & component ) const
+{
+  std::lock_guard< std::mutex > lock( this->m_ConsumerMutex );
+  EventContainerType            timeSeries;
+  for( const auto & event : this->m_TimeSeries )
+  {
+    if( event.component == component )
+    {
+      timeSeries.push_back( event );
+    }
+  }
+  return timeSeries;
+}
+
+
+void
+ProgressMonitor::ClearTimeSeries()
+{
+  std::lock_guard< std::mutex > lock( this->m_ConsumerMutex );
+  this->m_TimeSeries.clear();
+}
+
+
+void
+ProgressMonitor::WriteJsonLine( std::ostream & out, const ProgressEvent & event )
+{
+  const auto flags     = out.flags();
+  const auto precision = out.precision();
+  out << std::setprecision( 10 ) << "{\"time\":";
+  WriteJsonNumber( out, event.time );
+  out << ",\"component\":";
+  WriteJsonString( out, event.component );
+  out << ",\"stage\":";
+  WriteJsonString( out, event.stage );
+  out << ",\"level\":" << event.level << ",\"iteration\":" << event.iteration << ",\"metric\":";
+  WriteJsonNumber( out, event.metricValue );
+  out << ",\"gradient_norm\":";
+  WriteJsonNumber( out, event.gradientNorm );
+  out << ",\"progress\":";
+  WriteJsonNumber( out, event.progress );
+  out << "}\n";
+  out.flags( flags );
+  out.precision( precision );
+}
+} // end namespace selx
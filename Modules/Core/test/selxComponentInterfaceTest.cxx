@@ -133,6 +133,27 @@ TEST_F( InterfaceTest, ConnectByName )
   EXPECT_EQ( IFstatus, InterfaceStatus::multiple );
 }
 
+TEST_F( InterfaceTest, CachedHandshakes )
+{
+  InterfaceCompatibilityCache::Clear();
+
+  // Handshakes between components, between prototypes and between a component and a prototype give the same status
+  // and share the cache entries of their component types.
+  auto optimizer3pPrototype = ComponentPrototype< GDOptimizer3rdPartyComponent >::Get();
+  auto metric4pPrototype    = ComponentPrototype< SSDMetric4thPartyComponent >::Get();
+
+  EXPECT_EQ( optimizer3p->CanAcceptConnectionFrom( metric4p, { { "NameOfInterface", "MetricDerivativeInterface" } } ), InterfaceStatus::noprovider );
+  EXPECT_EQ( InterfaceCompatibilityCache::Size(), 1 );
+
+  EXPECT_EQ( optimizer3pPrototype->CanAcceptConnectionFrom( *metric4pPrototype, { { "NameOfInterface", "MetricDerivativeInterface" } } ), InterfaceStatus::noprovider );
+  EXPECT_EQ( optimizer3pPrototype->CanAcceptConnectionFrom( *metric4p, { { "NameOfInterface", "MetricDerivativeInterface" } } ), InterfaceStatus::noprovider );
+  EXPECT_EQ( optimizer3p->CanAcceptConnectionFrom( *metric4pPrototype, { { "NameOfInterface", "MetricDerivativeInterface" } } ), InterfaceStatus::noprovider );
+  EXPECT_EQ( InterfaceCompatibilityCache::Size(), 1 );
+
+  EXPECT_EQ( optimizer3pPrototype->CanAcceptConnectionFrom( *metric4pPrototype, { { "NameOfInterface", "MetricValueInterface" } } ), InterfaceStatus::success );
+  EXPECT_EQ( InterfaceCompatibilityCache::Size(), 2 );
+}
+
 TEST_F( InterfaceTest, ConnectAll )
 {
   int                               connectionCount = 0;
@@ -21,6 +21,7 @@
 
 #include "selxComponentSelector.h"
 #include "selxTypeList.h"
+#include "selxKeys.h"
 #include "selxTransformComponent1.h"
 #include "selxMetricComponent1.h"
 
@@ -31,6 +32,56 @@
 
 namespace selx
 {
+// Component that counts its instantiations, to test that the ComponentSelector only constructs the selected component.
+template< int Dimensionality >
+class CountedComponent :
+  public SuperElastixComponent<
+  Accepting< >,
+  Providing< TransformedImageInterface >
+  >
+{
+public:
+
+  typedef CountedComponent< Dimensionality > Self;
+  typedef SuperElastixComponent<
+    Accepting< >,
+    Providing< TransformedImageInterface >
+    >                                        Superclass;
+
+  CountedComponent( const std::string & name, LoggerImpl & logger ) : Superclass( name, logger ) { ++NumberOfInstances; }
+  virtual ~CountedComponent() {}
+
+  virtual int GetTransformedImage() override { return 0; }
+
+  virtual bool MeetsCriterion( const typename Superclass::CriterionType & criterion ) override
+  {
+    auto status = CheckTemplateProperties( this->TemplateProperties(), criterion );
+    if( status == CriterionStatus::Satisfied )
+    {
+      return true;
+    }
+    else if( status == CriterionStatus::Failed )
+    {
+      return false;
+    }
+    return criterion.first == "SomeProperty";
+  }
+
+  static const char * GetDescription() { return "Counted Component"; }
+
+  static int NumberOfInstances;
+
+protected:
+
+  static inline const std::map< std::string, std::string > TemplateProperties()
+  {
+    return { { keys::NameOfClass, "CountedComponent" }, { keys::Dimensionality, std::to_string( Dimensionality ) } };
+  }
+};
+
+template< int Dimensionality >
+int CountedComponent< Dimensionality >::NumberOfInstances = 0;
+
 class ComponentSelectorTest : public ::testing::Test
 {
 public:
@@ -167,4 +218,58 @@ TEST_F( ComponentSelectorTest, UnknownComponent )
   EXPECT_TRUE( componentSelector->NumberOfComponents() == 0 );
   EXPECT_FALSE( componentSelector->GetComponent() );
 }
+
+TEST_F( ComponentSelectorTest, LazyInstantiation )
+{
+  auto componentSelector
+    = std::make_shared< ComponentSelector< TypeList< CountedComponent< 2 >, CountedComponent< 3 >, TransformComponent1 >>>( "nameless", *( new LoggerImpl() ) );
+
+  // Criteria that can be decided by the template properties do not instantiate any component.
+  // TransformComponent1 has no template properties, so it remains a candidate with deferred criteria.
+  componentSelector->AddCriterion( { "NameOfClass", { "CountedComponent" } } );
+  componentSelector->AddCriterion( { "Dimensionality", { "3" } } );
+  EXPECT_EQ( componentSelector->NumberOfCandidates(), 2 );
+  EXPECT_EQ( CountedComponent< 2 >::NumberOfInstances, 0 );
+  EXPECT_EQ( CountedComponent< 3 >::NumberOfInstances, 0 );
+
+  // Other criteria are deferred until the number of components or the component itself is requested
+  componentSelector->AddCriterion( { "SomeProperty", { "SomeValue" } } );
+  EXPECT_EQ( CountedComponent< 3 >::NumberOfInstances, 0 );
+  EXPECT_EQ( componentSelector->NumberOfComponents(), 1 );
+  EXPECT_EQ( CountedComponent< 3 >::NumberOfInstances, 1 );
+
+  ComponentType::Pointer component = componentSelector->GetComponent();
+  ASSERT_TRUE( component );
+  EXPECT_EQ( component, componentSelector->GetComponent() );
+  EXPECT_EQ( CountedComponent< 2 >::NumberOfInstances, 0 );
+  EXPECT_EQ( CountedComponent< 3 >::NumberOfInstances, 1 );
+}
+
+TEST_F( ComponentSelectorTest, ComponentRegistry )
+{
+  typedef ComponentRegistry< TypeList< CountedComponent< 2 >, CountedComponent< 3 >, TransformComponent1 >> RegistryType;
+  const RegistryType & registry = RegistryType::Get();
+
+  EXPECT_EQ( registry.Size(), 3 );
+  EXPECT_EQ( &registry, &RegistryType::Get() );
+
+  // TransformComponent1 has no template properties
+  ASSERT_TRUE( registry.Defining( "Dimensionality" ) );
+  EXPECT_EQ( registry.Defining( "Dimensionality" )->count(), 2 );
+  EXPECT_FALSE( registry.Defining( "PixelType" ) );
+
+  ASSERT_TRUE( registry.Matching( "Dimensionality", "2" ) );
+  EXPECT_TRUE( registry.Matching( "Dimensionality", "2" )->test( 0 ) );
+  EXPECT_FALSE( registry.Matching( "Dimensionality", "2" )->test( 1 ) );
+  EXPECT_FALSE( registry.Matching( "Dimensionality", "4" ) );
+
+  auto componentSelector = std::make_shared< ComponentSelector< TypeList< CountedComponent< 2 >, CountedComponent< 3 >, TransformComponent1 >>>( "nameless", *( new LoggerImpl() ) );
+
+  // Template properties may have only 1 value
+  EXPECT_THROW( componentSelector->AddCriterion( { "Dimensionality", { "2", "3" } } ), std::runtime_error );
+
+  componentSelector->AddCriterion( { "Dimensionality", { "4" } } );
+  EXPECT_EQ( componentSelector->NumberOfCandidates(), 1 );
+  EXPECT_EQ( componentSelector->NumberOfComponents(), 0 );
+}
 } // namespace selx
@@ -18,6 +18,7 @@
  *=========================================================================*/
 
 #include "selxNetworkBuilder.h"
+#include "selxCompiledNetwork.h"
 #include "selxLogger.h"
 
 #include "selxTransformComponent1.h"
@@ -29,10 +30,135 @@
 
 #include "selxDefaultComponents.h"
 
+#include "selxDataManager.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
 namespace selx
 {
+// A metric without state of its own, that can be shared by the components it provides to.
+class ShareableMetricComponent :
+  public SuperElastixComponent< Accepting< TransformedImageInterface >, Providing< MetricValueInterface >>
+{
+public:
+
+  ShareableMetricComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+  virtual int Accept( TransformedImageInterface::Pointer ) override { return 0; }
+  virtual int GetValue() override { return 0; }
+  virtual bool MeetsCriterion( const CriterionType & criterion ) override
+  {
+    return criterion.first == "ComponentProperty" || ( criterion.first == "NameOfClass" && criterion.second == ParameterValueType( { "ShareableMetricComponent" } ) );
+  }
+
+
+  virtual bool CanBeShared() const override { return true; }
+  static const char * GetDescription() { return "Shareable Metric Component"; }
+};
+
+// Records the metric that each instance is connected to.
+class MetricValueConsumerComponent :
+  public SuperElastixComponent< Accepting< MetricValueInterface >, Providing< >>
+{
+public:
+
+  MetricValueConsumerComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+  virtual int Accept( MetricValueInterface::Pointer metric ) override
+  {
+    AcceptedMetrics[ this->m_Name ] = metric.get();
+    return 0;
+  }
+
+
+  virtual bool MeetsCriterion( const CriterionType & criterion ) override
+  {
+    return criterion.first == "NameOfClass" && criterion.second == ParameterValueType( { "MetricValueConsumerComponent" } );
+  }
+
+
+  static const char * GetDescription() { return "Metric Value Consumer Component"; }
+
+  static std::map< std::string, MetricValueInterface * > AcceptedMetrics;
+};
+
+std::map< std::string, MetricValueInterface * > MetricValueConsumerComponent::AcceptedMetrics;
+
+// Counts the updates of the instances by name.
+class UpdateCountingComponent :
+  public SuperElastixComponent< Accepting< MetricValueInterface >, Providing< UpdateInterface >>
+{
+public:
+
+  UpdateCountingComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+  virtual int Accept( MetricValueInterface::Pointer ) override { return 0; }
+  virtual void Update() override { ++NumberOfUpdates[ this->m_Name ]; }
+  virtual bool MeetsCriterion( const CriterionType & criterion ) override
+  {
+    return criterion.first == "NameOfClass" && criterion.second == ParameterValueType( { "UpdateCountingComponent" } );
+  }
+
+
+  static const char * GetDescription() { return "Update Counting Component"; }
+
+  static std::map< std::string, int > NumberOfUpdates;
+};
+
+std::map< std::string, int > UpdateCountingComponent::NumberOfUpdates;
+
+// Counts the updates like UpdateCountingComponent, but can be shared by the components it provides to.
+class ShareableUpdateCountingComponent : public UpdateCountingComponent
+{
+public:
+
+  ShareableUpdateCountingComponent( const std::string & name, LoggerImpl & logger ) : UpdateCountingComponent( name, logger ) {}
+  virtual bool MeetsCriterion( const CriterionType & criterion ) override
+  {
+    return criterion.first == "NameOfClass" && criterion.second == ParameterValueType( { "ShareableUpdateCountingComponent" } );
+  }
+
+
+  virtual bool CanBeShared() const override { return true; }
+  static const char * GetDescription() { return "Shareable Update Counting Component"; }
+};
+
+// Records the maximum number of instances that update at the same time.
+class ConcurrencyCountingComponent :
+  public SuperElastixComponent< Accepting< MetricValueInterface >, Providing< UpdateInterface >>
+{
+public:
+
+  ConcurrencyCountingComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+  virtual int Accept( MetricValueInterface::Pointer ) override { return 0; }
+  virtual void Update() override
+  {
+    const int running = ++NumberOfRunningUpdates;
+    int       maximum = MaximumNumberOfRunningUpdates;
+    while( running > maximum && !MaximumNumberOfRunningUpdates.compare_exchange_weak( maximum, running ) )
+    {
+    }
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    --NumberOfRunningUpdates;
+  }
+
+
+  virtual bool MeetsCriterion( const CriterionType & criterion ) override
+  {
+    return criterion.first == "NameOfClass" && criterion.second == ParameterValueType( { "ConcurrencyCountingComponent" } );
+  }
+
+
+  static const char * GetDescription() { return "Concurrency Counting Component"; }
+
+  static std::atomic< int > NumberOfRunningUpdates;
+  static std::atomic< int > MaximumNumberOfRunningUpdates;
+};
+
+std::atomic< int > ConcurrencyCountingComponent::NumberOfRunningUpdates( 0 );
+std::atomic< int > ConcurrencyCountingComponent::MaximumNumberOfRunningUpdates( 0 );
+
 class NetworkBuilderTest : public ::testing::Test
 {
 public:
@@ -98,6 +224,198 @@ TEST_F( NetworkBuilderTest, Connect )
   bool success;
   EXPECT_NO_THROW( success = networkBuilder->ConnectComponents() );
 }
+TEST_F( NetworkBuilderTest, DeduceComponentsFromNonUniqueConnections )
+{
+  // None of the components is uniquely selected by its own criteria or by the connection criteria. Only by checking
+  // the handshakes between all candidates of connected components a unique selection is found:
+  // TransformComponent1 -> MetricComponent1 -> GDOptimizer4thPartyComponent
+  using RegisterComponents = TypeList< TransformComponent1, MetricComponent1, GDOptimizer4thPartyComponent >;
+
+  BlueprintPointer blueprint = BlueprintPointer( new BlueprintImpl( *logger ) ); // override old blueprint
+  blueprint->SetComponent( "A", ParameterMapType() );
+  blueprint->SetComponent( "B", ParameterMapType() );
+  blueprint->SetComponent( "C", ParameterMapType() );
+  blueprint->SetConnection( "A", "B", { {} }, "" );
+  blueprint->SetConnection( "B", "C", { {} }, "" );
+
+  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, *blueprint ) );
+  bool allUniqueComponents;
+  EXPECT_NO_THROW( allUniqueComponents = networkBuilder->Configure() );
+  EXPECT_TRUE( allUniqueComponents );
+  EXPECT_TRUE( networkBuilder->ConnectComponents() );
+}
+
+TEST_F( NetworkBuilderTest, MergeIdenticalComponents )
+{
+  // MetricA and MetricB have the same criteria and inputs, such that one metric is provided to both ConsumerA and ConsumerB.
+  // MetricC has different criteria and the consumers are not shareable, so these are not merged.
+  using RegisterComponents = TypeList< TransformComponent1, ShareableMetricComponent, MetricValueConsumerComponent >;
+
+  BlueprintPointer blueprint = BlueprintPointer( new BlueprintImpl( *logger ) ); // override old blueprint
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "TransformComponent1" } } } );
+  blueprint->SetComponent( "MetricA", { { "NameOfClass", { "ShareableMetricComponent" } } } );
+  blueprint->SetComponent( "MetricB", { { "NameOfClass", { "ShareableMetricComponent" } } } );
+  blueprint->SetComponent( "MetricC", { { "NameOfClass", { "ShareableMetricComponent" } }, { "ComponentProperty", { "Other" } } } );
+  for( const std::string suffix : { "A", "B", "C" } )
+  {
+    blueprint->SetComponent( "Consumer" + suffix, { { "NameOfClass", { "MetricValueConsumerComponent" } } } );
+    blueprint->SetConnection( "Transform", "Metric" + suffix, { {} }, "" );
+    blueprint->SetConnection( "Metric" + suffix, "Consumer" + suffix, { {} }, "" );
+  }
+
+  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, *blueprint ) );
+  EXPECT_TRUE( networkBuilder->Configure() );
+  EXPECT_TRUE( networkBuilder->ConnectComponents() );
+  EXPECT_TRUE( networkBuilder->CheckConnectionsSatisfied() );
+
+  auto & acceptedMetrics = MetricValueConsumerComponent::AcceptedMetrics;
+  ASSERT_EQ( acceptedMetrics.size(), 3 );
+  EXPECT_EQ( acceptedMetrics[ "ConsumerA" ], acceptedMetrics[ "ConsumerB" ] );
+  EXPECT_NE( acceptedMetrics[ "ConsumerA" ], acceptedMetrics[ "ConsumerC" ] );
+  acceptedMetrics.clear();
+}
+
+TEST_F( NetworkBuilderTest, MergeIdenticalUpdaters )
+{
+  // CounterA and CounterB have the same criteria and input, so they are merged into one counter that is updated once.
+  using RegisterComponents = TypeList< TransformComponent1, ShareableMetricComponent, ShareableUpdateCountingComponent >;
+
+  BlueprintPointer blueprint = BlueprintPointer( new BlueprintImpl( *logger ) ); // override old blueprint
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "TransformComponent1" } } } );
+  blueprint->SetComponent( "Metric", { { "NameOfClass", { "ShareableMetricComponent" } } } );
+  blueprint->SetConnection( "Transform", "Metric", { {} }, "" );
+  for( const std::string suffix : { "A", "B" } )
+  {
+    blueprint->SetComponent( "Counter" + suffix, { { "NameOfClass", { "ShareableUpdateCountingComponent" } } } );
+    blueprint->SetConnection( "Metric", "Counter" + suffix, { {} }, "" );
+  }
+
+  auto & numberOfUpdates = UpdateCountingComponent::NumberOfUpdates;
+  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, *blueprint ) );
+  ASSERT_TRUE( networkBuilder->Configure() );
+  ASSERT_TRUE( networkBuilder->ConnectComponents() );
+  EXPECT_EQ( networkBuilder->GetCompiledNetwork().mergedComponents.size(), 1 );
+  networkBuilder->GetRealizedNetwork().Execute();
+  ASSERT_EQ( numberOfUpdates.size(), 1 );
+  EXPECT_EQ( numberOfUpdates.begin()->second, 1 );
+  numberOfUpdates.clear();
+}
+
+TEST_F( NetworkBuilderTest, SerializeUpdatesOfSharedComponent )
+{
+  // CounterA and CounterB are independent, but both reach Metric, which does not update itself. A parallel execution must not
+  // let them pull on Metric at the same time.
+  using RegisterComponents = TypeList< TransformComponent1, ShareableMetricComponent, ConcurrencyCountingComponent >;
+
+  BlueprintPointer blueprint = BlueprintPointer( new BlueprintImpl( *logger ) ); // override old blueprint
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "TransformComponent1" } } } );
+  blueprint->SetComponent( "Metric", { { "NameOfClass", { "ShareableMetricComponent" } } } );
+  blueprint->SetConnection( "Transform", "Metric", { {} }, "" );
+  for( const std::string suffix : { "A", "B" } )
+  {
+    blueprint->SetComponent( "Counter" + suffix, { { "NameOfClass", { "ConcurrencyCountingComponent" } } } );
+    blueprint->SetConnection( "Metric", "Counter" + suffix, { {} }, "" );
+  }
+
+  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, *blueprint ) );
+  ASSERT_TRUE( networkBuilder->Configure() );
+  ASSERT_TRUE( networkBuilder->ConnectComponents() );
+  NetworkContainer & network = networkBuilder->GetRealizedNetwork();
+  network.SetNumberOfThreads( 2 );
+  ConcurrencyCountingComponent::MaximumNumberOfRunningUpdates = 0;
+  EXPECT_NO_THROW( network.Execute() );
+  EXPECT_EQ( ConcurrencyCountingComponent::MaximumNumberOfRunningUpdates, 1 );
+}
+
+TEST_F( NetworkBuilderTest, Reconfigure )
+{
+  // Modifying MetricB reconfigures MetricB and CounterB downstream, while Transform and the A branch keep their results.
+  using RegisterComponents = TypeList< TransformComponent1, ShareableMetricComponent, UpdateCountingComponent >;
+
+  BlueprintPointer blueprint = BlueprintPointer( new BlueprintImpl( *logger ) ); // override old blueprint
+  blueprint->SetComponent( "Transform", { { "NameOfClass", { "TransformComponent1" } } } );
+  for( const std::string suffix : { "A", "B" } )
+  {
+    blueprint->SetComponent( "Metric" + suffix, { { "NameOfClass", { "ShareableMetricComponent" } }, { "ComponentProperty", { suffix } } } );
+    blueprint->SetComponent( "Counter" + suffix, { { "NameOfClass", { "UpdateCountingComponent" } } } );
+    blueprint->SetConnection( "Transform", "Metric" + suffix, { {} }, "" );
+    blueprint->SetConnection( "Metric" + suffix, "Counter" + suffix, { {} }, "" );
+  }
+
+  auto & numberOfUpdates = UpdateCountingComponent::NumberOfUpdates;
+  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, *blueprint ) );
+  NetworkBuilderBase::ComponentNamesType reconfiguredComponentNames;
+  ASSERT_TRUE( networkBuilder->Configure() );
+  EXPECT_TRUE( networkBuilder->Reconfigure( reconfiguredComponentNames ) );
+  EXPECT_TRUE( reconfiguredComponentNames.empty() );
+  ASSERT_TRUE( networkBuilder->ConnectComponents() );
+  networkBuilder->GetRealizedNetwork().SetIncrementalExecution( true );
+  networkBuilder->GetRealizedNetwork().Execute();
+  networkBuilder->GetRealizedNetwork().Execute();
+  EXPECT_EQ( numberOfUpdates, ( std::map< std::string, int >( { { "CounterA", 1 }, { "CounterB", 1 } } ) ) );
+
+  blueprint->SetComponent( "MetricB", { { "NameOfClass", { "ShareableMetricComponent" } }, { "ComponentProperty", { "Modified" } } } );
+  ASSERT_TRUE( networkBuilder->Reconfigure( reconfiguredComponentNames ) );
+  std::sort( reconfiguredComponentNames.begin(), reconfiguredComponentNames.end() );
+  EXPECT_EQ( reconfiguredComponentNames, NetworkBuilderBase::ComponentNamesType( { "CounterB", "MetricB" } ) );
+  ASSERT_TRUE( networkBuilder->ConnectComponents() );
+  EXPECT_TRUE( networkBuilder->CheckConnectionsSatisfied() );
+  networkBuilder->GetRealizedNetwork().SetIncrementalExecution( true );
+  networkBuilder->GetRealizedNetwork().Execute();
+  EXPECT_EQ( numberOfUpdates, ( std::map< std::string, int >( { { "CounterA", 1 }, { "CounterB", 2 } } ) ) );
+
+  // Other components or connections need a new network
+  blueprint->SetConnection( "MetricA", "CounterB", { {} }, "" );
+  EXPECT_FALSE( networkBuilder->Reconfigure( reconfiguredComponentNames ) );
+  numberOfUpdates.clear();
+}
+
+TEST_F( NetworkBuilderTest, ConfigureFromCompiledNetwork )
+{
+  // The components of A, B and C are only found by propagating the handshakes, see DeduceComponentsFromNonUniqueConnections.
+  // The compiled network selects them directly.
+  using RegisterComponents = TypeList< TransformComponent1, MetricComponent1, GDOptimizer4thPartyComponent >;
+  const std::string fileName = DataManager::New()->GetOutputFile( "NetworkBuilderTest.ConfigureFromCompiledNetwork.selxnet" );
+
+  Blueprint::Pointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "A", ParameterMapType() );
+  blueprint->SetComponent( "B", { { "ComponentProperty", { "SomeProperty" } } } );
+  blueprint->SetComponent( "C", ParameterMapType() );
+  blueprint->SetConnection( "A", "B", { {} } );
+  blueprint->SetConnection( "B", "C", { { "NameOfInterface", { "MetricValueInterface" } } }, "Value" );
+
+  std::unique_ptr< NetworkBuilderBase > networkBuilder( new NetworkBuilder< RegisterComponents >( *logger, blueprint->GetBlueprintImpl() ) );
+  ASSERT_TRUE( networkBuilder->Configure() );
+  const CompiledNetwork compiledNetwork = networkBuilder->GetCompiledNetwork();
+  EXPECT_EQ( compiledNetwork.selectedComponents.size(), 3 );
+  EXPECT_EQ( compiledNetwork.selectedComponents.at( "B" ), 1 ); // MetricComponent1
+  compiledNetwork.Write( fileName, blueprint->GetBlueprintImpl() );
+  EXPECT_TRUE( CompiledNetwork::IsCompiledNetworkFile( fileName ) );
+
+  Blueprint::Pointer            compiledBlueprint = Blueprint::New();
+  CompiledNetwork::ConstPointer readNetwork       = CompiledNetwork::Read( fileName, *compiledBlueprint );
+  EXPECT_EQ( readNetwork->registryFingerprint, compiledNetwork.registryFingerprint );
+  EXPECT_EQ( readNetwork->selectedComponents, compiledNetwork.selectedComponents );
+  EXPECT_EQ( compiledBlueprint->GetBlueprintImpl().GetCanonicalDescription(), blueprint->GetBlueprintImpl().GetCanonicalDescription() );
+
+  std::unique_ptr< NetworkBuilderBase > compiledNetworkBuilder( new NetworkBuilder< RegisterComponents >( *logger, compiledBlueprint->GetBlueprintImpl() ) );
+  EXPECT_TRUE( compiledNetworkBuilder->ConfigureFrom( *readNetwork ) );
+  EXPECT_TRUE( compiledNetworkBuilder->ConnectComponents() );
+  EXPECT_TRUE( compiledNetworkBuilder->CheckConnectionsSatisfied() );
+
+  // The indices are meaningless for another registry
+  using OtherComponents = TypeList< GDOptimizer4thPartyComponent, MetricComponent1, TransformComponent1 >;
+  std::unique_ptr< NetworkBuilderBase > otherNetworkBuilder( new NetworkBuilder< OtherComponents >( *logger, compiledBlueprint->GetBlueprintImpl() ) );
+  EXPECT_THROW( otherNetworkBuilder->ConfigureFrom( *readNetwork ), std::runtime_error );
+
+  // A truncated file is detected
+  std::ifstream      compiledFile( fileName, std::ios::binary );
+  const std::string  content( ( std::istreambuf_iterator< char >( compiledFile ) ), std::istreambuf_iterator< char >() );
+  std::ofstream( fileName, std::ios::binary ) << content.substr( 0, content.size() - 3 );
+  Blueprint::Pointer truncatedBlueprint = Blueprint::New();
+  EXPECT_THROW( CompiledNetwork::Read( fileName, *truncatedBlueprint ), std::runtime_error );
+}
+
 TEST_F( NetworkBuilderTest, DeduceComponentsFromConnections )
 {
   // Fill the component database with all combinations of Dimensionality:[2,3], PixelType:[float,double] and InternalComputationValueType:[float,double]
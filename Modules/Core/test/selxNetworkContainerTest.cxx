@@ -0,0 +1,468 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxNetworkContainer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace selx
+{
+class NetworkContainerTest : public ::testing::Test
+{
+public:
+
+  // Records the order in which the updates are executed
+  struct RecordingUpdate : public UpdateInterface
+  {
+    RecordingUpdate( int id, std::vector< int > & record, std::mutex & mutex ) : m_Id( id ), m_Record( record ), m_Mutex( mutex ) {}
+
+    virtual void Update() override
+    {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      m_Record.push_back( m_Id );
+    }
+
+    int                  m_Id;
+    std::vector< int > & m_Record;
+    std::mutex &         m_Mutex;
+  };
+
+  // Waits until the other instances have started as well, or gives up after a second
+  struct RendezvousUpdate : public UpdateInterface
+  {
+    RendezvousUpdate( std::atomic< int > & started, int expected ) : m_Started( started ), m_Expected( expected ) {}
+
+    virtual void Update() override
+    {
+      ++m_Started;
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 1 );
+      while( m_Started < m_Expected && std::chrono::steady_clock::now() < deadline )
+      {
+        std::this_thread::yield();
+      }
+      m_Met = m_Started >= m_Expected;
+    }
+
+    std::atomic< int > & m_Started;
+    int                  m_Expected;
+    bool                 m_Met = false;
+  };
+
+  // Records when the data is released, in the same record as the updates
+  struct RecordingRelease : public ReleaseDataInterface
+  {
+    RecordingRelease( int id, std::vector< int > & record, std::mutex & mutex ) : m_Id( id ), m_Record( record ), m_Mutex( mutex ) {}
+
+    virtual void ReleaseData() override
+    {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      m_Record.push_back( m_Id );
+    }
+
+    int                  m_Id;
+    std::vector< int > & m_Record;
+    std::mutex &         m_Mutex;
+  };
+
+  // Cancels the execution during its update, like a deadline that passes during a registration
+  struct CancellingUpdate : public UpdateInterface, public CancellationInterface
+  {
+    virtual void Update() override
+    {
+      if( m_Token )
+      {
+        m_Token->Cancel();
+      }
+    }
+
+    virtual void SetCancellationToken( CancellationToken::ConstPointer token ) override { m_ReceivedToken = token; }
+
+    CancellationToken::Pointer      m_Token;
+    CancellationToken::ConstPointer m_ReceivedToken;
+  };
+
+  // Records its share of the thread budget, and the total number of threads of the updates that run concurrently with it
+  struct ThreadCountingUpdate : public UpdateInterface, public NumberOfThreadsInterface
+  {
+    ThreadCountingUpdate( std::atomic< unsigned int > & threadsInUse, std::atomic< unsigned int > & maximumThreadsInUse ) :
+      m_ThreadsInUse( threadsInUse ), m_MaximumThreadsInUse( maximumThreadsInUse ) {}
+
+    virtual void SetNumberOfThreads( unsigned int numberOfThreads ) override { m_NumberOfThreads = numberOfThreads; }
+
+    virtual void Update() override
+    {
+      const unsigned int threadsInUse = m_ThreadsInUse += std::max( m_NumberOfThreads, 1u );
+      unsigned int       maximum      = m_MaximumThreadsInUse;
+      while( threadsInUse > maximum && !m_MaximumThreadsInUse.compare_exchange_weak( maximum, threadsInUse ) )
+      {
+      }
+      std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+      m_ThreadsInUse -= std::max( m_NumberOfThreads, 1u );
+    }
+
+    std::atomic< unsigned int > & m_ThreadsInUse;
+    std::atomic< unsigned int > & m_MaximumThreadsInUse;
+    unsigned int                  m_NumberOfThreads = 0;
+  };
+
+  struct ThrowingUpdate : public UpdateInterface
+  {
+    virtual void Update() override { throw std::runtime_error( "update failed" ); }
+  };
+};
+
+TEST_F( NetworkContainerTest, SerialExecution )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  NetworkContainer::UpdateOrderType updateOrder;
+  for( int id = 0; id < 4; ++id )
+  {
+    updateOrder.push_back( std::make_shared< RecordingUpdate >( id, record, mutex ) );
+  }
+  // Without dependencies the update order is followed, regardless of the number of threads.
+  NetworkContainer network( {}, updateOrder, {} );
+  network.SetNumberOfThreads( 4 );
+  network.Execute();
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 2, 3 } ) );
+}
+
+TEST_F( NetworkContainerTest, ParallelExecution )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+  std::atomic< int > started( 0 );
+
+  // 2 independent branches that meet in a final update
+  auto branchA = std::make_shared< RendezvousUpdate >( started, 2 );
+  auto branchB = std::make_shared< RendezvousUpdate >( started, 2 );
+  NetworkContainer::UpdateOrderType updateOrder = { branchA, branchB, std::make_shared< RecordingUpdate >( 2, record, mutex ) };
+
+  NetworkContainer network( {}, updateOrder, {}, { {}, {}, { 0, 1 } } );
+  network.SetNumberOfThreads( 2 );
+  EXPECT_NO_THROW( network.Execute() );
+
+  // Both branches were running at the same time, and the final update after them.
+  EXPECT_TRUE( branchA->m_Met );
+  EXPECT_TRUE( branchB->m_Met );
+  EXPECT_EQ( record, std::vector< int >( { 2 } ) );
+}
+
+TEST_F( NetworkContainerTest, DependenciesAreRespected )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  NetworkContainer::UpdateOrderType updateOrder;
+  for( int id = 0; id < 4; ++id )
+  {
+    updateOrder.push_back( std::make_shared< RecordingUpdate >( id, record, mutex ) );
+  }
+  // A chain 0 -> 1 -> 2 -> 3 runs in order, even with multiple threads
+  NetworkContainer network( {}, updateOrder, {}, { {}, { 0 }, { 1 }, { 2 } } );
+  network.SetNumberOfThreads( 4 );
+  network.Execute();
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 2, 3 } ) );
+}
+
+TEST_F( NetworkContainerTest, SerializedUpdates )
+{
+  std::atomic< unsigned int > threadsInUse( 0 );
+  std::atomic< unsigned int > maximumThreadsInUse( 0 );
+
+  // 3 independent updates, of which 0 and 2 share upstream data and 1 can run along with them
+  NetworkContainer::UpdateOrderType updateOrder;
+  for( int id = 0; id < 3; ++id )
+  {
+    updateOrder.push_back( std::make_shared< ThreadCountingUpdate >( threadsInUse, maximumThreadsInUse ) );
+  }
+  NetworkContainer network( {}, updateOrder, {}, { {}, {}, {} }, {}, {}, {}, { { 2, 0 } } );
+  network.SetNumberOfThreads( 3 );
+  EXPECT_NO_THROW( network.Execute() );
+  EXPECT_EQ( maximumThreadsInUse, 2 );
+
+  // Each Execute with all three in one group updates them one at a time
+  maximumThreadsInUse = 0;
+  NetworkContainer serialNetwork( {}, updateOrder, {}, { {}, {}, {} }, {}, {}, {}, { { 0, 1, 2 } } );
+  serialNetwork.SetNumberOfThreads( 3 );
+  EXPECT_NO_THROW( serialNetwork.Execute() );
+  EXPECT_EQ( maximumThreadsInUse, 1 );
+}
+
+TEST_F( NetworkContainerTest, ExceptionIsRethrown )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  NetworkContainer::UpdateOrderType updateOrder = { std::make_shared< ThrowingUpdate >(), std::make_shared< RecordingUpdate >( 1, record, mutex ) };
+  NetworkContainer network( {}, updateOrder, {}, { {}, { 0 } } );
+  network.SetNumberOfThreads( 2 );
+  EXPECT_THROW( network.Execute(), std::runtime_error );
+
+  // The dependent update is not executed
+  EXPECT_TRUE( record.empty() );
+}
+TEST_F( NetworkContainerTest, RequestedOutputs )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  NetworkContainer::UpdateOrderType updateOrder;
+  for( int id = 0; id < 5; ++id )
+  {
+    updateOrder.push_back( std::make_shared< RecordingUpdate >( id, record, mutex ) );
+  }
+  // Output A depends on the chain 0 -> 2, output B on 1. Update 3 (e.g. a controller) feeds no output and depends on 1.
+  // Update 4 feeds no output either.
+  NetworkContainer::UpdateDependenciesType updateDependencies = { {}, {}, { 0 }, { 1 }, {} };
+  NetworkContainer::OutputDependenciesType outputDependencies = { { "A", { 0, 2 } }, { "B", { 1 } } };
+  NetworkContainer network( {}, updateOrder, {}, updateDependencies, outputDependencies );
+
+  network.Execute( { "A" } );
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 2, 3, 4 } ) );
+
+  // The chain of A is skipped
+  record.clear();
+  network.Execute( { "B" } );
+  EXPECT_EQ( record, std::vector< int >( { 1, 3, 4 } ) );
+
+  record.clear();
+  network.SetNumberOfThreads( 4 );
+  network.Execute( { "B" } );
+  std::sort( record.begin(), record.end() );
+  EXPECT_EQ( record, std::vector< int >( { 1, 3, 4 } ) );
+
+  record.clear();
+  network.Execute();
+  std::sort( record.begin(), record.end() );
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 2, 3, 4 } ) );
+}
+
+TEST_F( NetworkContainerTest, UnrequestedOutputsAreSkipped )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  NetworkContainer::UpdateOrderType updateOrder;
+  for( int id = 0; id < 3; ++id )
+  {
+    updateOrder.push_back( std::make_shared< RecordingUpdate >( id, record, mutex ) );
+  }
+  // A warped image, a displacement field and a transform from independent components: only the requested one is computed
+  NetworkContainer network( {}, updateOrder, {}, { {}, {}, {} }, { { "WarpedImage", { 0 } }, { "DisplacementField", { 1 } }, { "Transform", { 2 } } } );
+  network.Execute( { "DisplacementField" } );
+  EXPECT_EQ( record, std::vector< int >( { 1 } ) );
+
+  record.clear();
+  network.Execute( {} );
+  EXPECT_TRUE( record.empty() );
+}
+TEST_F( NetworkContainerTest, ReleaseIntermediateData )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  NetworkContainer::UpdateOrderType updateOrder;
+  for( int id = 0; id < 3; ++id )
+  {
+    updateOrder.push_back( std::make_shared< RecordingUpdate >( id, record, mutex ) );
+  }
+  // The data of component 10 is used by updates 0 and 1, that of component 11 after Execute only
+  NetworkContainer::ReleaseDataType releaseData = {
+    { std::make_shared< RecordingRelease >( 10, record, mutex ), { 0, 1 } },
+    { std::make_shared< RecordingRelease >( 11, record, mutex ), {} }
+  };
+  NetworkContainer network( {}, updateOrder, {}, { {}, { 0 }, { 1 } }, {}, releaseData );
+
+  network.Execute();
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 10, 2 } ) );
+
+  record.clear();
+  network.ReleaseData();
+  EXPECT_EQ( record, std::vector< int >( { 10, 11 } ) );
+
+  // In parallel the data is released after its last user as well
+  record.clear();
+  network.SetNumberOfThreads( 2 );
+  network.Execute();
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 10, 2 } ) );
+
+  // Opt-out
+  record.clear();
+  network.SetReleaseIntermediateData( false );
+  network.Execute();
+  EXPECT_EQ( record, std::vector< int >( { 0, 1, 2 } ) );
+}
+
+TEST_F( NetworkContainerTest, IncrementalExecution )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+
+  // Updates a component that releases its data, and its data when released
+  struct RecordingUpdateRelease : public RecordingUpdate, public ReleaseDataInterface
+  {
+    RecordingUpdateRelease( int id, std::vector< int > & record, std::mutex & mutex ) : RecordingUpdate( id, record, mutex ) {}
+
+    virtual void ReleaseData() override {}
+  };
+
+  // 2 independent branches: 0 -> 1 -> 2 and 3
+  auto releasing = std::make_shared< RecordingUpdateRelease >( 0, record, mutex );
+  NetworkContainer::UpdateOrderType updateOrder = { releasing, std::make_shared< RecordingUpdate >( 1, record, mutex ),
+                                                    std::make_shared< RecordingUpdate >( 2, record, mutex ),
+                                                    std::make_shared< RecordingUpdate >( 3, record, mutex ) };
+  NetworkContainer network( {}, updateOrder, {}, { {}, { 0 }, { 1 }, {} }, {}, { { releasing, { 0 } } } );
+  network.SetIncrementalExecution( true );
+  network.SetReleaseIntermediateData( false );
+
+  for( unsigned int numberOfThreads : { 1, 2 } )
+  {
+    network.SetNumberOfThreads( numberOfThreads );
+    network.Invalidate();
+    record.clear();
+    network.Execute();
+    std::sort( record.begin(), record.end() );
+    EXPECT_EQ( record, std::vector< int >( { 0, 1, 2, 3 } ) );
+    EXPECT_EQ( network.GetUpToDate(), std::vector< bool >( 4, true ) );
+
+    // Nothing is invalidated
+    record.clear();
+    network.Execute();
+    EXPECT_TRUE( record.empty() );
+
+    // An invalidated update is executed together with the updates that depend on it
+    network.SetUpToDate( { true, false, true, true } );
+    network.Execute();
+    EXPECT_EQ( record, std::vector< int >( { 1, 2 } ) );
+
+    // Released data is computed again
+    record.clear();
+    network.ReleaseData();
+    EXPECT_EQ( network.GetUpToDate(), std::vector< bool >( { false, true, true, true } ) );
+    network.Execute();
+    EXPECT_EQ( record, std::vector< int >( { 0, 1, 2 } ) );
+  }
+}
+
+TEST_F( NetworkContainerTest, Cancellation )
+{
+  std::vector< int > record;
+  std::mutex         mutex;
+  auto               token = std::make_shared< CancellationToken >();
+
+  auto cancellingUpdate = std::make_shared< CancellingUpdate >();
+  NetworkContainer::UpdateOrderType updateOrder = { std::make_shared< RecordingUpdate >( 0, record, mutex ), cancellingUpdate,
+                                                    std::make_shared< RecordingUpdate >( 2, record, mutex ) };
+  // Output A depends on 0 only, output B on the interrupted 1 and on 2
+  NetworkContainer::OutputObjectsMapType   outputObjectsMap   = { { "A", nullptr }, { "B", nullptr } };
+  NetworkContainer::OutputDependenciesType outputDependencies = { { "A", { 0 } }, { "B", { 1, 2 } } };
+  NetworkContainer network( {}, updateOrder, outputObjectsMap, { {}, { 0 }, { 1 } }, outputDependencies, {},
+    { cancellingUpdate } );
+
+  // Not cancellable by default
+  network.Execute();
+  EXPECT_EQ( record, std::vector< int >( { 0, 2 } ) );
+  EXPECT_EQ( network.GetFinishedOutputNames(), NetworkContainer::OutputNamesType( { "A", "B" } ) );
+
+  // The component interrupted by the cancellation does not count as finished, and no updates are started after it
+  record.clear();
+  cancellingUpdate->m_Token = token;
+  network.SetCancellationToken( token );
+  EXPECT_THROW( network.Execute(), ExecutionCancelledException );
+  EXPECT_EQ( cancellingUpdate->m_ReceivedToken, token );
+  EXPECT_EQ( record, std::vector< int >( { 0 } ) );
+  EXPECT_EQ( network.GetFinishedOutputNames(), NetworkContainer::OutputNamesType( { "A" } ) );
+
+  // A passed deadline cancels before the first update, also in parallel
+  record.clear();
+  auto expiredToken = std::make_shared< CancellationToken >();
+  expiredToken->SetTimeout( 0.0 );
+  EXPECT_TRUE( expiredToken->IsCancelled() );
+  network.SetCancellationToken( expiredToken );
+  network.SetNumberOfThreads( 2 );
+  EXPECT_THROW( network.Execute(), ExecutionCancelledException );
+  EXPECT_TRUE( record.empty() );
+  EXPECT_TRUE( network.GetFinishedOutputNames().empty() );
+
+  // A deadline in the future does not interfere
+  auto futureToken = std::make_shared< CancellationToken >();
+  futureToken->SetTimeout( 3600.0 );
+  network.SetCancellationToken( futureToken );
+  network.SetNumberOfThreads( 1 );
+  network.Execute( { "A" } );
+  EXPECT_EQ( record, std::vector< int >( { 0 } ) );
+  EXPECT_EQ( network.GetFinishedOutputNames(), NetworkContainer::OutputNamesType( { "A" } ) );
+}
+
+TEST_F( NetworkContainerTest, ThreadBudget )
+{
+  std::atomic< unsigned int >                            threadsInUse( 0 );
+  std::atomic< unsigned int >                            maximumThreadsInUse( 0 );
+  std::vector< std::shared_ptr< ThreadCountingUpdate > > updates;
+  NetworkContainer::UpdateOrderType                      updateOrder;
+  for( int id = 0; id < 4; ++id )
+  {
+    updates.push_back( std::make_shared< ThreadCountingUpdate >( threadsInUse, maximumThreadsInUse ) );
+    updateOrder.push_back( updates.back() );
+  }
+  // Independent updates
+  NetworkContainer network( {}, updateOrder, {}, { {}, {}, {}, {} } );
+
+  // Without a budget the components keep their own number of threads
+  network.Execute();
+  for( const auto & update : updates )
+  {
+    EXPECT_EQ( update->m_NumberOfThreads, 0 );
+  }
+
+  // Serially each update has the whole budget
+  network.SetThreadBudget( 8 );
+  network.Execute();
+  for( const auto & update : updates )
+  {
+    EXPECT_EQ( update->m_NumberOfThreads, 8 );
+  }
+
+  // Concurrently the budget is divided. The first update shares it with the update that the other worker starts.
+  maximumThreadsInUse = 0;
+  network.SetNumberOfThreads( 2 );
+  network.Execute();
+  EXPECT_EQ( updates[ 0 ]->m_NumberOfThreads, 4 );
+  for( const auto & update : updates )
+  {
+    EXPECT_GE( update->m_NumberOfThreads, 1 );
+  }
+  EXPECT_LE( maximumThreadsInUse, 8 );
+
+  // The budget also limits the number of concurrent updates
+  maximumThreadsInUse = 0;
+  network.SetThreadBudget( 1 );
+  network.SetNumberOfThreads( 4 );
+  network.Execute();
+  EXPECT_EQ( maximumThreadsInUse, 1 );
+}
+} // namespace selx
@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxProfiler.h"
+#include "selxNetworkContainer.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace selx
+{
+class ProfilerTest : public ::testing::Test
+{
+public:
+
+  struct SleepingUpdate : public UpdateInterface
+  {
+    virtual void Update() override { std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) ); }
+  };
+};
+
+TEST_F( ProfilerTest, Scope )
+{
+  Profiler profiler;
+  {
+    Profiler::Scope outer( &profiler, "Outer", "phase" );
+    Profiler::Scope inner( &profiler, "Inner \"quoted\"", "component" );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+  }
+  // Without a profiler nothing is recorded
+  {
+    Profiler::Scope scope( nullptr, "Ignored", "phase" );
+  }
+
+  auto events = profiler.GetEvents();
+  ASSERT_EQ( events.size(), 2 );
+  EXPECT_EQ( events[ 0 ].name, "Inner \"quoted\"" );
+  EXPECT_EQ( events[ 1 ].name, "Outer" );
+  EXPECT_GE( events[ 0 ].wallTime, 10000 );
+  EXPECT_GE( events[ 1 ].wallTime, events[ 0 ].wallTime );
+  EXPECT_LE( events[ 1 ].startTime, events[ 0 ].startTime );
+  EXPECT_EQ( events[ 0 ].threadIndex, events[ 1 ].threadIndex );
+
+  auto totalWallTimes = profiler.GetTotalWallTimes( "component" );
+  ASSERT_EQ( totalWallTimes.size(), 1 );
+  EXPECT_GE( totalWallTimes[ "Inner \"quoted\"" ], 0.01 );
+
+  std::ostringstream trace;
+  profiler.WriteChromeTrace( trace );
+  EXPECT_NE( trace.str().find( "\"traceEvents\"" ), std::string::npos );
+  EXPECT_NE( trace.str().find( "\"name\":\"Inner \\\"quoted\\\"\"" ), std::string::npos );
+  EXPECT_NE( trace.str().find( "\"ph\":\"X\"" ), std::string::npos );
+
+  std::ostringstream summary;
+  profiler.WriteSummary( summary );
+  // Sorted by wall time
+  EXPECT_LT( summary.str().find( "Outer" ), summary.str().find( "Inner" ) );
+
+  profiler.Clear();
+  EXPECT_TRUE( profiler.GetEvents().empty() );
+}
+
+TEST_F( ProfilerTest, NetworkContainer )
+{
+  NetworkContainer::UpdateOrderType updateOrder = { std::make_shared< SleepingUpdate >(), std::make_shared< SleepingUpdate >() };
+  NetworkContainer                  network( {}, updateOrder, {}, { {}, {} } );
+
+  // Unprofiled by default
+  Profiler profiler;
+  network.Execute();
+  EXPECT_TRUE( profiler.GetEvents().empty() );
+
+  // Updates that are not of a Component are recorded by their index in the update order
+  network.SetProfiler( &profiler );
+  network.SetNumberOfThreads( 2 );
+  network.Execute();
+  auto totalWallTimes = profiler.GetTotalWallTimes( "component" );
+  ASSERT_EQ( totalWallTimes.size(), 2 );
+  EXPECT_GE( totalWallTimes[ "Update 0" ], 0.01 );
+  EXPECT_GE( totalWallTimes[ "Update 1" ], 0.01 );
+}
+} // namespace selx
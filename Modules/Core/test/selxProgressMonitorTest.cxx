@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxProgressMonitor.h"
+#include "selxNetworkContainer.h"
+#include "selxSuperElastixComponent.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <thread>
+
+namespace selx
+{
+class ProgressMonitorTest : public ::testing::Test
+{
+public:
+
+  class IteratingComponent : public SuperElastixComponent< Accepting< >, Providing< UpdateInterface > >
+  {
+  public:
+
+    IteratingComponent( const std::string & name, LoggerImpl & logger ) : SuperElastixComponent( name, logger ) {}
+    virtual bool MeetsCriterion( const CriterionType & ) override { return true; }
+    virtual void Update() override
+    {
+      for( unsigned long iteration = 0; iteration < 3; ++iteration )
+      {
+        ProgressEvent event;
+        event.stage       = "iteration";
+        event.iteration   = iteration;
+        event.metricValue = 1.0 / ( iteration + 1 );
+        this->ReportProgress( event );
+      }
+    }
+  };
+
+  static ProgressEvent MakeEvent( const std::string & component, unsigned long iteration )
+  {
+    ProgressEvent event;
+    event.component = component;
+    event.stage     = "iteration";
+    event.iteration = iteration;
+    return event;
+  }
+};
+
+TEST_F( ProgressMonitorTest, PublishAndPoll )
+{
+  ProgressMonitor                     monitor;
+  ProgressMonitor::EventContainerType received;
+  monitor.SetCallback( [ &received ]( const ProgressEvent & event ){ received.push_back( event ); } );
+
+  EXPECT_TRUE( monitor.Publish( MakeEvent( "A", 0 ) ) );
+  EXPECT_TRUE( monitor.Publish( MakeEvent( "B", 0 ) ) );
+  EXPECT_TRUE( monitor.Publish( MakeEvent( "A", 1 ) ) );
+  EXPECT_TRUE( received.empty() );
+
+  monitor.Poll();
+  ASSERT_EQ( received.size(), 3 );
+  EXPECT_EQ( received[ 2 ].component, "A" );
+  EXPECT_EQ( received[ 2 ].iteration, 1 );
+  EXPECT_LE( received[ 0 ].time, received[ 2 ].time );
+
+  EXPECT_EQ( monitor.GetTimeSeries().size(), 3 );
+  EXPECT_EQ( monitor.GetTimeSeries( "A" ).size(), 2 );
+  monitor.ClearTimeSeries();
+  EXPECT_TRUE( monitor.GetTimeSeries().empty() );
+}
+
+TEST_F( ProgressMonitorTest, Overflow )
+{
+  ProgressMonitor monitor( 4 );
+  for( unsigned long iteration = 0; iteration < 4; ++iteration )
+  {
+    EXPECT_TRUE( monitor.Publish( MakeEvent( "A", iteration ) ) );
+  }
+  // Full: dropped rather than blocking
+  EXPECT_FALSE( monitor.Publish( MakeEvent( "A", 4 ) ) );
+  EXPECT_EQ( monitor.GetNumberOfDroppedEvents(), 1 );
+
+  monitor.Poll();
+  EXPECT_EQ( monitor.GetTimeSeries().size(), 4 );
+  EXPECT_TRUE( monitor.Publish( MakeEvent( "A", 5 ) ) );
+}
+
+TEST_F( ProgressMonitorTest, ConcurrentPublishers )
+{
+  const unsigned int  numberOfThreads = 4;
+  const unsigned long numberOfEvents  = 10000;
+  ProgressMonitor     monitor( 256 );
+  std::size_t         numberOfReceivedEvents = 0;
+  monitor.SetKeepTimeSeries( false );
+  monitor.SetCallback( [ &numberOfReceivedEvents ]( const ProgressEvent & ){ ++numberOfReceivedEvents; } );
+  monitor.Start( std::chrono::milliseconds( 1 ) );
+
+  std::vector< std::thread > publishers;
+  for( unsigned int thread = 0; thread < numberOfThreads; ++thread )
+  {
+    publishers.emplace_back( [ &monitor, thread, numberOfEvents ](){
+        for( unsigned long iteration = 0; iteration < numberOfEvents; ++iteration )
+        {
+          monitor.Publish( MakeEvent( std::to_string( thread ), iteration ) );
+        }
+      } );
+  }
+  for( auto & publisher : publishers )
+  {
+    publisher.join();
+  }
+  monitor.Stop();
+
+  // Every event is either received or counted as dropped
+  EXPECT_EQ( numberOfReceivedEvents + monitor.GetNumberOfDroppedEvents(), numberOfThreads * numberOfEvents );
+  EXPECT_TRUE( monitor.GetTimeSeries().empty() );
+}
+
+TEST_F( ProgressMonitorTest, JsonLine )
+{
+  ProgressEvent event = MakeEvent( "Registration \"1\"", 7 );
+  event.level       = 2;
+  event.metricValue = 0.5;
+
+  std::ostringstream line;
+  ProgressMonitor::WriteJsonLine( line, event );
+  EXPECT_NE( line.str().find( "\"component\":\"Registration \\\"1\\\"\"" ), std::string::npos );
+  EXPECT_NE( line.str().find( "\"level\":2" ), std::string::npos );
+  EXPECT_NE( line.str().find( "\"iteration\":7" ), std::string::npos );
+  EXPECT_NE( line.str().find( "\"metric\":0.5" ), std::string::npos );
+  // Not applicable
+  EXPECT_NE( line.str().find( "\"gradient_norm\":null" ), std::string::npos );
+  EXPECT_EQ( line.str().back(), '\n' );
+  EXPECT_EQ( line.str().find( '\n' ), line.str().size() - 1 );
+}
+
+TEST_F( ProgressMonitorTest, NetworkContainer )
+{
+  LoggerImpl                        logger;
+  auto                              component   = std::make_shared< IteratingComponent >( "Optimizer", logger );
+  NetworkContainer::UpdateOrderType updateOrder = { component };
+  NetworkContainer                  network( { component }, updateOrder, {}, { {} } );
+
+  // Unmonitored by default
+  network.Execute();
+
+  ProgressMonitor monitor;
+  network.SetProgressMonitor( &monitor );
+  network.Execute();
+  monitor.Poll();
+
+  auto events = monitor.GetTimeSeries();
+  ASSERT_EQ( events.size(), 5 );
+  EXPECT_EQ( events[ 0 ].stage, "started" );
+  EXPECT_EQ( events[ 0 ].component, "Optimizer" );
+  EXPECT_EQ( events[ 1 ].stage, "iteration" );
+  EXPECT_EQ( events[ 1 ].component, "Optimizer" );
+  EXPECT_EQ( events[ 3 ].iteration, 2 );
+  EXPECT_DOUBLE_EQ( events[ 3 ].metricValue, 1.0 / 3.0 );
+  EXPECT_EQ( events[ 4 ].stage, "finished" );
+}
+} // namespace selx
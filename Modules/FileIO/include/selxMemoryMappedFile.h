@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxMemoryMappedFile_h
+#define selxMemoryMappedFile_h
+
+#include "itkMacro.h"
+
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \class MemoryMappedFile
+ * \brief Maps a file into memory copy-on-write. Pages are read from the page cache on first access, such that processes
+ * that map the same file share them, and writing to the memory does not modify the file.
+ */
+namespace selx
+{
+class MemoryMappedFile
+{
+public:
+
+  explicit MemoryMappedFile( const std::string & fileName );
+  ~MemoryMappedFile();
+
+  MemoryMappedFile( const MemoryMappedFile & ) = delete;
+  MemoryMappedFile & operator=( const MemoryMappedFile & ) = delete;
+
+  char * GetData( void ) const { return this->m_Data; }
+  size_t GetSize( void ) const { return this->m_Size; }
+
+private:
+
+  char * m_Data;
+  size_t m_Size;
+
+#ifdef _WIN32
+  HANDLE m_File;
+  HANDLE m_Mapping;
+#endif
+};
+
+#ifdef _WIN32
+
+inline
+MemoryMappedFile
+::MemoryMappedFile( const std::string & fileName ) : m_Data( nullptr ), m_Size( 0 ), m_File( INVALID_HANDLE_VALUE ), m_Mapping( nullptr )
+{
+  this->m_File = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+  LARGE_INTEGER size;
+  if( this->m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx( this->m_File, &size ) || size.QuadPart == 0 )
+  {
+    if( this->m_File != INVALID_HANDLE_VALUE )
+    {
+      CloseHandle( this->m_File );
+    }
+    itkGenericExceptionMacro( "Could not open " << fileName << " for memory mapping." );
+  }
+  this->m_Size = static_cast< size_t >( size.QuadPart );
+
+  this->m_Mapping = CreateFileMappingA( this->m_File, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+  if( this->m_Mapping != nullptr )
+  {
+    this->m_Data = static_cast< char * >( MapViewOfFile( this->m_Mapping, FILE_MAP_COPY, 0, 0, 0 ) );
+  }
+  if( this->m_Data == nullptr )
+  {
+    if( this->m_Mapping != nullptr )
+    {
+      CloseHandle( this->m_Mapping );
+    }
+    CloseHandle( this->m_File );
+    itkGenericExceptionMacro( "Could not memory map " << fileName << "." );
+  }
+}
+
+
+inline
+MemoryMappedFile
+::~MemoryMappedFile()
+{
+  UnmapViewOfFile( this->m_Data );
+  CloseHandle( this->m_Mapping );
+  CloseHandle( this->m_File );
+}
+
+#else
+
+inline
+MemoryMappedFile
+::MemoryMappedFile( const std::string & fileName ) : m_Data( nullptr ), m_Size( 0 )
+{
+  const int file = open( fileName.c_str(), O_RDONLY );
+  struct stat status;
+  if( file < 0 || fstat( file, &status ) != 0 || status.st_size == 0 )
+  {
+    if( file >= 0 )
+    {
+      close( file );
+    }
+    itkGenericExceptionMacro( "Could not open " << fileName << " for memory mapping." );
+  }
+  this->m_Size = static_cast< size_t >( status.st_size );
+
+  // The mapping stays valid after closing the file
+  void * data = mmap( nullptr, this->m_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0 );
+  close( file );
+  if( data == MAP_FAILED )
+  {
+    itkGenericExceptionMacro( "Could not memory map " << fileName << "." );
+  }
+  this->m_Data = static_cast< char * >( data );
+}
+
+
+inline
+MemoryMappedFile
+::~MemoryMappedFile()
+{
+  munmap( this->m_Data, this->m_Size );
+}
+
+#endif
+} // namespace selx
+
+#endif // selxMemoryMappedFile_h
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxMemoryMappedImageFileReader_h
+#define selxMemoryMappedImageFileReader_h
+
+#include "selxMemoryMappedFile.h"
+
+#include "itkImageSource.h"
+#include "itkImageFileReader.h"
+#include "itkImportImageContainer.h"
+
+#include <memory>
+
+/**
+ * \class MemoryMappedImageFileReader
+ * \brief Reads uncompressed MetaImage, NRRD and NIfTI files by mapping them into memory, without copying the voxels, if
+ * their pixel type and byte order are those of TImage. Other files are read by an itk::ImageFileReader.
+ *
+ * The header is read by the ImageIO that itk::ImageFileReader would use, such that the image information is the same.
+ * The voxels are read from the page cache on first access, and writing to them does not modify the file.
+ */
+namespace selx
+{
+/** Pixel container of which the buffer is (part of) a MemoryMappedFile, which it keeps mapped as long as it exists */
+template< typename TElement >
+class MemoryMappedImageContainer : public itk::ImportImageContainer< itk::SizeValueType, TElement >
+{
+public:
+
+  /** Standard ITK typedefs. */
+  typedef MemoryMappedImageContainer                                 Self;
+  typedef itk::ImportImageContainer< itk::SizeValueType, TElement > Superclass;
+  typedef itk::SmartPointer< Self >                                  Pointer;
+  typedef itk::SmartPointer< const Self >                            ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( MemoryMappedImageContainer, ImportImageContainer );
+
+  void SetMappedFile( const std::shared_ptr< MemoryMappedFile > & mappedFile, const size_t & offset, const itk::SizeValueType & numberOfElements )
+  {
+    this->m_MappedFile = mappedFile;
+    this->SetImportPointer( reinterpret_cast< TElement * >( mappedFile->GetData() + offset ), numberOfElements, false );
+  }
+
+protected:
+
+  MemoryMappedImageContainer() {}
+  ~MemoryMappedImageContainer() {}
+
+private:
+
+  std::shared_ptr< MemoryMappedFile > m_MappedFile;
+};
+
+template< typename TImage >
+class MemoryMappedImageFileReader : public itk::ImageSource< TImage >
+{
+public:
+
+  /** Standard ITK typedefs. */
+  typedef MemoryMappedImageFileReader     Self;
+  typedef itk::ImageSource< TImage >      Superclass;
+  typedef itk::SmartPointer< Self >       Pointer;
+  typedef itk::SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( MemoryMappedImageFileReader, ImageSource );
+
+  typedef TImage                                                   OutputImageType;
+  typedef typename OutputImageType::PixelType                      PixelType;
+  typedef MemoryMappedImageContainer< PixelType >                  PixelContainerType;
+  typedef itk::ImageFileReader< OutputImageType >                  FallbackReaderType;
+
+  itkSetStringMacro( FileName );
+  itkGetStringMacro( FileName );
+
+  /** Whether the file is mapped into memory rather than read by the fallback reader. Known after UpdateOutputInformation. */
+  itkGetConstMacro( IsMemoryMapped, bool );
+
+protected:
+
+  MemoryMappedImageFileReader();
+  ~MemoryMappedImageFileReader() {}
+
+  virtual void GenerateOutputInformation( void ) ITK_OVERRIDE;
+
+  virtual void EnlargeOutputRequestedRegion( itk::DataObject * output ) ITK_OVERRIDE;
+
+  virtual void GenerateData( void ) ITK_OVERRIDE;
+
+private:
+
+  /** Finds the file and offset of the voxels. Returns false if they cannot be used as they are. */
+  bool GetMappableData( itk::ImageIOBase * imageIO );
+
+  bool GetMetaImageData( bool & dataAtEndOfFile );
+  bool GetNrrdData( bool & dataAtEndOfFile );
+  bool GetNiftiData( void );
+
+  /** Splits a header line into a trimmed key and value. Returns false if the line has no separator. */
+  static bool SplitHeaderLine( const std::string & line, const std::string & separator, std::string & key, std::string & value );
+
+  std::string m_FileName;
+  bool        m_IsMemoryMapped;
+
+  std::string m_DataFileName;
+  size_t      m_DataOffset;
+
+  typename FallbackReaderType::Pointer m_FallbackReader;
+};
+} // namespace selx
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "selxMemoryMappedImageFileReader.hxx"
+#endif
+
+#endif // selxMemoryMappedImageFileReader_h
@@ -0,0 +1,420 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxMemoryMappedImageFileReader_hxx
+#define selxMemoryMappedImageFileReader_hxx
+
+#include "selxMemoryMappedImageFileReader.h"
+
+#include "itkImageIOFactory.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace selx
+{
+template< typename TImage >
+MemoryMappedImageFileReader< TImage >
+::MemoryMappedImageFileReader() : m_IsMemoryMapped( false ), m_DataOffset( 0 )
+{
+  this->m_FallbackReader = FallbackReaderType::New();
+}
+
+
+template< typename TImage >
+void
+MemoryMappedImageFileReader< TImage >
+::GenerateOutputInformation( void )
+{
+  OutputImageType * output = this->GetOutput();
+
+  if( this->m_FileName.empty() )
+  {
+    itkExceptionMacro( "A FileName must be specified." );
+  }
+
+  itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO( this->m_FileName.c_str(), itk::ImageIOFactory::ReadMode );
+  this->m_IsMemoryMapped = false;
+  if( imageIO.IsNotNull() )
+  {
+    imageIO->SetFileName( this->m_FileName );
+    imageIO->ReadImageInformation();
+    this->m_IsMemoryMapped = this->GetMappableData( imageIO );
+  }
+
+  if( !this->m_IsMemoryMapped )
+  {
+    // Let ImageFileReader handle compression, conversion and errors
+    this->m_FallbackReader->SetFileName( this->m_FileName );
+    this->m_FallbackReader->UpdateOutputInformation();
+    output->CopyInformation( this->m_FallbackReader->GetOutput() );
+    output->SetMetaDataDictionary( this->m_FallbackReader->GetOutput()->GetMetaDataDictionary() );
+    return;
+  }
+
+  typename OutputImageType::SizeType      size;
+  typename OutputImageType::IndexType     index;
+  typename OutputImageType::SpacingType   spacing;
+  typename OutputImageType::PointType     origin;
+  typename OutputImageType::DirectionType direction;
+  for( unsigned int i = 0; i < OutputImageType::ImageDimension; ++i )
+  {
+    size[ i ]    = imageIO->GetDimensions( i );
+    index[ i ]   = 0;
+    spacing[ i ] = imageIO->GetSpacing( i );
+    origin[ i ]  = imageIO->GetOrigin( i );
+    const std::vector< double > axis = imageIO->GetDirection( i );
+    for( unsigned int j = 0; j < OutputImageType::ImageDimension; ++j )
+    {
+      direction[ j ][ i ] = axis[ j ];
+    }
+  }
+
+  output->SetSpacing( spacing );
+  output->SetOrigin( origin );
+  output->SetDirection( direction );
+  output->SetLargestPossibleRegion( typename OutputImageType::RegionType( index, size ) );
+  output->SetMetaDataDictionary( imageIO->GetMetaDataDictionary() );
+}
+
+
+template< typename TImage >
+void
+MemoryMappedImageFileReader< TImage >
+::EnlargeOutputRequestedRegion( itk::DataObject * output )
+{
+  if( this->m_IsMemoryMapped )
+  {
+    // The whole file is mapped at no cost, pages that are not accessed are never read
+    output->SetRequestedRegionToLargestPossibleRegion();
+  }
+  else
+  {
+    Superclass::EnlargeOutputRequestedRegion( output );
+  }
+}
+
+
+template< typename TImage >
+void
+MemoryMappedImageFileReader< TImage >
+::GenerateData( void )
+{
+  OutputImageType * output = this->GetOutput();
+
+  if( !this->m_IsMemoryMapped )
+  {
+    // Nothing is requested when the consumers of the image defer reading it until they request the regions they need
+    if( output->GetRequestedRegion().GetNumberOfPixels() == 0 )
+    {
+      output->SetBufferedRegion( output->GetRequestedRegion() );
+      return;
+    }
+
+    // Update() would request the largest possible region instead of an empty one, so the requested region is
+    // propagated explicitly
+    typename OutputImageType::Pointer fallbackOutput = this->m_FallbackReader->GetOutput();
+    fallbackOutput->SetRequestedRegion( output->GetRequestedRegion() );
+    fallbackOutput->PropagateRequestedRegion();
+    fallbackOutput->UpdateOutputData();
+    output->Graft( fallbackOutput );
+    return;
+  }
+
+  const itk::SizeValueType numberOfPixels = output->GetLargestPossibleRegion().GetNumberOfPixels();
+  std::shared_ptr< MemoryMappedFile > mappedFile = std::make_shared< MemoryMappedFile >( this->m_DataFileName );
+  if( mappedFile->GetSize() < this->m_DataOffset + numberOfPixels * sizeof( PixelType ) )
+  {
+    itkExceptionMacro( "The data file " << this->m_DataFileName << " of " << this->m_FileName << " is too small." );
+  }
+
+  typename PixelContainerType::Pointer pixelContainer = PixelContainerType::New();
+  pixelContainer->SetMappedFile( mappedFile, this->m_DataOffset, numberOfPixels );
+  output->SetBufferedRegion( output->GetLargestPossibleRegion() );
+  output->SetPixelContainer( pixelContainer );
+}
+
+
+template< typename TImage >
+bool
+MemoryMappedImageFileReader< TImage >
+::GetMappableData( itk::ImageIOBase * imageIO )
+{
+  if( imageIO->GetNumberOfDimensions() != OutputImageType::ImageDimension
+    || imageIO->GetPixelType() != itk::ImageIOBase::SCALAR
+    || imageIO->GetNumberOfComponents() != 1
+    || imageIO->GetComponentType() != itk::ImageIOBase::MapPixelType< PixelType >::CType )
+  {
+    return false;
+  }
+
+  const itk::ImageIOBase::ByteOrder nativeByteOrder = itk::ByteSwapper< int >::SystemIsBigEndian() ? itk::ImageIOBase::BigEndian : itk::ImageIOBase::LittleEndian;
+  if( sizeof( PixelType ) > 1 && imageIO->GetByteOrder() != nativeByteOrder )
+  {
+    return false;
+  }
+
+  this->m_DataFileName = this->m_FileName;
+  this->m_DataOffset   = 0;
+  bool dataAtEndOfFile = false;
+
+  const std::string format = imageIO->GetNameOfClass();
+  bool              mappable;
+  if( format == "MetaImageIO" )
+  {
+    mappable = this->GetMetaImageData( dataAtEndOfFile );
+  }
+  else if( format == "NrrdImageIO" )
+  {
+    mappable = this->GetNrrdData( dataAtEndOfFile );
+  }
+  else if( format == "NiftiImageIO" )
+  {
+    mappable = this->GetNiftiData();
+  }
+  else
+  {
+    mappable = false;
+  }
+
+  if( !mappable || !itksys::SystemTools::FileExists( this->m_DataFileName.c_str(), true ) )
+  {
+    return false;
+  }
+
+  size_t dataSize = sizeof( PixelType );
+  for( unsigned int i = 0; i < OutputImageType::ImageDimension; ++i )
+  {
+    dataSize *= imageIO->GetDimensions( i );
+  }
+
+  const size_t fileSize = static_cast< size_t >( itksys::SystemTools::FileLength( this->m_DataFileName ) );
+  if( dataAtEndOfFile )
+  {
+    if( fileSize < dataSize )
+    {
+      return false;
+    }
+    this->m_DataOffset = fileSize - dataSize;
+  }
+
+  // The mapping starts at a page boundary, the pixels must be aligned for the CPU to read them
+  return dataSize > 0 && fileSize >= this->m_DataOffset + dataSize && this->m_DataOffset % alignof( PixelType ) == 0;
+}
+
+
+template< typename TImage >
+bool
+MemoryMappedImageFileReader< TImage >
+::GetMetaImageData( bool & dataAtEndOfFile )
+{
+  std::ifstream header( this->m_FileName.c_str(), std::ios::in | std::ios::binary );
+  std::string   line, key, value;
+  long          headerSize = 0;
+  while( std::getline( header, line ) )
+  {
+    if( !SplitHeaderLine( line, "=", key, value ) )
+    {
+      continue;
+    }
+
+    if( key == "CompressedData" && itksys::SystemTools::LowerCase( value ) == "true" )
+    {
+      return false;
+    }
+    else if( key == "BinaryData" && itksys::SystemTools::LowerCase( value ) == "false" )
+    {
+      return false;
+    }
+    else if( key == "HeaderSize" )
+    {
+      headerSize = std::atol( value.c_str() );
+    }
+    else if( key == "ElementDataFile" )
+    {
+      // ElementDataFile is the last field of the header
+      if( value == "LOCAL" )
+      {
+        this->m_DataOffset = static_cast< size_t >( header.tellg() );
+        return headerSize == 0;
+      }
+
+      // LIST and file name patterns split the data over multiple files
+      if( value == "LIST" || value.find_first_of( "% " ) != std::string::npos )
+      {
+        return false;
+      }
+
+      this->m_DataFileName = itksys::SystemTools::CollapseFullPath( value, itksys::SystemTools::GetFilenamePath( this->m_FileName ) );
+      if( headerSize < 0 )
+      {
+        dataAtEndOfFile = true;
+      }
+      else
+      {
+        this->m_DataOffset = static_cast< size_t >( headerSize );
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+template< typename TImage >
+bool
+MemoryMappedImageFileReader< TImage >
+::GetNrrdData( bool & dataAtEndOfFile )
+{
+  std::ifstream header( this->m_FileName.c_str(), std::ios::in | std::ios::binary );
+  std::string   line, key, value;
+  if( !std::getline( header, line ) || line.compare( 0, 7, "NRRD000" ) != 0 )
+  {
+    return false;
+  }
+
+  bool   raw        = false;
+  bool   detached   = false;
+  long   byteSkip   = 0;
+  size_t dataOffset = 0;
+  while( std::getline( header, line ) )
+  {
+    // A blank line ends the header, a detached header may also end at the end of the file
+    if( line.empty() || line == "\r" )
+    {
+      dataOffset = static_cast< size_t >( header.tellg() );
+      break;
+    }
+    // Comments and key/value pairs
+    if( line[ 0 ] == '#' || line.find( ":=" ) != std::string::npos || !SplitHeaderLine( line, ":", key, value ) )
+    {
+      continue;
+    }
+
+    if( key == "encoding" )
+    {
+      raw = ( value == "raw" );
+    }
+    else if( key == "line skip" || key == "lineskip" )
+    {
+      if( std::atol( value.c_str() ) != 0 )
+      {
+        return false;
+      }
+    }
+    else if( key == "byte skip" || key == "byteskip" )
+    {
+      byteSkip = std::atol( value.c_str() );
+    }
+    else if( key == "data file" || key == "datafile" )
+    {
+      // LIST and file name patterns split the data over multiple files
+      if( value.compare( 0, 4, "LIST" ) == 0 || value.find( ' ' ) != std::string::npos )
+      {
+        return false;
+      }
+      this->m_DataFileName = itksys::SystemTools::CollapseFullPath( value, itksys::SystemTools::GetFilenamePath( this->m_FileName ) );
+      detached = true;
+    }
+  }
+
+  if( !raw || ( !detached && dataOffset == 0 ) )
+  {
+    return false;
+  }
+
+  if( byteSkip == -1 )
+  {
+    dataAtEndOfFile = true;
+    return true;
+  }
+  if( byteSkip < 0 )
+  {
+    return false;
+  }
+
+  this->m_DataOffset = ( detached ? 0 : dataOffset ) + static_cast< size_t >( byteSkip );
+  return true;
+}
+
+
+template< typename TImage >
+bool
+MemoryMappedImageFileReader< TImage >
+::GetNiftiData( void )
+{
+  // Only single file NIfTI-1, .hdr/.img pairs and gzipped files are left to ImageFileReader
+  std::ifstream file( this->m_FileName.c_str(), std::ios::in | std::ios::binary );
+  char          header[ 352 ];
+  if( !file.read( header, sizeof( header ) ) )
+  {
+    return false;
+  }
+
+  std::int32_t sizeOfHeader;
+  float        voxelOffset, slope, intercept;
+  std::memcpy( &sizeOfHeader, header, sizeof( sizeOfHeader ) );
+  std::memcpy( &voxelOffset, header + 108, sizeof( voxelOffset ) );
+  std::memcpy( &slope, header + 112, sizeof( slope ) );
+  std::memcpy( &intercept, header + 116, sizeof( intercept ) );
+
+  if( sizeOfHeader != 348 || std::memcmp( header + 344, "n+1", 4 ) != 0 || voxelOffset < 352 )
+  {
+    return false;
+  }
+
+  // ImageFileReader rescales the intensities
+  if( slope != 0 && !( slope == 1 && intercept == 0 ) )
+  {
+    return false;
+  }
+
+  this->m_DataOffset = static_cast< size_t >( voxelOffset );
+  return true;
+}
+
+
+template< typename TImage >
+bool
+MemoryMappedImageFileReader< TImage >
+::SplitHeaderLine( const std::string & line, const std::string & separator, std::string & key, std::string & value )
+{
+  const std::string::size_type position = line.find( separator );
+  if( position == std::string::npos )
+  {
+    return false;
+  }
+
+  const char * whitespace = " \t\r";
+  key   = line.substr( 0, position );
+  value = line.substr( position + separator.size() );
+  key.erase( key.find_last_not_of( whitespace ) + 1 );
+  key.erase( 0, key.find_first_not_of( whitespace ) );
+  value.erase( value.find_last_not_of( whitespace ) + 1 );
+  value.erase( 0, value.find_first_not_of( whitespace ) );
+  return true;
+}
+} // namespace selx
+
+#endif // selxMemoryMappedImageFileReader_hxx
@@ -18,6 +18,7 @@
  *=========================================================================*/
 #include "selxAnyFileReader.h"
 #include "selxFileReaderDecorator.h"
+#include "selxMemoryMappedImageFileReader.h"
 
 #include "selxAnyFileWriter.h"
 #include "selxFileWriterDecorator.h"
@@ -27,10 +28,18 @@
 
 #include "itkMeshFileReader.h"
 #include "itkMeshFileWriter.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
 
 #include "selxDataManager.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
 namespace selx
 {
 class AnyFileIOTest : public ::testing::Test
@@ -42,6 +51,7 @@ public:
   typedef itk::ImageFileWriter< Image2DType >      Image2DWriterType;
   typedef FileReaderDecorator< Image2DReaderType > DecoratedImage2DReaderType;
   typedef FileWriterDecorator< Image2DWriterType > DecoratedImage2DWriterType;
+  typedef MemoryMappedImageFileReader< Image2DType > MemoryMappedImage2DReaderType;
 
   typedef itk::Image< double, 3 >                  Image3DType;
   typedef itk::ImageFileReader< Image3DType >      Image3DReaderType;
@@ -56,6 +66,31 @@ public:
   typedef FileWriterDecorator< Mesh2DWriterType > DecoratedMesh2DWriterType;
 
   typedef DataManager DataManagerType;
+
+  /** Reads a file with a MemoryMappedImageFileReader and expects the image that ImageFileReader reads */
+  static void ExpectReadAsByImageFileReader( const std::string & fileName, bool memoryMapped )
+  {
+    SCOPED_TRACE( fileName );
+    Image2DReaderType::Pointer expectedReader = Image2DReaderType::New();
+    expectedReader->SetFileName( fileName );
+    ASSERT_NO_THROW( expectedReader->Update() );
+    Image2DType::Pointer expected = expectedReader->GetOutput();
+
+    MemoryMappedImage2DReaderType::Pointer reader = MemoryMappedImage2DReaderType::New();
+    reader->SetFileName( fileName );
+    ASSERT_NO_THROW( reader->Update() );
+    EXPECT_EQ( reader->GetIsMemoryMapped(), memoryMapped );
+
+    Image2DType::Pointer image = reader->GetOutput();
+    ASSERT_EQ( image->GetBufferedRegion(), expected->GetLargestPossibleRegion() );
+    EXPECT_EQ( image->GetSpacing(), expected->GetSpacing() );
+    EXPECT_EQ( image->GetOrigin(), expected->GetOrigin() );
+    EXPECT_EQ( image->GetDirection(), expected->GetDirection() );
+    const itk::SizeValueType numberOfPixels = expected->GetLargestPossibleRegion().GetNumberOfPixels();
+    EXPECT_TRUE( std::equal( expected->GetBufferPointer(), expected->GetBufferPointer() + numberOfPixels, image->GetBufferPointer() ) );
+  }
+
+
   virtual void SetUp()
   {
   }
@@ -161,4 +196,133 @@ TEST_F( AnyFileIOTest, Writers )
   anyWriter3->SetInput( image3DReader->GetOutput() );
   EXPECT_NO_THROW( anyWriter3->Update() );
 }
+
+TEST_F( AnyFileIOTest, MemoryMappedReader )
+{
+  DataManagerType::Pointer dataManager = DataManagerType::New();
+
+  Image2DReaderType::Pointer image2DReader = Image2DReaderType::New();
+  image2DReader->SetFileName( dataManager->GetInputFile( "coneA2d64.mhd" ) );
+  image2DReader->Update();
+  Image2DType::Pointer image = image2DReader->GetOutput();
+
+  // Write the image with the pixel type of the memory mapped reader, uncompressed in several formats and once compressed
+  const std::string uncompressedFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_uncompressed.mha" );
+  const std::string compressedFileName   = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_compressed.mha" );
+  const std::string detachedFileName     = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_detached.mhd" );
+  const std::string nrrdDetachedFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_detached.nhdr" );
+  const std::string niftiFileName        = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader.nii" );
+  Image2DWriterType::Pointer image2DWriter = Image2DWriterType::New();
+  image2DWriter->SetInput( image );
+  for( const std::string & fileName : { uncompressedFileName, detachedFileName, nrrdDetachedFileName, niftiFileName } )
+  {
+    image2DWriter->SetFileName( fileName );
+    image2DWriter->SetUseCompression( false );
+    EXPECT_NO_THROW( image2DWriter->Update() );
+  }
+  image2DWriter->SetFileName( compressedFileName );
+  image2DWriter->SetUseCompression( true );
+  EXPECT_NO_THROW( image2DWriter->Update() );
+
+  // Attached data is only mapped if the header leaves it aligned for floats
+  std::string metaImage;
+  {
+    std::ifstream file( uncompressedFileName.c_str(), std::ios::in | std::ios::binary );
+    metaImage.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+  }
+  const std::string localElementDataFile = "ElementDataFile = LOCAL\n";
+  ASSERT_NE( metaImage.find( localElementDataFile ), std::string::npos );
+  ExpectReadAsByImageFileReader( uncompressedFileName, ( metaImage.find( localElementDataFile ) + localElementDataFile.size() ) % sizeof( float ) == 0 );
+  ExpectReadAsByImageFileReader( detachedFileName, true );
+  ExpectReadAsByImageFileReader( nrrdDetachedFileName, true );
+  ExpectReadAsByImageFileReader( niftiFileName, true );
+  ExpectReadAsByImageFileReader( compressedFileName, false );
+
+  // NRRD headers with the data attached, and with a detached data file that is skipped up to the data at its end
+  const char * const   byteOrder = itk::ByteSwapper< int >::SystemIsBigEndian() ? "big" : "little";
+  const Image2DType::SizeType size = image->GetLargestPossibleRegion().GetSize();
+  const std::string    data( reinterpret_cast< const char * >( image->GetBufferPointer() ), size[ 0 ] * size[ 1 ] * sizeof( float ) );
+  std::ostringstream   nrrdHeader;
+  nrrdHeader << "NRRD0004\n# Complete NRRD file format specification at:\n# http://teem.sourceforge.net/nrrd/format.html\n"
+             << "type: float\ndimension: 2\nsizes: " << size[ 0 ] << " " << size[ 1 ] << "\nspacings: 0.5 2\nendian: " << byteOrder
+             << "\nencoding: raw\n";
+
+  // The data is aligned for floats after a padded comment line
+  const std::string nrrdAttachedFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_attached.nrrd" );
+  {
+    std::string header = nrrdHeader.str();
+    header += "#" + std::string( ( 4 - ( header.size() + 3 ) % 4 ) % 4, ' ' ) + "\n\n";
+    std::ofstream file( nrrdAttachedFileName.c_str(), std::ios::out | std::ios::binary );
+    file << header << data;
+  }
+  ExpectReadAsByImageFileReader( nrrdAttachedFileName, true );
+
+  const std::string nrrdSkippedFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_skipped.nhdr" );
+  const std::string nrrdSkippedDataFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_skipped.raw" );
+  {
+    std::ofstream header( nrrdSkippedFileName.c_str(), std::ios::out | std::ios::binary );
+    header << nrrdHeader.str() << "byte skip: -1\ndata file: " << itksys::SystemTools::GetFilenameName( nrrdSkippedDataFileName ) << "\n";
+    std::ofstream file( nrrdSkippedDataFileName.c_str(), std::ios::out | std::ios::binary );
+    file << std::string( 16, 'x' ) << data;
+  }
+  ExpectReadAsByImageFileReader( nrrdSkippedFileName, true );
+
+  // NIfTI files with the data further from the header, and with intensity scaling, which ImageFileReader applies
+  std::string nifti;
+  {
+    std::ifstream file( niftiFileName.c_str(), std::ios::in | std::ios::binary );
+    nifti.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+  }
+  ASSERT_GT( nifti.size(), 352 );
+  float voxelOffset;
+  std::memcpy( &voxelOffset, &nifti[ 108 ], sizeof( voxelOffset ) );
+  const size_t dataOffset = static_cast< size_t >( voxelOffset );
+  ASSERT_EQ( nifti.size(), dataOffset + data.size() );
+
+  const std::string niftiOffsetFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_offset.nii" );
+  {
+    std::string shifted = nifti.substr( 0, dataOffset ) + std::string( 16, '\0' ) + nifti.substr( dataOffset );
+    const float shiftedVoxelOffset = voxelOffset + 16;
+    std::memcpy( &shifted[ 108 ], &shiftedVoxelOffset, sizeof( shiftedVoxelOffset ) );
+    shifted[ 348 ] = 0; // no extensions
+    std::ofstream file( niftiOffsetFileName.c_str(), std::ios::out | std::ios::binary );
+    file << shifted;
+  }
+  ExpectReadAsByImageFileReader( niftiOffsetFileName, true );
+
+  const std::string niftiScaledFileName = dataManager->GetOutputFile( "AnyFileIOTest_MemoryMappedReader_scaled.nii" );
+  {
+    std::string scaled = nifti;
+    const float slope = 2, intercept = 1;
+    std::memcpy( &scaled[ 112 ], &slope, sizeof( slope ) );
+    std::memcpy( &scaled[ 116 ], &intercept, sizeof( intercept ) );
+    std::ofstream file( niftiScaledFileName.c_str(), std::ios::out | std::ios::binary );
+    file << scaled;
+  }
+  ExpectReadAsByImageFileReader( niftiScaledFileName, false );
+
+  // A reader of which an empty region is requested does not read the file, whether it is memory mapped or not
+  for( const std::string & fileName : { uncompressedFileName, compressedFileName } )
+  {
+    MemoryMappedImage2DReaderType::Pointer deferredReader = MemoryMappedImage2DReaderType::New();
+    deferredReader->SetFileName( fileName );
+    Image2DType::Pointer deferredImage = deferredReader->GetOutput();
+    deferredImage->UpdateOutputInformation();
+    Image2DType::RegionType emptyRegion = deferredImage->GetLargestPossibleRegion();
+    emptyRegion.SetSize( Image2DType::SizeType{ { 0, 0 } } );
+    deferredImage->SetRequestedRegion( emptyRegion );
+    deferredImage->PropagateRequestedRegion();
+    EXPECT_NO_THROW( deferredImage->UpdateOutputData() );
+    if( !deferredReader->GetIsMemoryMapped() )
+    {
+      EXPECT_EQ( deferredImage->GetBufferedRegion().GetNumberOfPixels(), 0 );
+    }
+
+    // The region that is requested next is read
+    deferredImage->SetRequestedRegionToLargestPossibleRegion();
+    deferredImage->PropagateRequestedRegion();
+    EXPECT_NO_THROW( deferredImage->UpdateOutputData() );
+    EXPECT_EQ( deferredImage->GetBufferedRegion(), deferredImage->GetLargestPossibleRegion() );
+  }
+}
 }
@@ -25,6 +25,9 @@ set( ${MODULE}_INCLUDE_DIRS
 set( ${MODULE}_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/src/selxSuperElastixFilterBase.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxSuperElastixFilter.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxNetworkBuilderCache.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxSuperElastixBatch.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxMiniPipelineInputFilter.cxx
 )
 
 # Export tests
@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxMiniPipelineInputFilter_h
+#define selxMiniPipelineInputFilter_h
+
+#include "itkProcessObject.h"
+
+namespace selx
+{
+/** \class MiniPipelineInputFilter
+ * \brief Passes an input of the SuperElastixFilter to a Source Component through a data object that the filter owns
+ *
+ * The output is created at the first input, of the same type, and keeps its identity when the input is replaced: the
+ * components downstream of the Source stay connected to it, while the data objects of the caller are never written to.
+ * Regions requested of the output are requested of the input, such that consumers still read only what they need.
+ */
+class MiniPipelineInputFilter : public itk::ProcessObject
+{
+public:
+
+  /** Standard ITK typedefs. */
+  typedef MiniPipelineInputFilter         Self;
+  typedef itk::ProcessObject              Superclass;
+  typedef itk::SmartPointer< Self >       Pointer;
+  typedef itk::SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( MiniPipelineInputFilter, ProcessObject );
+
+  typedef itk::DataObject DataObject;
+
+  /** Inputs after the first must be of the type of the first input. */
+  void SetInput( DataObject * input );
+
+  DataObject * GetInput( void );
+
+  DataObject * GetOutput( void );
+
+  /** Makes an output of the type of the input, whichever image or mesh type the Source Component takes */
+  using Superclass::MakeOutput;
+  virtual DataObjectPointer MakeOutput( DataObjectPointerArraySizeType idx ) ITK_OVERRIDE;
+
+protected:
+
+  MiniPipelineInputFilter( void );
+  ~MiniPipelineInputFilter() {}
+
+  /** Requests the region that is requested of the output, instead of the largest possible region */
+  virtual void GenerateInputRequestedRegion( void ) ITK_OVERRIDE;
+
+  /** Grafts the input onto the output, without copying its data */
+  virtual void GenerateData( void ) ITK_OVERRIDE;
+
+private:
+
+  MiniPipelineInputFilter( const Self & ); // purposely not implemented
+  void operator=( const Self & );          // purposely not implemented
+};
+} // namespace selx
+
+#endif // selxMiniPipelineInputFilter_h
@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxNetworkBuilderCache_h
+#define selxNetworkBuilderCache_h
+
+#include "selxLogger.h"
+#include "selxMiniPipelineInputFilter.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <typeindex>
+
+namespace selx
+{
+// Forward declaration, hiding implementation details and speeding up compilation time (PIMPL idiom)
+class BlueprintImpl;
+class NetworkBuilderBase;
+
+/** \class NetworkBuilderCache
+ * \brief Process wide pool of configured and connected networks that are not in use by any SuperElastixFilter
+ *
+ * A SuperElastixFilter that gets a blueprint identical to that of a previous filter takes over the network of that filter
+ * instead of selecting and connecting components again. Only the data of its Sources is replaced. A network is
+ * identified by the type of NetworkBuilderFactory (i.e. the ComponentList), the Logger the components log to, and the
+ * canonical description of the blueprint. Each entry owns its copy of the blueprint, since the NetworkBuilder refers to it.
+ */
+class NetworkBuilderCache
+{
+public:
+
+  typedef std::tuple< std::type_index, const Logger *, std::string > KeyType;
+
+  struct Entry
+  {
+    Entry();
+    Entry( Entry && );
+    Entry & operator=( Entry && );
+    ~Entry();
+
+    Logger::Pointer                       logger;
+    std::unique_ptr< BlueprintImpl >      blueprint;
+    std::unique_ptr< NetworkBuilderBase > networkBuilder;
+    // The filters that pass the inputs to the Source Components, through the data objects the components are connected with
+    std::map< std::string, MiniPipelineInputFilter::Pointer > miniPipelineInputs;
+  };
+
+  static NetworkBuilderCache & GetInstance();
+
+  /** Take a network out of the cache. Returns false if no network with this key is cached. */
+  bool Acquire( const KeyType & key, Entry & entry );
+
+  /** Put a network that is no longer in use into the cache. If the cache is full, the least recently released network is discarded. */
+  void Release( const KeyType & key, Entry && entry );
+
+  /** The maximum number of cached networks. Cached networks keep their components, and with that their data, in memory. */
+  void SetMaximumSize( std::size_t maximumSize );
+  std::size_t GetMaximumSize() const;
+
+  std::size_t Size() const;
+
+  void Clear();
+
+private:
+
+  NetworkBuilderCache();
+
+  typedef std::list< std::pair< KeyType, Entry >> EntryContainerType;
+
+  EntryContainerType m_Entries;  // most recently released first
+  std::size_t        m_MaximumSize;
+  mutable std::mutex m_Mutex;
+};
+} // end namespace selx
+
+#endif // selxNetworkBuilderCache_h
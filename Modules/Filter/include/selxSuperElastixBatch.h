@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxSuperElastixBatch_h
+#define selxSuperElastixBatch_h
+
+#include "selxSuperElastixFilterBase.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace selx
+{
+/** \class SuperElastixBatch
+ * \brief Executes one blueprint over a sequence of input sets, e.g. many image pairs
+ *
+ * Each worker creates one SuperElastixFilter, which parses the blueprint, selects and connects its components only once.
+ * Between items a worker only replaces the data of the Sources and re-executes its network. Workers run concurrently,
+ * each executing its network with NumberOfThreadsPerItem threads and an equal share of the ThreadBudget.
+ */
+class SuperElastixBatch
+{
+public:
+
+  typedef std::function< SuperElastixFilterBase::Pointer( void ) > FilterFactoryType;
+
+  /** Source or Sink component name -> file name */
+  typedef std::map< std::string, std::string > FileNameMapType;
+
+  struct ItemType
+  {
+    FileNameMapType inputs;
+    FileNameMapType outputs;
+  };
+
+  typedef std::vector< ItemType > ItemContainerType;
+
+  /** One error message per item, empty if the item succeeded */
+  typedef std::vector< std::string > ErrorContainerType;
+
+  SuperElastixBatch( FilterFactoryType filterFactory, Blueprint::Pointer blueprint, Logger::Pointer logger );
+
+  /** The number of items that are executed concurrently. Default 1. */
+  void SetNumberOfWorkers( unsigned int numberOfWorkers );
+  unsigned int GetNumberOfWorkers() const;
+
+  /** The NumberOfExecutionThreads of the network of each worker. Default 1. */
+  void SetNumberOfThreadsPerItem( unsigned int numberOfThreads );
+  unsigned int GetNumberOfThreadsPerItem() const;
+
+  /** The total number of threads of all workers. Each worker gets an equal share (at least 1) as the ThreadBudget of its
+   * filter. Default 0: no budget. */
+  void SetThreadBudget( unsigned int threadBudget );
+  unsigned int GetThreadBudget() const;
+
+  /** The maximum wall time in seconds of each item, after which its execution is cancelled and the worker continues with the
+   * next item. Default 0: no limit. */
+  void SetItemTimeout( double seconds );
+  double GetItemTimeout() const;
+
+  /** Executes all items. A failing item is logged and does not stop the remaining items. */
+  ErrorContainerType Execute( const ItemContainerType & items );
+
+  /** Reads a manifest with a header of "in:<name>" and "out:<name>" columns and one item per subsequent line. */
+  static ItemContainerType ReadManifest( const std::string & fileName );
+
+private:
+
+  /** A filter with the blueprint of the batch, of which the network is configured */
+  SuperElastixFilterBase::Pointer CreateFilter();
+
+  void ExecuteItem( SuperElastixFilterBase & filter, const ItemType & item );
+
+  FilterFactoryType  m_FilterFactory;
+  Blueprint::Pointer m_Blueprint;
+  Logger::Pointer    m_Logger;
+
+  unsigned int m_NumberOfWorkers;
+  unsigned int m_NumberOfThreadsPerItem;
+  unsigned int m_ThreadBudget;
+  double       m_ItemTimeout;
+};
+} // end namespace selx
+
+#endif // selxSuperElastixBatch_h
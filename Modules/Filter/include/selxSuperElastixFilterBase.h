@@ -25,6 +25,9 @@
 
 #include "selxAnyFileReader.h"
 #include "selxAnyFileWriter.h"
+#include "selxNetworkBuilderCache.h"
+#include "selxMiniPipelineInputFilter.h"
+#include "selxCancellationToken.h"
 
 /**
  * \class SuperElastixFilterBase
@@ -36,6 +39,10 @@ namespace selx
 // Forward declaration, hiding implementation details and speeding up compilation time (PIMPL idiom)
 class NetworkBuilderBase;
 class NetworkBuilderFactoryBase;
+class BlueprintImpl;
+class Profiler;
+class ProgressMonitor;
+class CompiledNetwork;
 
 class SuperElastixFilterBase : public itk::ProcessObject
 {
@@ -69,6 +76,65 @@ public:
   itkSetObjectMacro( Logger, Logger );
   itkGetObjectMacro( Logger, Logger );
 
+  /** The maximum number of components that are executed concurrently. Components in independent branches of the
+   * blueprint, e.g. multiple registration methods on the same images, can then run in parallel. Default 1: serial execution. */
+  itkSetMacro( NumberOfExecutionThreads, unsigned int );
+  itkGetConstMacro( NumberOfExecutionThreads, unsigned int );
+
+  /** The total number of threads of the components that are executed concurrently, divided among them by the network, such
+   * that itk, elastix and NiftyReg components do not oversubscribe the cores. Default 0: each component uses the default
+   * parallelism of its toolkit. */
+  itkSetMacro( ThreadBudget, unsigned int );
+  itkGetConstMacro( ThreadBudget, unsigned int );
+
+  /** Take over the configured and connected network of a previous SuperElastixFilter with an identical blueprint and logger,
+   * and leave the network in the NetworkBuilderCache when this filter is destroyed or gets another blueprint. Default off,
+   * since cached networks keep their components in memory. */
+  itkSetMacro( UseNetworkBuilderCache, bool );
+  itkGetConstMacro( UseNetworkBuilderCache, bool );
+  itkBooleanMacro( UseNetworkBuilderCache );
+
+  /** Free the data of components, e.g. NIfTI copies and registration fields, as soon as the components that use it are updated.
+   * Default on; switch off to keep all intermediate data until the filter is destroyed, e.g. for debugging. */
+  itkSetMacro( ReleaseIntermediateData, bool );
+  itkGetConstMacro( ReleaseIntermediateData, bool );
+  itkBooleanMacro( ReleaseIntermediateData );
+
+  /** Re-execute only what changed when the filter is updated again: if only parameters of components in the blueprint are modified,
+   * only those components and the components downstream are selected, connected and updated anew, while the components upstream
+   * keep their results. The results of components that release their data (see ReleaseIntermediateData) and of all components when
+   * an input is modified are computed again. Does not apply with the NetworkBuilderCache, where a modified blueprint gets its
+   * own network. Default on. */
+  itkSetMacro( IncrementalExecution, bool );
+  itkGetConstMacro( IncrementalExecution, bool );
+  itkBooleanMacro( IncrementalExecution );
+
+  /** Record the wall time, CPU time and peak memory growth of the phases of Update and of each component with the profiler.
+   * The profiler is not owned by the filter and must outlive its updates. Default nullptr: no profiling. */
+  void SetProfiler( Profiler * profiler );
+  Profiler * GetProfiler( void ) const { return this->m_Profiler; }
+
+  /** Publish the progress and convergence of the components, e.g. the metric value per iteration, to the monitor.
+   * The monitor is not owned by the filter and must outlive its updates. Default nullptr: no progress events. */
+  void SetProgressMonitor( ProgressMonitor * progressMonitor ) { this->m_ProgressMonitor = progressMonitor; }
+  ProgressMonitor * GetProgressMonitor( void ) const { return this->m_ProgressMonitor; }
+
+  /** Stop the execution of the network when the token is cancelled or its deadline has passed, e.g. by
+   * token->SetTimeout( seconds ). Registration components that support it stop their optimization at the next iteration.
+   * Update then throws ExecutionCancelledException; the outputs of which all components finished before are still grafted.
+   * Default nullptr: the execution cannot be cancelled. */
+  void SetCancellationToken( CancellationToken::Pointer cancellationToken ) { this->m_CancellationToken = cancellationToken; }
+  CancellationToken::Pointer GetCancellationToken( void ) const { return this->m_CancellationToken; }
+
+  /** Configure the network by the components that a previous configuration of the same blueprint selected, as read by
+   * CompiledNetwork::Read, instead of selecting them by the criteria of the blueprint. Default nullptr: select the components. */
+  void SetCompiledNetwork( std::shared_ptr< const CompiledNetwork > compiledNetwork );
+  std::shared_ptr< const CompiledNetwork > GetCompiledNetwork( void ) const { return this->m_CompiledNetwork; }
+
+  /** Configure the network of the blueprint and write the selected components, together with the blueprint, to a compiled
+   * network file, e.g. out.selxnet. Throws if the components cannot be uniquely selected. */
+  void CompileBlueprint( const std::string & fileName );
+
   // Adding a BlueprintImpl composes SuperElastixFilter' internal blueprint (accessible by Set/Get BlueprintImpl) with the otherBlueprint.
   // void AddBlueprint(BlueprintPointer otherBlueprint);
 
@@ -118,8 +184,22 @@ protected:
   // default constructor initialized with an empty NetworkBuilder
   SuperElastixFilterBase( void );
 
+  ~SuperElastixFilterBase();
+
+  /** Leave the network in the NetworkBuilderCache if it may be reused */
+  void ReleaseNetworkBuilder( void );
+
+  /** Give the mini pipeline outputs of the Sinks new buffers, such that re-executing the network does not overwrite
+   * outputs that were grafted from them before and may still be in use. */
+  void ReleaseMiniPipelineOutputs( void );
+
   virtual void GenerateOutputInformation( void ) ITK_OVERRIDE;
 
+  /** Does not request the largest possible region of the inputs, as the ProcessObject does: the components that consume
+   * the inputs request the regions they need when the network executes. With more than one execution thread the inputs
+   * are read entirely, since the ITK pipeline of an input cannot be updated by its consumers concurrently. */
+  virtual void GenerateInputRequestedRegion( void ) ITK_OVERRIDE;
+
   virtual void GenerateData( void ) ITK_OVERRIDE;
 
   std::unique_ptr< NetworkBuilderFactoryBase > m_NetworkBuilderFactory;
@@ -129,9 +209,37 @@ protected:
 private:
 
   BlueprintPointer m_Blueprint;
+  // The blueprint the NetworkBuilder was built from, kept alive since the NetworkBuilder may refer to it
+  BlueprintConstPointer m_NetworkBuilderBlueprint;
 
   bool m_IsConnected;
   bool m_AllUniqueComponents;
+
+  unsigned int m_NumberOfExecutionThreads;
+  unsigned int m_ThreadBudget;
+  bool         m_ReleaseIntermediateData;
+  bool         m_IncrementalExecution;
+  Profiler *   m_Profiler;
+
+  // Whether an input was replaced or modified since the network was executed, such that none of its results can be reused
+  bool           m_InputsModified;
+  itk::TimeStamp m_ExecutionTime;
+
+  ProgressMonitor * m_ProgressMonitor;
+
+  CancellationToken::Pointer m_CancellationToken;
+
+  std::shared_ptr< const CompiledNetwork > m_CompiledNetwork;
+
+  bool m_UseNetworkBuilderCache;
+  // With the cache, the NetworkBuilder refers to a copy of the blueprint that is cached along with it.
+  std::unique_ptr< BlueprintImpl >                     m_NetworkBlueprint;
+  std::unique_ptr< NetworkBuilderCache::KeyType > m_NetworkBuilderCacheKey;
+
+  // Pass the inputs to the Source Components through data objects of this filter. The components downstream hold on to
+  // these, so re-executing the network with other inputs passes the new data through them instead of connecting the
+  // components again.
+  std::map< DataObjectIdentifierType, MiniPipelineInputFilter::Pointer > m_MiniPipelineInputs;
 };
 } // namespace elx
 
@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxMiniPipelineInputFilter.h"
+
+namespace selx
+{
+MiniPipelineInputFilter
+::MiniPipelineInputFilter()
+{
+  this->SetNumberOfRequiredInputs( 1 );
+  this->SetNumberOfRequiredOutputs( 1 );
+}
+
+
+void
+MiniPipelineInputFilter
+::SetInput( DataObject * input )
+{
+  if( input == nullptr )
+  {
+    itkExceptionMacro( << "The input of a Source Component cannot be null." );
+  }
+
+  this->SetNthInput( 0, input );
+  if( this->GetOutput() == nullptr )
+  {
+    this->SetNthOutput( 0, this->MakeOutput( 0 ) );
+  }
+}
+
+
+MiniPipelineInputFilter::DataObject *
+MiniPipelineInputFilter
+::GetInput()
+{
+  return this->Superclass::GetInput( 0 );
+}
+
+
+MiniPipelineInputFilter::DataObject *
+MiniPipelineInputFilter
+::GetOutput()
+{
+  return this->Superclass::GetOutput( 0 );
+}
+
+
+MiniPipelineInputFilter::DataObjectPointer
+MiniPipelineInputFilter
+::MakeOutput( DataObjectPointerArraySizeType itkNotUsed( idx ) )
+{
+  return dynamic_cast< DataObject * >( this->GetInput()->CreateAnother().GetPointer() );
+}
+
+
+void
+MiniPipelineInputFilter
+::GenerateInputRequestedRegion()
+{
+  this->GetInput()->SetRequestedRegion( this->GetOutput() );
+}
+
+
+void
+MiniPipelineInputFilter
+::GenerateData()
+{
+  this->GetOutput()->Graft( this->GetInput() );
+}
+} // namespace selx
@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxNetworkBuilderCache.h"
+#include "selxNetworkBuilderBase.h"
+#include "selxBlueprintImpl.h"
+
+namespace selx
+{
+NetworkBuilderCache::Entry::Entry() = default;
+NetworkBuilderCache::Entry::Entry( Entry && ) = default;
+NetworkBuilderCache::Entry & NetworkBuilderCache::Entry::operator=( Entry && ) = default;
+NetworkBuilderCache::Entry::~Entry() = default;
+
+NetworkBuilderCache::NetworkBuilderCache() : m_MaximumSize( 16 )
+{
+}
+
+
+NetworkBuilderCache &
+NetworkBuilderCache::GetInstance()
+{
+  static NetworkBuilderCache instance;
+  return instance;
+}
+
+
+bool
+NetworkBuilderCache::Acquire( const KeyType & key, Entry & entry )
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  for( auto it = this->m_Entries.begin(); it != this->m_Entries.end(); ++it )
+  {
+    if( it->first == key )
+    {
+      entry = std::move( it->second );
+      this->m_Entries.erase( it );
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void
+NetworkBuilderCache::Release( const KeyType & key, Entry && entry )
+{
+  // Discarded entries are destroyed outside of the lock
+  EntryContainerType discarded;
+  {
+    std::lock_guard< std::mutex > lock( this->m_Mutex );
+    this->m_Entries.emplace_front( key, std::move( entry ) );
+    while( this->m_Entries.size() > this->m_MaximumSize )
+    {
+      discarded.splice( discarded.end(), this->m_Entries, std::prev( this->m_Entries.end() ) );
+    }
+  }
+}
+
+
+void
+NetworkBuilderCache::SetMaximumSize( std::size_t maximumSize )
+{
+  EntryContainerType discarded;
+  {
+    std::lock_guard< std::mutex > lock( this->m_Mutex );
+    this->m_MaximumSize = maximumSize;
+    while( this->m_Entries.size() > this->m_MaximumSize )
+    {
+      discarded.splice( discarded.end(), this->m_Entries, std::prev( this->m_Entries.end() ) );
+    }
+  }
+}
+
+
+std::size_t
+NetworkBuilderCache::GetMaximumSize() const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  return this->m_MaximumSize;
+}
+
+
+std::size_t
+NetworkBuilderCache::Size() const
+{
+  std::lock_guard< std::mutex > lock( this->m_Mutex );
+  return this->m_Entries.size();
+}
+
+
+void
+NetworkBuilderCache::Clear()
+{
+  EntryContainerType discarded;
+  {
+    std::lock_guard< std::mutex > lock( this->m_Mutex );
+    discarded.swap( this->m_Entries );
+  }
+}
+} // end namespace selx
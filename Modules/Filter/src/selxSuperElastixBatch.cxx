@@ -0,0 +1,299 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxSuperElastixBatch.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace selx
+{
+SuperElastixBatch::SuperElastixBatch( FilterFactoryType filterFactory, Blueprint::Pointer blueprint, Logger::Pointer logger ) :
+  m_FilterFactory( filterFactory ),
+  m_Blueprint( blueprint ),
+  m_Logger( logger ),
+  m_NumberOfWorkers( 1 ),
+  m_NumberOfThreadsPerItem( 1 ),
+  m_ThreadBudget( 0 ),
+  m_ItemTimeout( 0.0 )
+{
+}
+
+
+void
+SuperElastixBatch::SetNumberOfWorkers( unsigned int numberOfWorkers )
+{
+  this->m_NumberOfWorkers = std::max( numberOfWorkers, 1u );
+}
+
+
+unsigned int
+SuperElastixBatch::GetNumberOfWorkers() const
+{
+  return this->m_NumberOfWorkers;
+}
+
+
+void
+SuperElastixBatch::SetNumberOfThreadsPerItem( unsigned int numberOfThreads )
+{
+  this->m_NumberOfThreadsPerItem = std::max( numberOfThreads, 1u );
+}
+
+
+unsigned int
+SuperElastixBatch::GetNumberOfThreadsPerItem() const
+{
+  return this->m_NumberOfThreadsPerItem;
+}
+
+
+void
+SuperElastixBatch::SetThreadBudget( unsigned int threadBudget )
+{
+  this->m_ThreadBudget = threadBudget;
+}
+
+
+unsigned int
+SuperElastixBatch::GetThreadBudget() const
+{
+  return this->m_ThreadBudget;
+}
+
+
+void
+SuperElastixBatch::SetItemTimeout( double seconds )
+{
+  this->m_ItemTimeout = std::max( seconds, 0.0 );
+}
+
+
+double
+SuperElastixBatch::GetItemTimeout() const
+{
+  return this->m_ItemTimeout;
+}
+
+
+SuperElastixBatch::ErrorContainerType
+SuperElastixBatch::Execute( const ItemContainerType & items )
+{
+  ErrorContainerType errors( items.size() );
+  if( items.empty() )
+  {
+    return errors;
+  }
+
+  // Configure the network of each worker up front, in this thread. The workers only execute.
+  const std::size_t numberOfWorkers = std::min< std::size_t >( this->m_NumberOfWorkers, items.size() );
+  std::vector< SuperElastixFilterBase::Pointer > filters;
+  for( std::size_t workerIndex = 0; workerIndex < numberOfWorkers; ++workerIndex )
+  {
+    filters.push_back( this->CreateFilter() );
+  }
+  std::mutex createFilterMutex;
+
+  const std::string executing = "Batch: executing " + std::to_string( items.size() ) + " item(s) with " + std::to_string( numberOfWorkers ) + " worker(s) ...";
+  this->m_Logger->Log( LogLevel::INF, executing );
+
+  std::atomic< std::size_t > nextItem( 0 );
+  auto worker = [ & ]( SuperElastixFilterBase::Pointer & filter ) {
+    for( std::size_t itemIndex = nextItem++; itemIndex < items.size(); itemIndex = nextItem++ )
+    {
+      try
+      {
+        this->ExecuteItem( *filter, items[ itemIndex ] );
+        this->m_Logger->Log( LogLevel::INF, "Batch: item " + std::to_string( itemIndex ) + " ... Done" );
+      }
+      catch( ExecutionCancelledException & e )
+      {
+        errors[ itemIndex ] = e.what();
+        this->m_Logger->Log( LogLevel::ERR, "Batch: item " + std::to_string( itemIndex ) + " ... Cancelled: " + e.what() );
+        // A component may have been interrupted halfway its update, so the worker continues with a freshly configured network
+        try
+        {
+          std::lock_guard< std::mutex > lock( createFilterMutex );
+          filter = this->CreateFilter();
+        }
+        catch( std::exception & createError )
+        {
+          this->m_Logger->Log( LogLevel::CRT, std::string( "Batch: worker stopped: " ) + createError.what() );
+          return;
+        }
+      }
+      catch( std::exception & e )
+      {
+        errors[ itemIndex ] = e.what();
+        this->m_Logger->Log( LogLevel::ERR, "Batch: item " + std::to_string( itemIndex ) + " ... Error: " + e.what() );
+      }
+      catch( ... )
+      {
+        errors[ itemIndex ] = "Exception of unknown type!";
+        this->m_Logger->Log( LogLevel::ERR, "Batch: item " + std::to_string( itemIndex ) + " ... Error: Exception of unknown type!" );
+      }
+    }
+  };
+
+  // The calling thread is one of the workers
+  std::vector< std::thread > threads;
+  for( std::size_t workerIndex = 1; workerIndex < numberOfWorkers; ++workerIndex )
+  {
+    threads.emplace_back( worker, std::ref( filters[ workerIndex ] ) );
+  }
+  worker( filters[ 0 ] );
+  for( auto & thread : threads )
+  {
+    thread.join();
+  }
+
+  const auto numberOfFailures = std::count_if( errors.begin(), errors.end(), []( const std::string & error ) { return !error.empty(); } );
+  this->m_Logger->Log( LogLevel::INF, executing + " Done, " + std::to_string( numberOfFailures ) + " failed" );
+  return errors;
+}
+
+
+SuperElastixFilterBase::Pointer
+SuperElastixBatch::CreateFilter()
+{
+  SuperElastixFilterBase::Pointer filter = this->m_FilterFactory();
+  filter->SetLogger( this->m_Logger );
+  filter->SetNumberOfExecutionThreads( this->m_NumberOfThreadsPerItem );
+  if( this->m_ThreadBudget > 0 )
+  {
+    filter->SetThreadBudget( std::max( this->m_ThreadBudget / this->m_NumberOfWorkers, 1u ) );
+  }
+  filter->SetBlueprint( this->m_Blueprint );
+  if( !filter->ParseBlueprint() )
+  {
+    this->m_Logger->Log( LogLevel::CRT, "Batch: blueprint was not sufficiently specified to build a network." );
+    throw std::runtime_error( "Blueprint was not sufficiently specified to build a network." );
+  }
+  return filter;
+}
+
+
+void
+SuperElastixBatch::ExecuteItem( SuperElastixFilterBase & filter, const ItemType & item )
+{
+  // The readers and writers of the previous item are replaced. The network of the filter stays configured and connected.
+  std::vector< AnyFileReader::Pointer > fileReaders;
+  for( const auto & nameAndFileName : item.inputs )
+  {
+    AnyFileReader::Pointer reader = filter.GetInputFileReader( nameAndFileName.first );
+    reader->SetFileName( nameAndFileName.second );
+    filter.SetInput( nameAndFileName.first, reader->GetOutput() );
+    fileReaders.push_back( reader );
+  }
+
+  std::vector< AnyFileWriter::Pointer > fileWriters;
+  for( const auto & nameAndFileName : item.outputs )
+  {
+    AnyFileWriter::Pointer writer = filter.GetOutputFileWriter( nameAndFileName.first );
+    writer->SetFileName( nameAndFileName.second );
+    writer->SetInput( filter.GetOutput( nameAndFileName.first ) );
+    fileWriters.push_back( writer );
+  }
+
+  // The deadline of each item starts when its execution starts
+  if( this->m_ItemTimeout > 0.0 )
+  {
+    auto cancellationToken = std::make_shared< CancellationToken >();
+    cancellationToken->SetTimeout( this->m_ItemTimeout );
+    filter.SetCancellationToken( cancellationToken );
+  }
+
+  for( auto & writer : fileWriters )
+  {
+    writer->Update();
+  }
+}
+
+
+SuperElastixBatch::ItemContainerType
+SuperElastixBatch::ReadManifest( const std::string & fileName )
+{
+  std::ifstream manifest( fileName );
+  if( !manifest )
+  {
+    throw std::runtime_error( "Cannot open batch manifest " + fileName );
+  }
+
+  typedef std::vector< std::string > VectorOfStringsType;
+
+  // Each column is either an input ("in:<name>") or an output ("out:<name>") of the network
+  std::vector< std::pair< bool, std::string > > columns;
+  ItemContainerType                             items;
+  std::string                                   line;
+  for( std::size_t lineNumber = 1; std::getline( manifest, line ); ++lineNumber )
+  {
+    boost::trim( line );
+    if( line.empty() )
+    {
+      continue;
+    }
+    VectorOfStringsType cells;
+    boost::split( cells, line, boost::is_any_of( "," ) );
+    for( auto & cell : cells )
+    {
+      boost::trim( cell );
+    }
+
+    if( columns.empty() )
+    {
+      for( const auto & cell : cells )
+      {
+        if( boost::starts_with( cell, "in:" ) && cell.size() > 3 )
+        {
+          columns.emplace_back( true, cell.substr( 3 ) );
+        }
+        else if( boost::starts_with( cell, "out:" ) && cell.size() > 4 )
+        {
+          columns.emplace_back( false, cell.substr( 4 ) );
+        }
+        else
+        {
+          throw std::runtime_error( fileName + ":" + std::to_string( lineNumber ) + ": header column '" + cell + "' is not of the form in:<name> or out:<name>" );
+        }
+      }
+      continue;
+    }
+
+    if( cells.size() != columns.size() )
+    {
+      throw std::runtime_error( fileName + ":" + std::to_string( lineNumber ) + ": expected " + std::to_string( columns.size() )
+        + " columns, found " + std::to_string( cells.size() ) );
+    }
+    ItemType item;
+    for( std::size_t columnIndex = 0; columnIndex < columns.size(); ++columnIndex )
+    {
+      auto & fileNames = columns[ columnIndex ].first ? item.inputs : item.outputs;
+      fileNames[ columns[ columnIndex ].second ] = cells[ columnIndex ];
+    }
+    items.push_back( item );
+  }
+  return items;
+}
+} // end namespace selx
@@ -20,6 +20,7 @@
 #include "selxSuperElastixFilterBase.h"
 #include "selxNetworkBuilder.h"
 #include "selxNetworkBuilderFactory.h"
+#include "selxCompiledNetwork.h"
 
 namespace selx
 {
@@ -30,32 +31,185 @@ namespace selx
 SuperElastixFilterBase
 ::SuperElastixFilterBase() :
   m_IsConnected( false ),
-  m_AllUniqueComponents( false )
+  m_AllUniqueComponents( false ),
+  m_NumberOfExecutionThreads( 1 ),
+  m_ThreadBudget( 0 ),
+  m_ReleaseIntermediateData( true ),
+  m_IncrementalExecution( true ),
+  m_Profiler( nullptr ),
+  m_InputsModified( false ),
+  m_ProgressMonitor( nullptr ),
+  m_UseNetworkBuilderCache( false )
 {
   this->m_Blueprint = nullptr;
 
-  // Create default logger which redirects to std::cout
+  // Create default logger without streams. Loggers are independent, so each filter can be given its own streams,
+  // level and context.
   this->m_Logger = Logger::New();
-  //TODO: cannot have independent loggers redirecting to cout. 
-  //this->m_Logger->AddStream("cout", std::cout);
-  //TODO: this seems to affect other instantiated loggers too.
-  //this->m_Logger->SetLogLevel(selx::LogLevel::INF);
 
 } // end Constructor
 
+SuperElastixFilterBase
+::~SuperElastixFilterBase()
+{
+  this->ReleaseNetworkBuilder();
+}
+
+
 bool
 SuperElastixFilterBase
 ::ParseBlueprint()
 {
-  if( ( this->m_Blueprint->GetMTime() > this->GetMTime() || !this->m_NetworkBuilder ) )
+  if( ( this->m_Blueprint->GetMTime() > this->GetMTime() || !this->m_NetworkBuilder
+    || this->m_NetworkBuilderBlueprint.GetPointer() != this->m_Blueprint.GetPointer() ) )
   {
-    m_NetworkBuilder = m_NetworkBuilderFactory->New( this->m_Logger->GetLoggerImpl(), this->m_Blueprint->GetBlueprintImpl() );
-    this->m_AllUniqueComponents = this->m_NetworkBuilder->Configure();
+    // The NetworkBuilder refers to the blueprint it was built from. If that is still the blueprint of this filter, it may
+    // have modified parameters only. A replaced blueprint is built anew.
+    if( this->m_IncrementalExecution && !this->m_UseNetworkBuilderCache && this->m_NetworkBuilder && this->m_AllUniqueComponents
+      && this->m_NetworkBuilderBlueprint.GetPointer() == this->m_Blueprint.GetPointer() )
+    {
+      // A network that fails to reconfigure is not reused
+      this->m_AllUniqueComponents = false;
+      NetworkBuilderBase::ComponentNamesType reconfiguredComponentNames;
+      if( this->m_NetworkBuilder->Reconfigure( reconfiguredComponentNames ) )
+      {
+        // Reconfigured Sources are connected to their inputs again
+        for( const auto & componentName : reconfiguredComponentNames )
+        {
+          this->m_MiniPipelineInputs.erase( componentName );
+        }
+        this->m_AllUniqueComponents = true;
+        return this->m_AllUniqueComponents;
+      }
+      this->m_Logger->Log( LogLevel::INF, "The network cannot be reconfigured, building it anew." );
+    }
+
+    this->ReleaseNetworkBuilder();
+
+    if( this->m_Blueprint->HasSweeps() )
+    {
+      itkExceptionMacro( << "The blueprint declares a parameter sweep, which must be expanded by Blueprint::ExpandSweeps() first" )
+    }
+
+    if( !this->m_UseNetworkBuilderCache )
+    {
+      m_NetworkBuilder = m_NetworkBuilderFactory->New( this->m_Logger->GetLoggerImpl(), this->m_Blueprint->GetBlueprintImpl() );
+      this->m_NetworkBuilderBlueprint = this->m_Blueprint.GetPointer();
+      this->m_NetworkBuilder->SetProfiler( this->m_Profiler );
+      this->m_AllUniqueComponents = this->m_CompiledNetwork ? this->m_NetworkBuilder->ConfigureFrom( *this->m_CompiledNetwork ) : this->m_NetworkBuilder->Configure();
+      return this->m_AllUniqueComponents;
+    }
+
+    this->m_NetworkBuilderCacheKey.reset( new NetworkBuilderCache::KeyType( typeid( *this->m_NetworkBuilderFactory ),
+      this->m_Logger.GetPointer(), this->m_Blueprint->GetBlueprintImpl().GetCanonicalDescription() ) );
+
+    NetworkBuilderCache::Entry entry;
+    if( NetworkBuilderCache::GetInstance().Acquire( *this->m_NetworkBuilderCacheKey, entry ) )
+    {
+      this->m_Logger->Log( LogLevel::INF, "Reusing the network of a previous SuperElastixFilter with an identical blueprint." );
+      this->m_NetworkBlueprint = std::move( entry.blueprint );
+      this->m_NetworkBuilder   = std::move( entry.networkBuilder );
+      this->m_NetworkBuilderBlueprint = this->m_Blueprint.GetPointer();
+      this->m_MiniPipelineInputs = std::move( entry.miniPipelineInputs );
+      this->m_NetworkBuilder->SetProfiler( this->m_Profiler );
+
+      // The outputs of the previous filter are grafted from the mini pipeline outputs of the sinks and may still be in use.
+      this->ReleaseMiniPipelineOutputs();
+      this->m_AllUniqueComponents = true;
+      return this->m_AllUniqueComponents;
+    }
+
+    this->m_NetworkBlueprint.reset( new BlueprintImpl( this->m_Blueprint->GetBlueprintImpl() ) );
+    this->m_NetworkBlueprint->SetLoggerImpl( this->m_Logger->GetLoggerImpl() );
+    m_NetworkBuilder = m_NetworkBuilderFactory->New( this->m_Logger->GetLoggerImpl(), *this->m_NetworkBlueprint );
+    this->m_NetworkBuilderBlueprint = this->m_Blueprint.GetPointer();
+    this->m_NetworkBuilder->SetProfiler( this->m_Profiler );
+    this->m_AllUniqueComponents = this->m_CompiledNetwork ? this->m_NetworkBuilder->ConfigureFrom( *this->m_CompiledNetwork ) : this->m_NetworkBuilder->Configure();
   }
   return this->m_AllUniqueComponents;
 }
 
 
+void
+SuperElastixFilterBase
+::SetCompiledNetwork( std::shared_ptr< const CompiledNetwork > compiledNetwork )
+{
+  if( this->m_CompiledNetwork != compiledNetwork )
+  {
+    this->m_CompiledNetwork = compiledNetwork;
+    // The network must be configured again
+    this->ReleaseNetworkBuilder();
+    this->Modified();
+  }
+}
+
+
+void
+SuperElastixFilterBase
+::CompileBlueprint( const std::string & fileName )
+{
+  if( !this->ParseBlueprint() )
+  {
+    itkExceptionMacro( << "Not all components could be uniquely selected, the blueprint cannot be compiled" );
+  }
+  this->m_NetworkBuilder->GetCompiledNetwork().Write( fileName, this->m_Blueprint->GetBlueprintImpl() );
+  this->m_Logger->Log( LogLevel::INF, "Compiled the blueprint into " + fileName + "." );
+}
+
+
+void
+SuperElastixFilterBase
+::ReleaseNetworkBuilder()
+{
+  // Only networks that are fully configured and connected are worth reusing. The components log to the logger of the key.
+  if( this->m_UseNetworkBuilderCache && this->m_NetworkBuilder && this->m_NetworkBuilderCacheKey && this->m_AllUniqueComponents && this->m_IsConnected
+    && std::get< 1 >( *this->m_NetworkBuilderCacheKey ) == this->m_Logger.GetPointer() )
+  {
+    // The profiler belongs to this filter
+    this->m_NetworkBuilder->SetProfiler( nullptr );
+    NetworkBuilderCache::Entry entry;
+    entry.logger         = this->m_Logger;
+    entry.blueprint      = std::move( this->m_NetworkBlueprint );
+    entry.networkBuilder = std::move( this->m_NetworkBuilder );
+    entry.miniPipelineInputs = std::move( this->m_MiniPipelineInputs );
+    NetworkBuilderCache::GetInstance().Release( *this->m_NetworkBuilderCacheKey, std::move( entry ) );
+  }
+  this->m_NetworkBuilder = nullptr;
+  this->m_NetworkBuilderBlueprint = nullptr;
+  this->m_NetworkBlueprint = nullptr;
+  this->m_NetworkBuilderCacheKey = nullptr;
+  this->m_MiniPipelineInputs.clear();
+  this->m_IsConnected = false;
+}
+
+
+void
+SuperElastixFilterBase
+::SetProfiler( Profiler * profiler )
+{
+  this->m_Profiler = profiler;
+  if( this->m_NetworkBuilder )
+  {
+    this->m_NetworkBuilder->SetProfiler( profiler );
+  }
+  // no need to call Modified, since profiling doesn't change any calculations.
+}
+
+
+void
+SuperElastixFilterBase
+::ReleaseMiniPipelineOutputs()
+{
+  for( const auto & nameAndInterface : this->m_NetworkBuilder->GetSinkInterfaces() )
+  {
+    if( nameAndInterface.second->GetMiniPipelineOutput() )
+    {
+      nameAndInterface.second->GetMiniPipelineOutput()->ReleaseData();
+    }
+  }
+}
+
+
 /**
 * ********************* GenerateOutputInformation *********************
 */
@@ -85,11 +239,13 @@ SuperElastixFilterBase
     itkExceptionMacro( << "Setting a BlueprintImpl is required first." )
   }
 
+  Profiler::Scope scope( this->m_Profiler, "GenerateOutputInformation", "phase" );
   this->ParseBlueprint();
 
   // Handle inputs:
   auto                                       inputNames = this->GetInputNames();
   NetworkBuilderBase::SourceInterfaceMapType sources = this->m_NetworkBuilder->GetSourceInterfaces();
+  bool                                       inputsReplaced = false;
   for( const auto & nameAndInterface : sources )
   {
     auto inputName = std::find( inputNames.begin(), inputNames.end(), nameAndInterface.first );
@@ -100,7 +256,35 @@ SuperElastixFilterBase
       itkExceptionMacro( << "SuperElastixFilter requires the input " "" << nameAndInterface.first << "" " for the Source Component with that name" )
     }
 
-    nameAndInterface.second->SetMiniPipelineInput( this->GetInput( nameAndInterface.first ) );
+    DataObject * input = this->GetInput( nameAndInterface.first );
+    auto connectedInput = this->m_MiniPipelineInputs.find( nameAndInterface.first );
+    if( connectedInput == this->m_MiniPipelineInputs.end() )
+    {
+      // The Source is connected with a data object of this filter, such that replacing the input never writes to the
+      // data objects of the caller, which may still be in use.
+      MiniPipelineInputFilter::Pointer miniPipelineInput = MiniPipelineInputFilter::New();
+      miniPipelineInput->SetInput( input );
+      miniPipelineInput->GetOutput()->UpdateOutputInformation();
+      nameAndInterface.second->SetMiniPipelineInput( miniPipelineInput->GetOutput() );
+      this->m_MiniPipelineInputs[ nameAndInterface.first ] = miniPipelineInput;
+    }
+    else if( connectedInput->second->GetInput() != input )
+    {
+      // The network was executed before: the downstream components are connected to the data object of this filter.
+      // Pass the data of the new input through that object, such that no handshakes are repeated.
+      connectedInput->second->SetInput( input );
+      connectedInput->second->GetOutput()->UpdateOutputInformation();
+      inputsReplaced = true;
+    }
+    else
+    {
+      // The same input: the results of the previous execution are valid if neither the input nor its pipeline is modified since.
+      input->UpdateOutputInformation();
+      if( std::max( input->GetMTime(), input->GetPipelineMTime() ) > this->m_ExecutionTime.GetMTime() )
+      {
+        this->m_InputsModified = true;
+      }
+    }
     inputNames.erase( inputName );
   }
   if( inputNames.size() > 0 )
@@ -115,9 +299,16 @@ SuperElastixFilterBase
     itkExceptionMacro( << msg.str() )
     //throw std::runtime_error(msg.str());
   }
+  if( inputsReplaced )
+  {
+    // Outputs of the previous execution were grafted from the sinks and may still be in use.
+    this->ReleaseMiniPipelineOutputs();
+    this->m_InputsModified = true;
+  }
 
   // Handle outputs:
-  auto                                     usedOutputs = this->GetOutputNames();
+  auto                                     requestedOutputs = this->GetOutputNames();
+  auto                                     usedOutputs = requestedOutputs;
   NetworkBuilderBase::SinkInterfaceMapType sinks       = this->m_NetworkBuilder->GetSinkInterfaces();
   for( const auto & nameAndInterface : sinks )
   {
@@ -125,8 +316,9 @@ SuperElastixFilterBase
 
     if( foundIndex == usedOutputs.end() )
     {
-      // or should we catch and rethrow nameAndInterface.second->SetMiniPipelineOutput(this->GetOutput(nameAndInterface.first)); ?
-      itkExceptionMacro( << "SuperElastixFilter requires the output " "" << nameAndInterface.first << "" " for the Sink Component with that name" )
+      // Outputs are evaluated on demand: the parts of the network that only feed this Sink are not executed.
+      this->m_Logger->Log( LogLevel::INF, "No output requested for the Sink Component " + nameAndInterface.first + ", skipping it." );
+      continue;
     }
     // This (empty) Output DataObject is known to the outside of the SuperElastixFilter and might be connected to an itk pipeline.
     // To keep the pipeline intact we need to propagate the DataObject upstream. Additional information such as requested region is preserved as well.
@@ -164,6 +356,10 @@ SuperElastixFilterBase
 
   for( const auto & nameAndInterface : sinks )
   {
+    if( std::find( requestedOutputs.begin(), requestedOutputs.end(), nameAndInterface.first ) == requestedOutputs.end() )
+    {
+      continue;
+    }
     // Update information: ask the mini pipeline what the size of the data will be
     nameAndInterface.second->GetMiniPipelineOutput()->UpdateOutputInformation();
     // Put the information into the Filter's output Objects by grafting
@@ -172,6 +368,35 @@ SuperElastixFilterBase
 }
 
 
+/**
+ * ********************* GenerateInputRequestedRegion *********************
+ */
+
+void
+SuperElastixFilterBase
+::GenerateInputRequestedRegion()
+{
+  // Sibling consumers of a Source that execute in parallel would otherwise update the same input pipeline concurrently
+  if( !this->m_NetworkBuilder || this->m_NumberOfExecutionThreads > 1 )
+  {
+    Superclass::GenerateInputRequestedRegion();
+    return;
+  }
+
+  // Updating the inputs of this filter would otherwise read all input images entirely before the network executes
+  for( const auto & nameAndInterface : this->m_NetworkBuilder->GetSourceInterfaces() )
+  {
+    nameAndInterface.second->DeferMiniPipelineInputRead();
+  }
+
+  // The Sources hold the outputs of the MiniPipelineInputFilters, of which the inputs are the inputs of this filter
+  for( const auto & nameAndMiniPipelineInput : this->m_MiniPipelineInputs )
+  {
+    nameAndMiniPipelineInput.second->GetInput()->SetRequestedRegion( nameAndMiniPipelineInput.second->GetOutput() );
+  }
+}
+
+
 /**
  * ********************* GenerateData *********************
  */
@@ -180,27 +405,90 @@ void
 SuperElastixFilterBase
 ::GenerateData( void )
 {
+  Profiler::Scope scope( this->m_Profiler, "GenerateData", "phase" );
   this->m_Logger->Log( LogLevel::INF, "Executing network ..." );
   // Print citing information
   this->m_NetworkBuilder->Cite();
 
-  auto fullyConfiguredNetwork = this->m_NetworkBuilder->GetRealizedNetwork();
+  auto & fullyConfiguredNetwork = this->m_NetworkBuilder->GetRealizedNetwork();
   // delete the networkbuilder
   // this->m_NetworkBuilder = nullptr;
 
+  // With modified inputs all components are updated again
+  if( this->m_InputsModified )
+  {
+    fullyConfiguredNetwork.Invalidate();
+  }
+  this->m_InputsModified = false;
+
+  // With parallel execution, the data of the Sources is passed on before any of their consumers is dispatched, such
+  // that the consumers find it up to date and do not update the pipelines upstream concurrently.
+  if( this->m_NumberOfExecutionThreads > 1 )
+  {
+    for( const auto & nameAndMiniPipelineInput : this->m_MiniPipelineInputs )
+    {
+      DataObject * miniPipelineInput = nameAndMiniPipelineInput.second->GetOutput();
+      miniPipelineInput->SetRequestedRegionToLargestPossibleRegion();
+      miniPipelineInput->PropagateRequestedRegion();
+      miniPipelineInput->UpdateOutputData();
+    }
+  }
+
+  // Only the outputs that were requested by GetOutput are evaluated, e.g. those connected to a writer.
+  const auto requestedOutputs = this->GetOutputNames();
+
   // This calls controller components that take over the control flow if the itk pipeline is broken.
-  fullyConfiguredNetwork.Execute();
+  fullyConfiguredNetwork.SetNumberOfThreads( this->m_NumberOfExecutionThreads );
+  fullyConfiguredNetwork.SetThreadBudget( this->m_ThreadBudget );
+  fullyConfiguredNetwork.SetReleaseIntermediateData( this->m_ReleaseIntermediateData );
+  fullyConfiguredNetwork.SetIncrementalExecution( this->m_IncrementalExecution );
+  fullyConfiguredNetwork.SetProfiler( this->m_Profiler );
+  fullyConfiguredNetwork.SetProgressMonitor( this->m_ProgressMonitor );
+  fullyConfiguredNetwork.SetCancellationToken( this->m_CancellationToken );
+  std::exception_ptr cancellation;
+  try
+  {
+    fullyConfiguredNetwork.Execute( NetworkContainer::OutputNamesType( requestedOutputs.begin(), requestedOutputs.end() ) );
+  }
+  catch( ExecutionCancelledException & e )
+  {
+    // Deliver the outputs that are complete nevertheless, and report the cancellation after that.
+    this->m_Logger->Log( LogLevel::ERR, std::string( e.what() ) + ". Only the outputs of which all components finished are available." );
+    cancellation = std::current_exception();
+  }
+  const auto finishedOutputs = cancellation ? fullyConfiguredNetwork.GetFinishedOutputNames() : NetworkContainer::OutputNamesType();
 
   // Connect the itk pipeline.
   auto outputObjectsMap = fullyConfiguredNetwork.GetOutputObjectsMap();
   for( const auto & nameAndObject : outputObjectsMap )
   {
-    // Here we force all output to be updated.
-    // TODO: it might be desirable to leave parts of the mini pipeline 'outdated' for memory/speed reasons and only update if requested downsteam.
+    if( std::find( requestedOutputs.begin(), requestedOutputs.end(), nameAndObject.first ) == requestedOutputs.end() )
+    {
+      continue;
+    }
+    if( cancellation && std::find( finishedOutputs.begin(), finishedOutputs.end(), nameAndObject.first ) == finishedOutputs.end() )
+    {
+      this->m_Logger->Log( LogLevel::WRN, "Output " + nameAndObject.first + " is not available, since the execution was cancelled." );
+      continue;
+    }
+    // The mini pipeline of the Sink, recorded under the name of the Sink Component
+    Profiler::Scope sinkScope( this->m_Profiler, nameAndObject.first, "component" );
     nameAndObject.second->Update();
     this->GetOutput( nameAndObject.first )->Graft( nameAndObject.second );
   }
 
+  // The outputs hold on to their own data now
+  if( this->m_ReleaseIntermediateData )
+  {
+    fullyConfiguredNetwork.ReleaseData();
+  }
+
+  if( cancellation )
+  {
+    std::rethrow_exception( cancellation );
+  }
+
+  this->m_ExecutionTime.Modified();
   this->m_Logger->Log( LogLevel::INF, "Executing network ... Done" );
 }
 
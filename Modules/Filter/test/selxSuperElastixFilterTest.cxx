@@ -18,6 +18,7 @@
 *=========================================================================*/
 
 #include "selxSuperElastixFilterCustomComponents.h"
+#include "selxSuperElastixBatch.h"
 
 #include "selxItkSmoothingRecursiveGaussianImageFilterComponent.h"
 #include "selxItkImageSinkComponent.h"
@@ -28,6 +29,7 @@
 #include "itkImage.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkShiftScaleImageFilter.h"
 #include "itkDisplacementFieldTransform.h"
 #include "itkComposeDisplacementFieldsImageFilter.h"
 
@@ -42,6 +44,9 @@
 #include "selxDataManager.h"
 #include "gtest/gtest.h"
 
+#include <fstream>
+#include <vector>
+
 namespace selx
 {
 class SuperElastixFilterTest : public ::testing::Test
@@ -55,6 +60,7 @@ public:
   typedef itk::Image< double, 3 >             Image3DType;
   typedef itk::ImageFileReader< Image3DType > ImageReader3DType;
   typedef itk::ImageFileWriter< Image3DType > ImageWriter3DType;
+  typedef itk::ShiftScaleImageFilter< Image3DType, Image3DType > ShiftScale3DType;
 
   /** Fill SuperElastix' component data base by registering various components */
   typedef TypeList<
@@ -128,6 +134,290 @@ TEST_F( SuperElastixFilterTest, ImageOnly )
 
   imageWriter3D->Update();
 }
+TEST_F( SuperElastixFilterTest, UnrequestedSink )
+{
+  ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
+  imageReader3D->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+
+  BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+  blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "UnrequestedImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+  blueprint->SetConnection( "InputImage", "UnrequestedImage", { {} } );
+
+  // Only the output that is asked for is evaluated, the other Sink is skipped
+  auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+  superElastixFilter->SetLogger( logger );
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetInput( "InputImage", imageReader3D->GetOutput() );
+  auto output = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+  EXPECT_NO_THROW( output->Update() );
+  EXPECT_GT( output->GetLargestPossibleRegion().GetNumberOfPixels(), 0 );
+}
+
+TEST_F( SuperElastixFilterTest, NetworkBuilderCache )
+{
+  NetworkBuilderCache::GetInstance().Clear();
+
+  ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
+  imageReader3D->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+
+  auto makeBlueprint = [](){
+    BlueprintPointer blueprint = Blueprint::New();
+    blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+    blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+    blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+    blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+    blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+    return blueprint;
+  };
+
+  Image3DType::Pointer firstOutput;
+  {
+    auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+    superElastixFilter->SetLogger( logger );
+    superElastixFilter->UseNetworkBuilderCacheOn();
+    superElastixFilter->SetBlueprint( makeBlueprint() );
+    superElastixFilter->SetInput( "InputImage", imageReader3D->GetOutput() );
+    firstOutput = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+    EXPECT_NO_THROW( firstOutput->Update() );
+    EXPECT_EQ( NetworkBuilderCache::GetInstance().Size(), 0 );
+  }
+  // The destroyed filter left its network in the cache
+  EXPECT_EQ( NetworkBuilderCache::GetInstance().Size(), 1 );
+
+  {
+    // An identical, but separately constructed, blueprint takes the cached network
+    auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+    superElastixFilter->SetLogger( logger );
+    superElastixFilter->UseNetworkBuilderCacheOn();
+    superElastixFilter->SetBlueprint( makeBlueprint() );
+    superElastixFilter->SetInput( "InputImage", imageReader3D->GetOutput() );
+    auto secondOutput = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+    EXPECT_EQ( NetworkBuilderCache::GetInstance().Size(), 0 );
+    EXPECT_NO_THROW( secondOutput->Update() );
+
+    // Executing the reused network did not overwrite the output of the first filter
+    EXPECT_NE( firstOutput->GetBufferPointer(), secondOutput->GetBufferPointer() );
+  }
+  EXPECT_EQ( NetworkBuilderCache::GetInstance().Size(), 1 );
+  NetworkBuilderCache::GetInstance().Clear();
+}
+
+TEST_F( SuperElastixFilterTest, ReplacedInput )
+{
+  ImageReader3DType::Pointer imageReader3D_A = ImageReader3DType::New();
+  ImageReader3DType::Pointer imageReader3D_B = ImageReader3DType::New();
+  imageReader3D_A->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+  imageReader3D_B->SetFileName( dataManager->GetInputFile( "sphereB3d.mhd" ) );
+
+  BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+  blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+
+  auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+  superElastixFilter->SetLogger( logger );
+  superElastixFilter->SetBlueprint( blueprint );
+  superElastixFilter->SetInput( "InputImage", imageReader3D_A->GetOutput() );
+  auto output = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+  EXPECT_NO_THROW( output->Update() );
+
+  Image3DType::Pointer image_A = imageReader3D_A->GetOutput();
+  const double * buffer_A = image_A->GetBufferPointer();
+  const Image3DType::RegionType bufferedRegion_A = image_A->GetBufferedRegion();
+  const std::vector< double > pixels_A( buffer_A, buffer_A + bufferedRegion_A.GetNumberOfPixels() );
+  ASSERT_GT( pixels_A.size(), 0 );
+
+  // Re-executing the connected network on another input leaves the output of the first reader alone
+  superElastixFilter->SetInput( "InputImage", imageReader3D_B->GetOutput() );
+  EXPECT_NO_THROW( output->Update() );
+  EXPECT_EQ( image_A->GetBufferPointer(), buffer_A );
+  EXPECT_EQ( image_A->GetBufferedRegion(), bufferedRegion_A );
+  EXPECT_TRUE( std::equal( pixels_A.begin(), pixels_A.end(), image_A->GetBufferPointer() ) );
+
+  // The network did process the second image
+  EXPECT_NE( imageReader3D_B->GetOutput()->GetBufferPointer(), buffer_A );
+  EXPECT_FALSE( imageReader3D_B->GetOutput()->GetBufferedRegion() == bufferedRegion_A
+    && std::equal( pixels_A.begin(), pixels_A.end(), imageReader3D_B->GetOutput()->GetBufferPointer() ) );
+}
+
+TEST_F( SuperElastixFilterTest, ReplacedBlueprint )
+{
+  ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
+  imageReader3D->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+
+  BlueprintPointer smoothingBlueprint = Blueprint::New();
+  smoothingBlueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  smoothingBlueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+  smoothingBlueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  smoothingBlueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  smoothingBlueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+
+  auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+  superElastixFilter->SetLogger( logger );
+  superElastixFilter->SetBlueprint( smoothingBlueprint );
+  superElastixFilter->SetInput( "InputImage", imageReader3D->GetOutput() );
+  auto output = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+  EXPECT_NO_THROW( output->Update() );
+
+  // Replace the blueprint by one that passes the input through, modify it afterwards and drop the first blueprint
+  BlueprintPointer passThroughBlueprint = Blueprint::New();
+  passThroughBlueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  passThroughBlueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } } } );
+  superElastixFilter->SetBlueprint( passThroughBlueprint );
+  passThroughBlueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  passThroughBlueprint->SetConnection( "InputImage", "OutputImage", { {} } );
+  smoothingBlueprint = nullptr;
+
+  // The network of the new blueprint is built, rather than the previous network reconfigured
+  EXPECT_NO_THROW( output->Update() );
+  Image3DType::Pointer input = imageReader3D->GetOutput();
+  imageReader3D->UpdateLargestPossibleRegion();
+  const auto numberOfPixels = input->GetLargestPossibleRegion().GetNumberOfPixels();
+  ASSERT_EQ( output->GetBufferedRegion(), input->GetLargestPossibleRegion() );
+  EXPECT_TRUE( std::equal( input->GetBufferPointer(), input->GetBufferPointer() + numberOfPixels, output->GetBufferPointer() ) );
+}
+
+TEST_F( SuperElastixFilterTest, DeferredInputRead )
+{
+  ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
+  imageReader3D->SetFileName( dataManager->GetInputFile( "sphereA3d.mhd" ) );
+  imageReader3D->Update();
+
+  BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+  blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+
+  for( unsigned int numberOfExecutionThreads : { 1, 2 } )
+  {
+    // A streaming filter upstream of the SuperElastixFilter computes exactly the region that is requested of it
+    ShiftScale3DType::Pointer shiftScale = ShiftScale3DType::New();
+    shiftScale->SetInput( imageReader3D->GetOutput() );
+    shiftScale->SetShift( 1.0 );
+
+    auto superElastixFilter = SuperElastixFilterCustomComponents< RegisterComponents >::New();
+    superElastixFilter->SetLogger( logger );
+    superElastixFilter->SetNumberOfExecutionThreads( numberOfExecutionThreads );
+    superElastixFilter->SetBlueprint( blueprint );
+    superElastixFilter->SetInput( "InputImage", shiftScale->GetOutput() );
+    auto output = superElastixFilter->GetOutput< Image3DType >( "OutputImage" );
+
+    // Update the input as the SuperElastixFilter does before it executes the network
+    output->UpdateOutputInformation();
+    output->PropagateRequestedRegion();
+    shiftScale->GetOutput()->UpdateOutputData();
+    if( numberOfExecutionThreads == 1 )
+    {
+      EXPECT_EQ( shiftScale->GetOutput()->GetBufferedRegion().GetNumberOfPixels(), 0 );
+    }
+    else
+    {
+      // Parallel consumers find the input up to date
+      EXPECT_EQ( shiftScale->GetOutput()->GetBufferedRegion(), shiftScale->GetOutput()->GetLargestPossibleRegion() );
+    }
+
+    // The smoothing filter requests the whole image
+    EXPECT_NO_THROW( output->Update() );
+    EXPECT_EQ( shiftScale->GetOutput()->GetBufferedRegion(), shiftScale->GetOutput()->GetLargestPossibleRegion() );
+  }
+
+  // A consumer of a Source reads the region it requests, not more
+  ShiftScale3DType::Pointer shiftScale = ShiftScale3DType::New();
+  shiftScale->SetInput( imageReader3D->GetOutput() );
+  MiniPipelineInputFilter::Pointer miniPipelineInput = MiniPipelineInputFilter::New();
+  miniPipelineInput->SetInput( shiftScale->GetOutput() );
+  Image3DType::Pointer sourceImage = dynamic_cast< Image3DType * >( miniPipelineInput->GetOutput() );
+  ASSERT_NE( sourceImage, nullptr );
+  sourceImage->UpdateOutputInformation();
+  Image3DType::RegionType requestedRegion = sourceImage->GetLargestPossibleRegion();
+  requestedRegion.SetSize( 0, requestedRegion.GetSize( 0 ) / 2 );
+  sourceImage->SetRequestedRegion( requestedRegion );
+  sourceImage->PropagateRequestedRegion();
+  sourceImage->UpdateOutputData();
+  EXPECT_EQ( shiftScale->GetOutput()->GetBufferedRegion(), requestedRegion );
+  EXPECT_EQ( sourceImage->GetBufferedRegion(), requestedRegion );
+}
+
+TEST_F( SuperElastixFilterTest, Batch )
+{
+  BlueprintPointer blueprint = Blueprint::New();
+  blueprint->SetComponent( "InputImage", { { "NameOfClass", { "ItkImageSourceComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetComponent( "ImageFilter", { { "NameOfClass", { "ItkSmoothingRecursiveGaussianImageFilterComponent" } } } );
+  blueprint->SetComponent( "OutputImage", { { "NameOfClass", { "ItkImageSinkComponent" } }, { "Dimensionality", { "3" } }, { "PixelType", { "double" } } } );
+  blueprint->SetConnection( "InputImage", "ImageFilter", { {} } );
+  blueprint->SetConnection( "ImageFilter", "OutputImage", { {} } );
+
+  // Two workers with two items each: the second item of each worker re-executes an already connected network on another image
+  const std::string manifestFileName = dataManager->GetOutputFile( "SuperElastixBatchTest_manifest.csv" );
+  std::vector< std::string > outputFileNames;
+  {
+    std::ofstream manifest( manifestFileName );
+    manifest << "in:InputImage, out:OutputImage" << std::endl;
+    for( int itemIndex = 0; itemIndex < 4; ++itemIndex )
+    {
+      outputFileNames.push_back( dataManager->GetOutputFile( "SuperElastixBatchTest_" + std::to_string( itemIndex ) + ".mhd" ) );
+      manifest << dataManager->GetInputFile( itemIndex % 2 ? "sphereB3d.mhd" : "sphereA3d.mhd" ) << ", " << outputFileNames.back() << std::endl;
+    }
+  }
+
+  SuperElastixBatch::ItemContainerType items;
+  EXPECT_NO_THROW( items = SuperElastixBatch::ReadManifest( manifestFileName ) );
+  ASSERT_EQ( items.size(), 4 );
+  EXPECT_EQ( items[ 3 ].outputs[ "OutputImage" ], outputFileNames[ 3 ] );
+
+  SuperElastixBatch batch( [](){ return SuperElastixFilterBase::Pointer( SuperElastixFilterCustomComponents< RegisterComponents >::New().GetPointer() ); },
+    blueprint, logger );
+  batch.SetNumberOfWorkers( 2 );
+  SuperElastixBatch::ErrorContainerType errors;
+  EXPECT_NO_THROW( errors = batch.Execute( items ) );
+  ASSERT_EQ( errors.size(), 4 );
+  for( const auto & error : errors )
+  {
+    EXPECT_EQ( error, "" );
+  }
+
+  std::vector< Image3DType::Pointer > outputs;
+  for( const auto & outputFileName : outputFileNames )
+  {
+    ImageReader3DType::Pointer reader = ImageReader3DType::New();
+    reader->SetFileName( outputFileName );
+    reader->Update();
+    outputs.push_back( reader->GetOutput() );
+  }
+  auto sameImage = []( Image3DType * a, Image3DType * b ) {
+    const auto numberOfPixels = a->GetLargestPossibleRegion().GetNumberOfPixels();
+    return numberOfPixels == b->GetLargestPossibleRegion().GetNumberOfPixels()
+      && std::equal( a->GetBufferPointer(), a->GetBufferPointer() + numberOfPixels, b->GetBufferPointer() );
+  };
+  EXPECT_FALSE( sameImage( outputs[ 0 ], outputs[ 1 ] ) );
+  EXPECT_TRUE( sameImage( outputs[ 0 ], outputs[ 2 ] ) );
+  EXPECT_TRUE( sameImage( outputs[ 1 ], outputs[ 3 ] ) );
+}
+
+TEST_F( SuperElastixFilterTest, BatchManifestErrors )
+{
+  const std::string manifestFileName = dataManager->GetOutputFile( "SuperElastixBatchTest_invalid.csv" );
+  {
+    std::ofstream manifest( manifestFileName );
+    manifest << "in:InputImage, OutputImage" << std::endl;
+  }
+  EXPECT_THROW( SuperElastixBatch::ReadManifest( manifestFileName ), std::runtime_error );
+  {
+    std::ofstream manifest( manifestFileName );
+    manifest << "in:InputImage, out:OutputImage" << std::endl << "a.mhd" << std::endl;
+  }
+  EXPECT_THROW( SuperElastixBatch::ReadManifest( manifestFileName ), std::runtime_error );
+}
+
 TEST_F( SuperElastixFilterTest, ImageAndMesh )
 {
   ImageReader3DType::Pointer imageReader3D = ImageReader3DType::New();
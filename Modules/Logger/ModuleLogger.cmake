@@ -27,6 +27,7 @@ set( ${MODULE}_INCLUDE_DIRS
 set( ${MODULE}_SOURCE_FILES
   ${${MODULE}_SOURCE_DIR}/src/selxLogger.cxx
   ${${MODULE}_SOURCE_DIR}/src/selxLoggerImpl.cxx
+  ${${MODULE}_SOURCE_DIR}/src/selxBinaryLogSink.cxx
 )
 
 # Export tests
@@ -0,0 +1,231 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef selxBinaryLogSink_h
+#define selxBinaryLogSink_h
+
+#include "selxLogger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace selx
+{
+
+// Writes log records to a compact binary file. A record stores its timestamp, level, context id, format string id and
+// raw arguments instead of the formatted message. Each logging thread pushes records into its own lock-free ring
+// buffer, which a background thread drains to the file. Use DecodeBinaryLog to render the file as text or JSON.
+class BinaryLogSink
+{
+public:
+
+  typedef std::vector< char > BufferType;
+
+  BinaryLogSink( const std::string& filename, const size_t& ringBufferSize, const bool& discardOnOverflow );
+  ~BinaryLogSink();
+
+  template < typename ... Args >
+  void
+  Write( const LogLevel& level, const std::string& context, const std::string& format, const Args& ... args )
+  {
+    ThreadRingBuffer& ringBuffer = this->GetThreadRingBuffer();
+    BufferType& record = ringBuffer.m_Record;
+    record.clear();
+    this->BeginRecord( ringBuffer, level, context, format, sizeof ... ( Args ) );
+    EncodeArguments( record, args ... );
+    this->Push( ringBuffer );
+  }
+
+  // Blocks until all records pushed so far are written to the file
+  void Flush( void );
+
+  // Number of records dropped because a ring buffer was full
+  size_t GetNumberOfDiscardedRecords( void ) const;
+
+  // Number of ring buffers of logging threads, including those of exited threads that are not drained yet
+  size_t GetNumberOfRingBuffers( void ) const;
+
+  // Argument types as stored in the file
+  enum ArgumentType : char
+  {
+    Integer   = 'i',
+    Unsigned  = 'u',
+    Floating  = 'd',
+    Boolean   = 'b',
+    Character = 'c',
+    String    = 's'
+  };
+
+private:
+
+  // Single producer, single consumer ring buffer of the records of one thread. Only the owning thread pushes
+  // and only the background thread pops, so head and tail are the only shared state.
+  struct ThreadRingBuffer
+  {
+    explicit ThreadRingBuffer( const size_t& size ) : m_Buffer( size ), m_Head( 0 ), m_Tail( 0 ), m_Orphaned( false ) {}
+
+    BufferType            m_Buffer;
+    std::atomic< size_t > m_Head;     // Total number of bytes pushed
+    std::atomic< size_t > m_Tail;     // Total number of bytes popped
+    std::atomic< bool >   m_Orphaned; // Set when the owning thread exits, the ring is freed once it is drained
+    uint64_t              m_ThreadId;
+
+    // Owned by the producing thread: string ids it has already looked up and the record being encoded
+    std::unordered_map< std::string, uint32_t > m_StringIds;
+    BufferType                                  m_Record;
+  };
+
+  ThreadRingBuffer & GetThreadRingBuffer( void );
+
+  void BeginRecord( ThreadRingBuffer& ringBuffer, const LogLevel& level, const std::string& context, const std::string& format,
+    const size_t& numberOfArguments );
+
+  void Push( ThreadRingBuffer& ringBuffer );
+
+  uint32_t GetStringId( ThreadRingBuffer& ringBuffer, const std::string& string );
+
+  // Background thread
+  void Drain( void );
+  bool DrainRingBuffers( void );
+  void WriteRecord( const BufferType& record );
+
+  // Removes the drained ring buffers of exited threads, m_RingBuffersMutex must be locked
+  void RemoveOrphanedRingBuffers( void );
+
+  template < typename T >
+  static void Append( BufferType& record, const T& value )
+  {
+    const char* bytes = reinterpret_cast< const char* >( &value );
+    record.insert( record.end(), bytes, bytes + sizeof( T ) );
+  }
+
+  static void AppendString( BufferType& record, const char* string, const size_t& size )
+  {
+    Append( record, static_cast< uint32_t >( size ) );
+    record.insert( record.end(), string, string + size );
+  }
+
+  static void EncodeArguments( BufferType& ) {}
+
+  template < typename T, typename ... Args >
+  static void EncodeArguments( BufferType& record, const T& argument, const Args& ... args )
+  {
+    Encode( record, argument );
+    EncodeArguments( record, args ... );
+  }
+
+  template < typename T >
+  static typename std::enable_if< std::is_integral< T >::value && std::is_signed< T >::value >::type
+  Encode( BufferType& record, const T& value )
+  {
+    record.push_back( Integer );
+    Append( record, static_cast< int64_t >( value ) );
+  }
+
+  template < typename T >
+  static typename std::enable_if< std::is_integral< T >::value && std::is_unsigned< T >::value >::type
+  Encode( BufferType& record, const T& value )
+  {
+    record.push_back( Unsigned );
+    Append( record, static_cast< uint64_t >( value ) );
+  }
+
+  template < typename T >
+  static typename std::enable_if< std::is_floating_point< T >::value >::type
+  Encode( BufferType& record, const T& value )
+  {
+    record.push_back( Floating );
+    Append( record, static_cast< double >( value ) );
+  }
+
+  static void Encode( BufferType& record, const bool& value )
+  {
+    record.push_back( Boolean );
+    record.push_back( value ? 1 : 0 );
+  }
+
+  static void Encode( BufferType& record, const char& value )
+  {
+    record.push_back( Character );
+    record.push_back( value );
+  }
+
+  static void Encode( BufferType& record, const char* value )
+  {
+    record.push_back( String );
+    AppendString( record, value, std::strlen( value ) );
+  }
+
+  static void Encode( BufferType& record, const std::string& value )
+  {
+    record.push_back( String );
+    AppendString( record, value.data(), value.size() );
+  }
+
+  // Other types, such as the values returned by LoggerImpl::operator<<, are stored as their text
+  template < typename T >
+  static typename std::enable_if< !std::is_arithmetic< T >::value && !std::is_convertible< const T&, const char* >::value
+  && !std::is_same< T, std::string >::value >::type
+  Encode( BufferType& record, const T& value )
+  {
+    std::ostringstream out;
+    out << value;
+    Encode( record, out.str() );
+  }
+
+  const size_t m_Id;
+  const size_t m_RingBufferSize;
+  const bool   m_DiscardOnOverflow;
+
+  mutable std::mutex                               m_RingBuffersMutex;
+  std::vector< std::shared_ptr< ThreadRingBuffer > > m_RingBuffers;
+
+  // String table of format strings and contexts
+  std::mutex                                  m_StringsMutex;
+  std::unordered_map< std::string, uint32_t > m_StringIds;
+  std::vector< std::string >                  m_Strings;
+  size_t                                      m_NumberOfWrittenStrings;
+
+  std::mutex    m_FileMutex;
+  std::ofstream m_File;
+
+  std::atomic< size_t >   m_NumberOfDiscardedRecords;
+  std::atomic< bool >     m_Stop;
+  std::mutex              m_DrainMutex;
+  std::condition_variable m_DrainCondition;
+  std::thread             m_DrainThread;
+};
+
+// Renders a file written by BinaryLogSink as one line of text per record, or as one JSON object per line
+void DecodeBinaryLog( std::istream& in, std::ostream& out, const bool& json );
+
+} // namespace
+
+#endif // selxBinaryLogSink_h
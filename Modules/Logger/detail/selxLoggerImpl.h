@@ -23,6 +23,7 @@
 #include <iterator>
 
 #include "selxLogger.h"
+#include "selxBinaryLogSink.h"
 
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/ostream_sink.h"
@@ -44,6 +45,10 @@ public:
   void SetLogLevel( const LogLevel& level );
   void SetPattern( const std::string& pattern );
 
+  // Tag that is written with every record of this logger (%n in the pattern), e.g. a job id
+  void SetContext( const std::string& context );
+  const std::string& GetContext( void ) const;
+
   void SetSyncMode();
   void SetAsyncMode();
   void SetAsyncQueueBlockOnOverflow(void);
@@ -52,76 +57,141 @@ public:
   void AsyncQueueFlush();
 
   void AddStream( const std::string& identifier, std::ostream& stream, const bool& forceFlush = false );
+  void AddRotatingFileBySize( const std::string& identifier, const std::string& filename, const size_t& maxFileSize, const size_t& maxNumberOfFiles );
+  void AddRotatingFileByTime( const std::string& identifier, const std::string& filename, const int& hour, const int& minute );
+  void AddBinaryFile( const std::string& identifier, const std::string& filename );
   void RemoveStream( const std::string& identifier );
   void RemoveAllStreams( void );
 
   void Log( const LogLevel& level, const std::string& message );
 
+  // Whether a message of this level is logged by any stream. Log checks it before formatting.
+  bool ShouldLog( const LogLevel& level ) const;
+
+  // The message is formatted once for all streams, and not at all if no stream logs the level
   template < typename ... Args >
   void
-  Log( const LogLevel& level, const std::string& fmt, const Args& ... args )
+  Log( const LogLevel& level, const std::string& format, const Args& ... args )
   {
-  	for( const auto& identifierAndLogger : this->m_Loggers )
-  	{
-      identifierAndLogger.second->log( this->ToSpdLogLevel( level ), fmt.c_str(), args ... );
-  	}
+    if( !this->ShouldLog( level ) )
+    {
+      return;
+    }
+
+    // Binary files store the arguments as they are
+    for( const auto& identifierAndBinarySink : this->m_BinarySinks )
+    {
+      identifierAndBinarySink.second->Write( level, this->m_Context, format, args ... );
+    }
+
+    if( !this->m_Logger )
+    {
+      return;
+    }
+
+    fmt::MemoryWriter message;
+    try
+    {
+      message.write( format.c_str(), args ... );
+    }
+    catch( const std::exception& e )
+    {
+      message.clear();
+      message << "Failed to format log message '" << format << "': " << e.what();
+    }
+    this->LogFormatted( this->ToSpdLogLevel( level ), message.c_str() );
+  }
+
+  // Writes a value to a log message, as "[v1, v2]" for vectors and "{k1: v1, k2: v2}" for maps
+  template < typename T >
+  static void Write( std::ostream& out, const T& value ) {
+    out << value;
   }
 
-  // Stream std:vector to string
   // TODO: Use std::copy_n to print [n1, n2, ... , n-1, n] if vector is long
   template < typename T >
-  std::string operator<<( const std::vector< T >& v ) {
-    std::ostringstream out;
+  static void Write( std::ostream& out, const std::vector< T >& v ) {
     if( !v.empty() ) {
       if( v.size() > 1 ) out << '[';
       std::copy( v.begin(), v.end(), std::ostream_iterator< T >( out, ", " ) );
       out << "\b\b";
       if( v.size() > 1 ) out << "]";
     }
-    return out.str();
   }
 
-  // Stream std::map< T, T > to string
-  template < typename T >
-  std::string operator<<( const std::map< T, T >& m ) {
-    std::ostringstream out;
+  template < typename K, typename V >
+  static void Write( std::ostream& out, const std::map< K, V >& m ) {
     if( !m.empty() ) {
       out << "{";
       for( const auto& item : m )
       {
-        out << item.first << ": " << item.second << ", ";
+        out << item.first << ": ";
+        Write( out, item.second );
+        out << ", ";
       }
       out << "\b\b}";
     }
-    return out.str();
   }
 
-  // Stream std::map< T, std::vector< T > > to string
+  // A value that is written when the log message is formatted, i.e. only if the message is logged. It refers to the value,
+  // so it must be passed to Log in the same expression.
   template < typename T >
-  std::string operator<<( const std::map< T, std::vector< T > >& m ) {
-    std::ostringstream out;
-    if( !m.empty() ) {
-      out << "{";
-      for( const auto& item : m )
-      {
-        out << item.first << ": " << this << item.second << ", ";
-      }
-      out << "\b\b}";
+  class LazyValue
+  {
+  public:
+    explicit LazyValue( const T& value ) : m_Value( value ) {}
+    friend std::ostream& operator<<( std::ostream& out, const LazyValue& lazyValue ) {
+      LoggerImpl::Write( out, lazyValue.m_Value );
+      return out;
     }
-    return out.str();
+  private:
+    const T& m_Value;
+  };
+
+  // Stream std:vector to a log message argument
+  template < typename T >
+  LazyValue< std::vector< T > > operator<<( const std::vector< T >& v ) {
+    return LazyValue< std::vector< T > >( v );
+  }
+
+  // Stream std::map< K, V > to a log message argument, where V may be a std::vector
+  template < typename K, typename V >
+  LazyValue< std::map< K, V > > operator<<( const std::map< K, V >& m ) {
+    return LazyValue< std::map< K, V > >( m );
   }
 
 private:
 
   // Spdlog configuration
-  spdlog::level::level_enum ToSpdLogLevel( const LogLevel& level );
+  static spdlog::level::level_enum ToSpdLogLevel( const LogLevel& level );
+
+  // Passes a formatted message to all streams
+  void LogFormatted( const spdlog::level::level_enum& level, const char* message );
+
+  void AddSink( const std::string& identifier, const spdlog::sink_ptr& sink );
+
+  // Recreates the spdlog logger of this instance from its streams and settings. Loggers are not registered
+  // with spdlog, so instances do not share levels, patterns or stream identifiers.
+  void CreateLogger( void );
+
+  std::string m_Context;
+  spdlog::level::level_enum m_LogLevel;
+  std::string m_Pattern;
+
+  bool m_IsAsync;
   size_t m_AsyncQueueSize;
   AsyncQueueOverflowPolicyType m_AsyncQueueOverflowPolicy;
 
-  // Logger container
+  // Streams
+  typedef std::map< std::string, spdlog::sink_ptr > SinkMapType;
+  SinkMapType m_Sinks;
+
+  typedef std::map< std::string, std::shared_ptr< BinaryLogSink > > BinarySinkMapType;
+  BinarySinkMapType m_BinarySinks;
+
+  // Logger that writes to all streams, or nullptr if there are none
   typedef std::shared_ptr< spdlog::logger > LoggerType;
-  typedef std::map< std::string, LoggerType > LoggerVectorType;
-  LoggerVectorType m_Loggers;
+  LoggerType m_Logger;
 
 };
 
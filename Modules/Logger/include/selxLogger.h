@@ -63,6 +63,9 @@ public:
   void SetLogLevel( const LogLevel& level );
   void SetPattern( const std::string& pattern );
 
+  // Tag written with every record of this logger, e.g. a job id. Loggers do not share any state.
+  void SetContext( const std::string& context );
+
   void SetSyncMode();
   void SetAsyncMode();
   void SetAsyncQueueBlockOnOverflow(void);
@@ -70,8 +73,14 @@ public:
   void SetAsyncQueueSize( const size_t& queueSize );
   void AsyncQueueFlush();
 
-  // TODO: AddStreamWithColors, AddRotatingFileBySize, AddRotatingFileByTime
+  // TODO: AddStreamWithColors
   void AddStream( const std::string& identifier, std::ostream& stream, const bool& force_flush = false );
+  void AddRotatingFileBySize( const std::string& identifier, const std::string& filename, const size_t& maxFileSize, const size_t& maxNumberOfFiles );
+  void AddRotatingFileByTime( const std::string& identifier, const std::string& filename, const int& hour, const int& minute );
+
+  // Logs records with unformatted arguments to a compact binary file, written by a background thread. Decode the file
+  // with SuperElastixLogDecoder.
+  void AddBinaryFile( const std::string& identifier, const std::string& filename );
   void RemoveStream( const std::string& identifier );
   void RemoveAllStreams( void );
 
@@ -0,0 +1,585 @@
+/*=========================================================================
+ *
+ *  Copyright Leiden University Medical Center, Erasmus University Medical
+ *  Center and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "selxBinaryLogSink.h"
+
+#include "spdlog/details/os.h"
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+
+namespace selx
+{
+
+namespace
+{
+
+const char BinaryLogMagic[] = { 'S', 'E', 'L', 'X', 'L', 'O', 'G', 1 };
+const char StringEntry = 'S';
+const char RecordEntry = 'R';
+
+// Offsets of the fields of a record: timestamp, thread id, level, context id, format id, number of arguments, arguments
+const size_t ContextIdOffset = sizeof( int64_t ) + sizeof( uint64_t ) + 1;
+const size_t FormatIdOffset  = ContextIdOffset + sizeof( uint32_t );
+
+void
+CopyToRingBuffer( BinaryLogSink::BufferType& ringBuffer, const size_t& position, const char* data, const size_t& size )
+{
+  const size_t offset = position % ringBuffer.size();
+  const size_t first  = std::min( size, ringBuffer.size() - offset );
+  std::memcpy( &ringBuffer[ offset ], data, first );
+  std::memcpy( &ringBuffer[ 0 ], data + first, size - first );
+}
+
+void
+CopyFromRingBuffer( const BinaryLogSink::BufferType& ringBuffer, const size_t& position, char* data, const size_t& size )
+{
+  const size_t offset = position % ringBuffer.size();
+  const size_t first  = std::min( size, ringBuffer.size() - offset );
+  std::memcpy( data, &ringBuffer[ offset ], first );
+  std::memcpy( data + first, &ringBuffer[ 0 ], size - first );
+}
+
+} // namespace
+
+BinaryLogSink
+::BinaryLogSink( const std::string& filename, const size_t& ringBufferSize, const bool& discardOnOverflow ) :
+  m_Id( [](){ static std::atomic< size_t > numberOfSinks( 0 ); return numberOfSinks++; }() ),
+  m_RingBufferSize( ringBufferSize ),
+  m_DiscardOnOverflow( discardOnOverflow ),
+  m_NumberOfWrittenStrings( 0 ),
+  m_File( filename, std::ios::binary | std::ios::trunc ),
+  m_NumberOfDiscardedRecords( 0 ),
+  m_Stop( false )
+{
+  if( !this->m_File )
+  {
+    itkGenericExceptionMacro( "Could not open binary log file '" << filename << "'." );
+  }
+
+  this->m_File.write( BinaryLogMagic, sizeof( BinaryLogMagic ) );
+  this->m_DrainThread = std::thread( &BinaryLogSink::Drain, this );
+}
+
+BinaryLogSink
+::~BinaryLogSink()
+{
+  this->m_Stop = true;
+  this->m_DrainCondition.notify_one();
+  this->m_DrainThread.join();
+}
+
+BinaryLogSink::ThreadRingBuffer &
+BinaryLogSink
+::GetThreadRingBuffer( void )
+{
+  // The sink owns the ring buffers, so the entries of destroyed sinks expire. When the thread exits, its rings are
+  // marked orphaned and the sinks free them once the records are drained.
+  struct ThreadRingBuffers
+  {
+    ~ThreadRingBuffers()
+    {
+      for( const auto& entry : this->m_Entries )
+      {
+        if( std::shared_ptr< ThreadRingBuffer > ringBuffer = entry.second.lock() )
+        {
+          ringBuffer->m_Orphaned.store( true, std::memory_order_release );
+        }
+      }
+    }
+
+    std::unordered_map< size_t, std::weak_ptr< ThreadRingBuffer > > m_Entries;
+  };
+  thread_local ThreadRingBuffers threadRingBuffers;
+
+  std::weak_ptr< ThreadRingBuffer >& entry = threadRingBuffers.m_Entries[ this->m_Id ];
+  std::shared_ptr< ThreadRingBuffer > ringBuffer = entry.lock();
+  if( !ringBuffer )
+  {
+    ringBuffer = std::make_shared< ThreadRingBuffer >( this->m_RingBufferSize );
+    ringBuffer->m_ThreadId = spdlog::details::os::thread_id();
+    std::lock_guard< std::mutex > lock( this->m_RingBuffersMutex );
+    this->m_RingBuffers.push_back( ringBuffer );
+    entry = ringBuffer;
+  }
+  return *ringBuffer;
+}
+
+void
+BinaryLogSink
+::BeginRecord( ThreadRingBuffer& ringBuffer, const LogLevel& level, const std::string& context, const std::string& format,
+  const size_t& numberOfArguments )
+{
+  BufferType& record = ringBuffer.m_Record;
+  const auto  time   = std::chrono::system_clock::now().time_since_epoch();
+  Append( record, static_cast< int64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( time ).count() ) );
+  Append( record, ringBuffer.m_ThreadId );
+  record.push_back( static_cast< char >( level ) );
+  Append( record, this->GetStringId( ringBuffer, context ) );
+  Append( record, this->GetStringId( ringBuffer, format ) );
+  record.push_back( static_cast< char >( numberOfArguments ) );
+}
+
+uint32_t
+BinaryLogSink
+::GetStringId( ThreadRingBuffer& ringBuffer, const std::string& string )
+{
+  auto threadStringId = ringBuffer.m_StringIds.find( string );
+  if( threadStringId != ringBuffer.m_StringIds.end() )
+  {
+    return threadStringId->second;
+  }
+
+  std::lock_guard< std::mutex > lock( this->m_StringsMutex );
+  auto stringId = this->m_StringIds.emplace( string, static_cast< uint32_t >( this->m_Strings.size() ) );
+  if( stringId.second )
+  {
+    this->m_Strings.push_back( string );
+  }
+  ringBuffer.m_StringIds.emplace( string, stringId.first->second );
+  return stringId.first->second;
+}
+
+void
+BinaryLogSink
+::Push( ThreadRingBuffer& ringBuffer )
+{
+  const BufferType& record   = ringBuffer.m_Record;
+  const uint32_t    size     = static_cast< uint32_t >( record.size() );
+  const size_t      capacity = ringBuffer.m_Buffer.size();
+  if( sizeof( size ) + size > capacity )
+  {
+    ++this->m_NumberOfDiscardedRecords;
+    return;
+  }
+
+  const size_t head = ringBuffer.m_Head.load( std::memory_order_relaxed );
+  while( capacity - ( head - ringBuffer.m_Tail.load( std::memory_order_acquire ) ) < sizeof( size ) + size )
+  {
+    if( this->m_DiscardOnOverflow )
+    {
+      ++this->m_NumberOfDiscardedRecords;
+      return;
+    }
+    this->m_DrainCondition.notify_one();
+    std::this_thread::yield();
+  }
+
+  CopyToRingBuffer( ringBuffer.m_Buffer, head, reinterpret_cast< const char* >( &size ), sizeof( size ) );
+  CopyToRingBuffer( ringBuffer.m_Buffer, head + sizeof( size ), record.data(), size );
+  ringBuffer.m_Head.store( head + sizeof( size ) + size, std::memory_order_release );
+}
+
+void
+BinaryLogSink
+::Flush( void )
+{
+  bool empty = false;
+  while( !empty )
+  {
+    empty = true;
+    {
+      std::lock_guard< std::mutex > lock( this->m_RingBuffersMutex );
+      for( const auto& ringBuffer : this->m_RingBuffers )
+      {
+        empty = empty && ringBuffer->m_Tail.load( std::memory_order_acquire ) == ringBuffer->m_Head.load( std::memory_order_acquire );
+      }
+      if( empty )
+      {
+        this->RemoveOrphanedRingBuffers();
+      }
+    }
+    if( !empty )
+    {
+      this->m_DrainCondition.notify_one();
+      std::this_thread::yield();
+    }
+  }
+
+  std::lock_guard< std::mutex > lock( this->m_FileMutex );
+  this->m_File.flush();
+}
+
+size_t
+BinaryLogSink
+::GetNumberOfDiscardedRecords( void ) const
+{
+  return this->m_NumberOfDiscardedRecords;
+}
+
+size_t
+BinaryLogSink
+::GetNumberOfRingBuffers( void ) const
+{
+  std::lock_guard< std::mutex > lock( this->m_RingBuffersMutex );
+  return this->m_RingBuffers.size();
+}
+
+void
+BinaryLogSink
+::Drain( void )
+{
+  while( !this->m_Stop )
+  {
+    if( !this->DrainRingBuffers() )
+    {
+      std::unique_lock< std::mutex > lock( this->m_DrainMutex );
+      this->m_DrainCondition.wait_for( lock, std::chrono::milliseconds( 10 ) );
+    }
+  }
+  this->DrainRingBuffers();
+
+  std::lock_guard< std::mutex > lock( this->m_FileMutex );
+  this->m_File.flush();
+}
+
+bool
+BinaryLogSink
+::DrainRingBuffers( void )
+{
+  std::vector< std::shared_ptr< ThreadRingBuffer > > ringBuffers;
+  {
+    std::lock_guard< std::mutex > lock( this->m_RingBuffersMutex );
+    ringBuffers = this->m_RingBuffers;
+  }
+
+  bool       drained = false;
+  BufferType record;
+  std::lock_guard< std::mutex > lock( this->m_FileMutex );
+  for( const auto& ringBuffer : ringBuffers )
+  {
+    size_t       tail = ringBuffer->m_Tail.load( std::memory_order_relaxed );
+    const size_t head = ringBuffer->m_Head.load( std::memory_order_acquire );
+    while( tail < head )
+    {
+      uint32_t size;
+      CopyFromRingBuffer( ringBuffer->m_Buffer, tail, reinterpret_cast< char* >( &size ), sizeof( size ) );
+      record.resize( size );
+      CopyFromRingBuffer( ringBuffer->m_Buffer, tail + sizeof( size ), record.data(), size );
+      this->WriteRecord( record );
+
+      tail += sizeof( size ) + size;
+      ringBuffer->m_Tail.store( tail, std::memory_order_release );
+      drained = true;
+    }
+  }
+
+  std::lock_guard< std::mutex > ringBuffersLock( this->m_RingBuffersMutex );
+  this->RemoveOrphanedRingBuffers();
+  return drained;
+}
+
+void
+BinaryLogSink
+::RemoveOrphanedRingBuffers( void )
+{
+  // The owning thread pushes nothing after it orphans its ring, so check the flag before the head
+  this->m_RingBuffers.erase( std::remove_if( this->m_RingBuffers.begin(), this->m_RingBuffers.end(),
+    []( const std::shared_ptr< ThreadRingBuffer >& ringBuffer ) {
+      return ringBuffer->m_Orphaned.load( std::memory_order_acquire )
+      && ringBuffer->m_Tail.load( std::memory_order_acquire ) == ringBuffer->m_Head.load( std::memory_order_acquire );
+    } ), this->m_RingBuffers.end() );
+}
+
+void
+BinaryLogSink
+::WriteRecord( const BufferType& record )
+{
+  // Strings are written before the first record that refers to them
+  uint32_t contextId, formatId;
+  std::memcpy( &contextId, &record[ ContextIdOffset ], sizeof( contextId ) );
+  std::memcpy( &formatId, &record[ FormatIdOffset ], sizeof( formatId ) );
+  const size_t numberOfStrings = std::max( contextId, formatId ) + 1;
+  if( numberOfStrings > this->m_NumberOfWrittenStrings )
+  {
+    std::lock_guard< std::mutex > lock( this->m_StringsMutex );
+    for( ; this->m_NumberOfWrittenStrings < numberOfStrings; ++this->m_NumberOfWrittenStrings )
+    {
+      const std::string& string = this->m_Strings[ this->m_NumberOfWrittenStrings ];
+      const uint32_t     size   = static_cast< uint32_t >( string.size() );
+      this->m_File.put( StringEntry );
+      this->m_File.write( reinterpret_cast< const char* >( &size ), sizeof( size ) );
+      this->m_File.write( string.data(), size );
+    }
+  }
+
+  const uint32_t size = static_cast< uint32_t >( record.size() );
+  this->m_File.put( RecordEntry );
+  this->m_File.write( reinterpret_cast< const char* >( &size ), sizeof( size ) );
+  this->m_File.write( record.data(), size );
+}
+
+namespace
+{
+
+template < typename T >
+bool
+Read( std::istream& in, T& value )
+{
+  return static_cast< bool >( in.read( reinterpret_cast< char* >( &value ), sizeof( T ) ) );
+}
+
+bool
+ReadString( std::istream& in, std::string& string )
+{
+  uint32_t size;
+  if( !Read( in, size ) )
+  {
+    return false;
+  }
+  string.resize( size );
+  return size == 0 || static_cast< bool >( in.read( &string[ 0 ], size ) );
+}
+
+struct Argument
+{
+  char        type;
+  int64_t     integer;
+  uint64_t    unsignedInteger;
+  double      floating;
+  std::string string;
+};
+
+bool
+ReadArgument( std::istream& in, Argument& argument )
+{
+  if( !Read( in, argument.type ) )
+  {
+    return false;
+  }
+
+  switch( argument.type )
+  {
+    case BinaryLogSink::Integer:
+      return Read( in, argument.integer );
+    case BinaryLogSink::Unsigned:
+      return Read( in, argument.unsignedInteger );
+    case BinaryLogSink::Floating:
+      return Read( in, argument.floating );
+    case BinaryLogSink::Boolean:
+    case BinaryLogSink::Character:
+      argument.string.resize( 1 );
+      return Read( in, argument.string[ 0 ] );
+    case BinaryLogSink::String:
+      return ReadString( in, argument.string );
+    default:
+      return false;
+  }
+}
+
+std::string
+FormatArgument( const Argument& argument, const std::string& specification )
+{
+  const std::string format = specification.empty() ? "{}" : "{:" + specification + "}";
+  switch( argument.type )
+  {
+    case BinaryLogSink::Integer:
+      return fmt::format( format, argument.integer );
+    case BinaryLogSink::Unsigned:
+      return fmt::format( format, argument.unsignedInteger );
+    case BinaryLogSink::Floating:
+      return fmt::format( format, argument.floating );
+    case BinaryLogSink::Boolean:
+      return fmt::format( format, argument.string[ 0 ] != 0 );
+    case BinaryLogSink::Character:
+      return fmt::format( format, argument.string[ 0 ] );
+    default:
+      return fmt::format( format, argument.string );
+  }
+}
+
+// Substitutes "{}", "{n}" and "{n:specification}" like LoggerImpl::Log does. Placeholders that cannot be formatted are
+// kept as they are.
+std::string
+FormatMessage( const std::string& format, const std::vector< Argument >& arguments )
+{
+  std::string message;
+  size_t      nextIndex = 0;
+  for( size_t position = 0; position < format.size(); ++position )
+  {
+    const char character = format[ position ];
+    if( ( character == '{' || character == '}' ) && position + 1 < format.size() && format[ position + 1 ] == character )
+    {
+      message += character;
+      ++position;
+      continue;
+    }
+
+    const size_t end = format.find( '}', position );
+    if( character != '{' || end == std::string::npos )
+    {
+      message += character;
+      continue;
+    }
+
+    const std::string placeholder   = format.substr( position + 1, end - position - 1 );
+    const size_t      colon         = placeholder.find( ':' );
+    const std::string index         = placeholder.substr( 0, colon );
+    const std::string specification = colon == std::string::npos ? "" : placeholder.substr( colon + 1 );
+    try
+    {
+      const size_t argumentIndex = index.empty() ? nextIndex++ : std::stoul( index );
+      message += FormatArgument( arguments.at( argumentIndex ), specification );
+    }
+    catch( const std::exception& )
+    {
+      message += format.substr( position, end - position + 1 );
+    }
+    position = end;
+  }
+  return message;
+}
+
+std::string
+ToJson( const std::string& string )
+{
+  std::string json = "\"";
+  for( const char character : string )
+  {
+    switch( character )
+    {
+      case '"':
+        json += "\\\"";
+        break;
+      case '\\':
+        json += "\\\\";
+        break;
+      case '\n':
+        json += "\\n";
+        break;
+      case '\t':
+        json += "\\t";
+        break;
+      default:
+        if( static_cast< unsigned char >( character ) < 0x20 )
+        {
+          json += fmt::format( "\\u{:04x}", static_cast< int >( character ) );
+        }
+        else
+        {
+          json += character;
+        }
+    }
+  }
+  return json + "\"";
+}
+
+std::string
+ToJson( const Argument& argument )
+{
+  switch( argument.type )
+  {
+    case BinaryLogSink::Integer:
+      return std::to_string( argument.integer );
+    case BinaryLogSink::Unsigned:
+      return std::to_string( argument.unsignedInteger );
+    case BinaryLogSink::Floating:
+      return std::isfinite( argument.floating ) ? fmt::format( "{}", argument.floating ) : "null";
+    case BinaryLogSink::Boolean:
+      return argument.string[ 0 ] ? "true" : "false";
+    default:
+      return ToJson( argument.string );
+  }
+}
+
+std::string
+FormatTime( const int64_t& nanoseconds )
+{
+  const std::time_t seconds = static_cast< std::time_t >( nanoseconds / 1000000000 );
+  std::ostringstream time;
+  time << std::put_time( std::localtime( &seconds ), "%Y-%m-%d %H:%M:%S" ) << '.'
+       << std::setw( 6 ) << std::setfill( '0' ) << ( nanoseconds % 1000000000 ) / 1000;
+  return time.str();
+}
+
+} // namespace
+
+void
+DecodeBinaryLog( std::istream& in, std::ostream& out, const bool& json )
+{
+  static const char* const levelNames[] = { "trace", "debug", "info", "warning", "error", "critical", "off" };
+
+  char magic[ sizeof( BinaryLogMagic ) ];
+  if( !in.read( magic, sizeof( magic ) ) || std::memcmp( magic, BinaryLogMagic, sizeof( magic ) ) != 0 )
+  {
+    itkGenericExceptionMacro( "Input is not a SuperElastix binary log." );
+  }
+
+  std::vector< std::string > strings;
+  char                       entry;
+  while( in.get( entry ) )
+  {
+    std::string payload;
+    if( !ReadString( in, payload ) )
+    {
+      itkGenericExceptionMacro( "Binary log is truncated." );
+    }
+
+    if( entry == StringEntry )
+    {
+      strings.push_back( payload );
+      continue;
+    }
+
+    std::istringstream record( payload );
+    int64_t            time;
+    uint64_t           threadId;
+    unsigned char      level;
+    char               numberOfArguments;
+    uint32_t           contextId, formatId;
+    std::vector< Argument > arguments;
+    bool valid = Read( record, time ) && Read( record, threadId ) && Read( record, level ) && Read( record, contextId )
+      && Read( record, formatId ) && Read( record, numberOfArguments ) && contextId < strings.size() && formatId < strings.size()
+      && level < 7;
+    for( int i = 0; valid && i < static_cast< unsigned char >( numberOfArguments ); ++i )
+    {
+      arguments.emplace_back();
+      valid = ReadArgument( record, arguments.back() );
+    }
+    if( entry != RecordEntry || !valid )
+    {
+      itkGenericExceptionMacro( "Binary log is corrupt." );
+    }
+
+    const std::string& format  = strings[ formatId ];
+    const std::string  message = FormatMessage( format, arguments );
+    if( json )
+    {
+      out << "{\"time\": " << ToJson( FormatTime( time ) ) << ", \"thread\": " << threadId
+          << ", \"context\": " << ToJson( strings[ contextId ] ) << ", \"level\": \"" << levelNames[ level ]
+          << "\", \"format\": " << ToJson( format ) << ", \"arguments\": [";
+      for( size_t i = 0; i < arguments.size(); ++i )
+      {
+        out << ( i > 0 ? ", " : "" ) << ToJson( arguments[ i ] );
+      }
+      out << "], \"message\": " << ToJson( message ) << "}\n";
+    }
+    else
+    {
+      out << "[" << FormatTime( time ) << "] [thread " << threadId << "] [" << strings[ contextId ] << "] ["
+          << levelNames[ level ] << "] " << message << "\n";
+    }
+  }
+}
+
+} // namespace
@@ -46,6 +46,13 @@ Logger
   this->m_LoggerImpl->SetPattern( pattern );
 }
 
+void
+Logger
+::SetContext( const std::string& context )
+{
+  this->m_LoggerImpl->SetContext( context );
+}
+
 void
 Logger
 ::SetSyncMode()
@@ -95,6 +102,27 @@ Logger
   this->m_LoggerImpl->AddStream( identifier, stream, forceFlush);
 }
 
+void
+Logger
+::AddRotatingFileBySize( const std::string& identifier, const std::string& filename, const size_t& maxFileSize, const size_t& maxNumberOfFiles )
+{
+  this->m_LoggerImpl->AddRotatingFileBySize( identifier, filename, maxFileSize, maxNumberOfFiles );
+}
+
+void
+Logger
+::AddRotatingFileByTime( const std::string& identifier, const std::string& filename, const int& hour, const int& minute )
+{
+  this->m_LoggerImpl->AddRotatingFileByTime( identifier, filename, hour, minute );
+}
+
+void
+Logger
+::AddBinaryFile( const std::string& identifier, const std::string& filename )
+{
+  this->m_LoggerImpl->AddBinaryFile( identifier, filename );
+}
+
 void
 Logger
 ::RemoveStream( const std::string& identifier )
@@ -18,16 +18,27 @@
  *=========================================================================*/
 
 #include "selxLoggerImpl.h"
-#include "spdlog/details/registry.h"
+#include "spdlog/async_logger.h"
+#include "spdlog/sinks/file_sinks.h"
+
+#include <atomic>
 
 namespace selx
 {
 
 LoggerImpl
-::LoggerImpl() : m_Loggers(), m_AsyncQueueSize( 262144 ), m_AsyncQueueOverflowPolicy( spdlog::async_overflow_policy::block_retry )
+::LoggerImpl() :
+  m_LogLevel( spdlog::level::level_enum::info ),
+  m_Pattern( "[%Y-%m-%d %H:%M:%S.%f] [thread %t] [%n] [%l] %v" ),
+  m_IsAsync( false ),
+  m_AsyncQueueSize( 262144 ),
+  m_AsyncQueueOverflowPolicy( spdlog::async_overflow_policy::block_retry ),
+  m_Sinks(),
+  m_Logger( nullptr )
 {
-  this->SetSyncMode();
-  this->SetPattern( "[%Y-%m-%d %H:%M:%S.%f] [thread %t] [%l] %v" );
+  // Tell apart the records of loggers that write to the same stream until the user sets a context
+  static std::atomic< size_t > numberOfLoggers( 0 );
+  this->m_Context = "logger " + std::to_string( numberOfLoggers++ );
 }
 
 LoggerImpl
@@ -62,11 +73,10 @@ LoggerImpl
 void
 LoggerImpl
 ::SetLogLevel( const LogLevel& level ) {
-  spdlog::level::level_enum spdloglevel = this->ToSpdLogLevel( level );
-  spdlog::set_level( spdloglevel );
-  for( const auto& item : this->m_Loggers )
+  this->m_LogLevel = this->ToSpdLogLevel( level );
+  if( this->m_Logger )
   {
-    item.second->set_level( spdloglevel );
+    this->m_Logger->set_level( this->m_LogLevel );
   }
 }
 
@@ -74,21 +84,43 @@ void
 LoggerImpl
 ::SetPattern( const std::string& pattern )
 {
-  spdlog::set_pattern( pattern );
+  this->m_Pattern = pattern;
+  if( this->m_Logger )
+  {
+    this->m_Logger->set_pattern( this->m_Pattern );
+  }
+}
+
+void
+LoggerImpl
+::SetContext( const std::string& context )
+{
+  // The name of an spdlog logger is fixed at construction
+  this->m_Context = context;
+  this->CreateLogger();
+}
+
+const std::string&
+LoggerImpl
+::GetContext( void ) const
+{
+  return this->m_Context;
 }
 
 void
 LoggerImpl
 ::SetSyncMode()
 {
-  spdlog::set_sync_mode();
+  this->m_IsAsync = false;
+  this->CreateLogger();
 }
 
 void
 LoggerImpl
 ::SetAsyncMode()
 {
-  spdlog::set_async_mode(this->m_AsyncQueueSize, this->m_AsyncQueueOverflowPolicy);
+  this->m_IsAsync = true;
+  this->CreateLogger();
 }
 
 void
@@ -116,9 +148,14 @@ void
 LoggerImpl
 ::AsyncQueueFlush( void )
 {
-  for( const auto& identifierAndLogger : this->m_Loggers )
+  if( this->m_Logger )
+  {
+    this->m_Logger->flush();
+  }
+
+  for( const auto& identifierAndBinarySink : this->m_BinarySinks )
   {
-    identifierAndLogger.second->flush();
+    identifierAndBinarySink.second->Flush();
   }
 }
 
@@ -126,40 +163,135 @@ void
 LoggerImpl
 ::AddStream( const std::string& identifier, std::ostream& stream, const bool& forceFlush )
 {
-  auto sink = std::make_shared< spdlog::sinks::ostream_sink< std::mutex > >(stream, forceFlush);
-  auto logger = spdlog::details::registry::instance().create(identifier, sink );
-  this->m_Loggers.insert( std::make_pair( identifier, logger ) );
+  this->AddSink( identifier, std::make_shared< spdlog::sinks::ostream_sink< std::mutex > >( stream, forceFlush ) );
 }
 
 void
 LoggerImpl
-::RemoveStream( const std::string& name )
+::AddRotatingFileBySize( const std::string& identifier, const std::string& filename, const size_t& maxFileSize, const size_t& maxNumberOfFiles )
 {
-  spdlog::drop( name );
-  this->m_Loggers.erase( name );
+  this->AddSink( identifier, std::make_shared< spdlog::sinks::rotating_file_sink_mt >( filename, maxFileSize, maxNumberOfFiles ) );
 }
 
 void
 LoggerImpl
-::RemoveAllStreams( void )
+::AddRotatingFileByTime( const std::string& identifier, const std::string& filename, const int& hour, const int& minute )
 {
-  for( const auto& identifierAndLogger : this->m_Loggers )
+  this->AddSink( identifier, std::make_shared< spdlog::sinks::daily_file_sink_mt >( filename, hour, minute ) );
+}
+
+void
+LoggerImpl
+::AddBinaryFile( const std::string& identifier, const std::string& filename )
+{
+  if( this->m_Sinks.count( identifier ) > 0 || this->m_BinarySinks.count( identifier ) > 0 )
+  {
+    itkGenericExceptionMacro( "Logger already has a stream with identifier '" << identifier << "'." );
+  }
+
+  // The async queue settings apply to the ring buffer of each logging thread
+  this->m_BinarySinks.emplace( identifier, std::make_shared< BinaryLogSink >( filename, this->m_AsyncQueueSize,
+    this->m_AsyncQueueOverflowPolicy == AsyncQueueOverflowPolicyType::discard_log_msg ) );
+}
+
+void
+LoggerImpl
+::AddSink( const std::string& identifier, const spdlog::sink_ptr& sink )
+{
+  if( this->m_Sinks.count( identifier ) > 0 || this->m_BinarySinks.count( identifier ) > 0 )
   {
-    spdlog::drop( identifierAndLogger.first );
+    itkGenericExceptionMacro( "Logger already has a stream with identifier '" << identifier << "'." );
   }
 
-  this->m_Loggers.clear();
+  this->m_Sinks.emplace( identifier, sink );
+  this->CreateLogger();
+}
+
+void
+LoggerImpl
+::RemoveStream( const std::string& identifier )
+{
+  this->m_BinarySinks.erase( identifier );
+  this->m_Sinks.erase( identifier );
+  this->CreateLogger();
+}
+
+void
+LoggerImpl
+::RemoveAllStreams( void )
+{
+  this->m_BinarySinks.clear();
+  this->m_Sinks.clear();
+  this->CreateLogger();
 }
 
 void
 LoggerImpl
 ::Log( const LogLevel& level, const std::string& message )
 {
-  auto spdLogLevel = this->ToSpdLogLevel( level );
-  for( const auto& identifierAndLogger : this->m_Loggers )
+  if( !this->ShouldLog( level ) )
+  {
+    return;
+  }
+
+  // The message is an argument rather than the format string, so binary files do not store every message as a format string
+  for( const auto& identifierAndBinarySink : this->m_BinarySinks )
+  {
+    identifierAndBinarySink.second->Write( level, this->m_Context, "{0}", message );
+  }
+
+  this->LogFormatted( this->ToSpdLogLevel( level ), message.c_str() );
+}
+
+bool
+LoggerImpl
+::ShouldLog( const LogLevel& level ) const
+{
+  return ( this->m_Logger || !this->m_BinarySinks.empty() ) && ToSpdLogLevel( level ) >= this->m_LogLevel;
+}
+
+void
+LoggerImpl
+::LogFormatted( const spdlog::level::level_enum& level, const char* message )
+{
+  if( this->m_Logger )
+  {
+    this->m_Logger->log( level, message );
+  }
+}
+
+void
+LoggerImpl
+::CreateLogger( void )
+{
+  // Messages queued by the previous logger are written before its streams may go away
+  if( this->m_Logger )
+  {
+    this->m_Logger->flush();
+    this->m_Logger = nullptr;
+  }
+
+  if( this->m_Sinks.empty() )
+  {
+    return;
+  }
+
+  std::vector< spdlog::sink_ptr > sinks;
+  for( const auto& identifierAndSink : this->m_Sinks )
+  {
+    sinks.push_back( identifierAndSink.second );
+  }
+
+  if( this->m_IsAsync )
+  {
+    this->m_Logger = std::make_shared< spdlog::async_logger >( this->m_Context, sinks.begin(), sinks.end(), this->m_AsyncQueueSize, this->m_AsyncQueueOverflowPolicy );
+  }
+  else
   {
-    identifierAndLogger.second->log( spdLogLevel, message.c_str() );
+    this->m_Logger = std::make_shared< spdlog::logger >( this->m_Context, sinks.begin(), sinks.end() );
   }
+  this->m_Logger->set_level( this->m_LogLevel );
+  this->m_Logger->set_pattern( this->m_Pattern );
 }
 
 } // namespace
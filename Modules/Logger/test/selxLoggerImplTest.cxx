@@ -21,8 +21,23 @@
 
 #include "gtest/gtest.h"
 
+#include <fstream>
+#include <thread>
+
 using namespace selx;
 
+// Counts how often it is formatted into a log message
+struct FormatCounter
+{
+  mutable int count = 0;
+};
+
+std::ostream& operator<<( std::ostream& out, const FormatCounter& counter )
+{
+  ++counter.count;
+  return out << "counted";
+}
+
 TEST( LoggerImplTest, Initialization )
 {
   LoggerImpl logger = LoggerImpl();
@@ -49,9 +64,158 @@ TEST( LoggerImplTest, Console )
 }
 
 
+ TEST( LoggerImplTest, FormatOnce )
+ {
+   LoggerImpl logger = LoggerImpl();
+   std::ostringstream stream0, stream1;
+   logger.AddStream( "FormatOnce0", stream0 );
+   logger.AddStream( "FormatOnce1", stream1 );
+   logger.SetLogLevel( LogLevel::INF );
+   logger.SetPattern( "%v" );
+
+   FormatCounter counter;
+   std::vector< std::string > names = { "a", "b" };
+   EXPECT_FALSE( logger.ShouldLog( LogLevel::DBG ) );
+   logger.Log( LogLevel::DBG, "{0} {1}", counter, logger << names );
+   EXPECT_EQ( 0, counter.count );
+   EXPECT_TRUE( stream0.str().empty() );
+
+   EXPECT_TRUE( logger.ShouldLog( LogLevel::INF ) );
+   logger.Log( LogLevel::INF, "{0} {1}", counter, logger << names );
+   EXPECT_EQ( 1, counter.count );
+   EXPECT_EQ( "counted [a, b, \b\b]", stream0.str().substr( 0, stream0.str().find( '\n' ) ) );
+   EXPECT_EQ( stream0.str(), stream1.str() );
+ }
+
+ TEST( LoggerImplTest, IndependentInstances )
+ {
+   std::ostringstream stream0, stream1;
+   LoggerImpl logger0 = LoggerImpl();
+   LoggerImpl logger1 = LoggerImpl();
+
+   // Identifiers are per instance
+   logger0.AddStream( "stream", stream0 );
+   logger1.AddStream( "stream", stream1 );
+   EXPECT_THROW( logger0.AddStream( "stream", stream1 ), itk::ExceptionObject );
+
+   logger0.SetLogLevel( LogLevel::DBG );
+   logger0.SetPattern( "[%n] %v" );
+   logger0.SetContext( "job 0" );
+   EXPECT_EQ( "job 0", logger0.GetContext() );
+   EXPECT_FALSE( logger1.ShouldLog( LogLevel::DBG ) );
+
+   logger0.Log( LogLevel::DBG, "{0}", "message" );
+   logger1.Log( LogLevel::DBG, "{0}", "message" );
+   EXPECT_EQ( "[job 0] message", stream0.str().substr( 0, stream0.str().find( '\n' ) ) );
+   EXPECT_TRUE( stream1.str().empty() );
+
+   logger1.SetAsyncMode();
+   logger1.Log( LogLevel::INF, "{0}", "message" );
+   // Flushing only waits until the queue is empty, switching back joins the thread that writes to the stream
+   logger1.SetSyncMode();
+   EXPECT_NE( std::string::npos, stream1.str().find( "message" ) );
+ }
+
+ TEST( LoggerImplTest, BinaryFile )
+ {
+   const std::string filename = "LoggerImplTestBinaryFile.selxlog";
+   {
+     LoggerImpl logger = LoggerImpl();
+     logger.SetContext( "job 0" );
+     logger.SetAsyncQueueSize( 256 ); // Small ring buffers, so threads wrap around and wait for the background thread
+     logger.AddBinaryFile( "binary", filename );
+     EXPECT_FALSE( logger.ShouldLog( LogLevel::DBG ) );
+
+     std::vector< std::string > names = { "a", "b" };
+     logger.Log( LogLevel::WRN, "Component {0} has {1:d} inputs, {2:.1f} {3} {4}", "Transform", 2, 0.25, logger << names, true );
+     logger.Log( LogLevel::INF, "Plain {message}" );
+
+     std::vector< std::thread > threads;
+     for( int thread = 0; thread < 4; ++thread )
+     {
+       threads.emplace_back( [ &logger, thread ]() {
+         for( int i = 0; i < 100; ++i )
+         {
+           logger.Log( LogLevel::INF, "Thread {0} record {1}", thread, i );
+         }
+       } );
+     }
+     for( auto& thread : threads )
+     {
+       thread.join();
+     }
+     logger.AsyncQueueFlush();
+   }
+
+   std::ifstream in( filename, std::ios::binary );
+   std::ostringstream text;
+   DecodeBinaryLog( in, text, false );
+   std::istringstream lines( text.str() );
+   std::string line;
+   size_t numberOfLines = 0;
+   while( std::getline( lines, line ) )
+   {
+     EXPECT_NE( std::string::npos, line.find( "[job 0]" ) );
+     ++numberOfLines;
+   }
+   EXPECT_EQ( 402, numberOfLines );
+   EXPECT_NE( std::string::npos, text.str().find( "[warning] Component Transform has 2 inputs, 0.2 [a, b, \b\b] true\n" ) );
+   EXPECT_NE( std::string::npos, text.str().find( "[info] Plain {message}\n" ) );
+   EXPECT_NE( std::string::npos, text.str().find( "Thread 3 record 99\n" ) );
+
+   in.clear();
+   in.seekg( 0 );
+   std::ostringstream json;
+   DecodeBinaryLog( in, json, true );
+   EXPECT_NE( std::string::npos, json.str().find( "\"context\": \"job 0\", \"level\": \"warning\", \"format\": \"Component {0} has {1:d} inputs, {2:.1f} {3} {4}\", "
+     "\"arguments\": [\"Transform\", 2, 0.25, \"[a, b, \\u0008\\u0008]\", true]" ) );
+
+   in.close();
+   std::remove( filename.c_str() );
+ }
+
+ TEST( LoggerImplTest, BinaryFileShortLivedThreads )
+ {
+   const std::string filename = "LoggerImplTestBinaryFileShortLivedThreads.selxlog";
+   {
+     BinaryLogSink sink( filename, 256, false );
+     for( int round = 0; round < 50; ++round )
+     {
+       std::vector< std::thread > threads;
+       for( int thread = 0; thread < 4; ++thread )
+       {
+         threads.emplace_back( [ &sink, round, thread ]() {
+           sink.Write( LogLevel::INF, "job 0", "Round {0} thread {1}", round, thread );
+         } );
+       }
+       for( auto& thread : threads )
+       {
+         thread.join();
+       }
+
+       // The exited threads orphaned their rings, which are freed once drained
+       sink.Flush();
+       EXPECT_EQ( 0, sink.GetNumberOfRingBuffers() );
+     }
+
+     sink.Write( LogLevel::INF, "job 0", "Main thread" );
+     sink.Flush();
+     EXPECT_EQ( 1, sink.GetNumberOfRingBuffers() );
+   }
+
+   std::ifstream in( filename, std::ios::binary );
+   std::ostringstream text;
+   DecodeBinaryLog( in, text, false );
+   EXPECT_NE( std::string::npos, text.str().find( "Round 49 thread 3\n" ) );
+   EXPECT_NE( std::string::npos, text.str().find( "Main thread\n" ) );
+
+   in.close();
+   std::remove( filename.c_str() );
+ }
+
  TEST( LoggerImplTest, MemoryManagement )
  {
-   // This will fail with "logger with name 'cout' already exists" if logger above is not properly destroyed
+   // Stream identifiers are per instance, so this may reuse the identifier of the logger above
    LoggerImpl logger = LoggerImpl();
    logger.AddStream( "cout", std::cout );
  }